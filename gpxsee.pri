@@ -0,0 +1,517 @@
+# Application sources, shared with the benchmarks/tests (tests/tests.pro)
+
+QT += core \
+    gui \
+    gui-private \
+    network \
+    sql \
+    concurrent \
+    widgets \
+    printsupport \
+    positioning \
+    svg \
+    serialport
+greaterThan(QT_MAJOR_VERSION, 5) {
+    QT += openglwidgets
+}
+
+CONFIG += object_parallel_to_source
+INCLUDEPATH += $$PWD/src
+HEADERS += $$PWD/src/common/config.h \
+    $$PWD/src/common/garmin.h \
+    $$PWD/src/common/coordinates.h \
+    $$PWD/src/common/hash.h \
+    $$PWD/src/common/range.h \
+    $$PWD/src/common/rectc.h \
+    $$PWD/src/common/textcodec.h \
+    $$PWD/src/common/treenode.h \
+    $$PWD/src/common/wgs84.h \
+    $$PWD/src/common/util.h \
+    $$PWD/src/common/rtree.h \
+    $$PWD/src/common/packedrtree.h \
+    $$PWD/src/common/kv.h \
+    $$PWD/src/common/greatcircle.h \
+    $$PWD/src/common/haversine.h \
+    $$PWD/src/common/programpaths.h \
+    $$PWD/src/common/tifffile.h \
+    $$PWD/src/common/polygon.h \
+    $$PWD/src/common/color.h \
+    $$PWD/src/common/csv.h \
+    $$PWD/src/common/trace.h \
+    $$PWD/src/GUI/crosshairitem.h \
+    $$PWD/src/GUI/motioninfoitem.h \
+    $$PWD/src/GUI/pluginparameters.h \
+    $$PWD/src/GUI/authenticationwidget.h \
+    $$PWD/src/GUI/axislabelitem.h \
+    $$PWD/src/GUI/dirselectwidget.h \
+    $$PWD/src/GUI/flowlayout.h \
+    $$PWD/src/GUI/graphicsscene.h \
+    $$PWD/src/GUI/infolabel.h \
+    $$PWD/src/GUI/mapaction.h \
+    $$PWD/src/GUI/mapitem.h \
+    $$PWD/src/GUI/marginswidget.h \
+    $$PWD/src/GUI/markerinfoitem.h \
+    $$PWD/src/GUI/planeitem.h \
+    $$PWD/src/GUI/poiaction.h \
+    $$PWD/src/GUI/popup.h \
+    $$PWD/src/GUI/thumbnail.h \
+    $$PWD/src/GUI/app.h \
+    $$PWD/src/GUI/batchrender.h \
+    $$PWD/src/GUI/icons.h \
+    $$PWD/src/GUI/gui.h \
+    $$PWD/src/GUI/axisitem.h \
+    $$PWD/src/GUI/keys.h \
+    $$PWD/src/GUI/slideritem.h \
+    $$PWD/src/GUI/markeritem.h \
+    $$PWD/src/GUI/infoitem.h \
+    $$PWD/src/GUI/elevationgraph.h \
+    $$PWD/src/GUI/speedgraph.h \
+    $$PWD/src/GUI/sliderinfoitem.h \
+    $$PWD/src/GUI/filebrowser.h \
+    $$PWD/src/GUI/units.h \
+    $$PWD/src/GUI/scaleitem.h \
+    $$PWD/src/GUI/graphview.h \
+    $$PWD/src/GUI/waypointitem.h \
+    $$PWD/src/GUI/palette.h \
+    $$PWD/src/GUI/heartrategraph.h \
+    $$PWD/src/GUI/trackinfo.h \
+    $$PWD/src/GUI/fileselectwidget.h \
+    $$PWD/src/GUI/temperaturegraph.h \
+    $$PWD/src/GUI/graphtab.h \
+    $$PWD/src/GUI/trackitem.h \
+    $$PWD/src/GUI/tooltip.h \
+    $$PWD/src/GUI/routeitem.h \
+    $$PWD/src/GUI/graphitem.h \
+    $$PWD/src/GUI/graphsummary.h \
+    $$PWD/src/GUI/heatmapitem.h \
+    $$PWD/src/GUI/heatmapjob.h \
+    $$PWD/src/GUI/pathitem.h \
+    $$PWD/src/GUI/griditem.h \
+    $$PWD/src/GUI/format.h \
+    $$PWD/src/GUI/cadencegraph.h \
+    $$PWD/src/GUI/powergraph.h \
+    $$PWD/src/GUI/gearratiograph.h \
+    $$PWD/src/GUI/optionsdialog.h \
+    $$PWD/src/GUI/colorbox.h \
+    $$PWD/src/GUI/stylecombobox.h \
+    $$PWD/src/GUI/timetype.h \
+    $$PWD/src/GUI/percentslider.h \
+    $$PWD/src/GUI/elevationgraphitem.h \
+    $$PWD/src/GUI/speedgraphitem.h \
+    $$PWD/src/GUI/heartrategraphitem.h \
+    $$PWD/src/GUI/temperaturegraphitem.h \
+    $$PWD/src/GUI/cadencegraphitem.h \
+    $$PWD/src/GUI/powergraphitem.h \
+    $$PWD/src/GUI/gearratiographitem.h \
+    $$PWD/src/GUI/oddspinbox.h \
+    $$PWD/src/GUI/settings.h \
+    $$PWD/src/GUI/searchpointer.h \
+    $$PWD/src/GUI/mapview.h \
+    $$PWD/src/GUI/font.h \
+    $$PWD/src/GUI/areaitem.h \
+    $$PWD/src/GUI/coordinatesitem.h \
+    $$PWD/src/GUI/projectioncombobox.h \
+    $$PWD/src/GUI/pathtickitem.h \
+    $$PWD/src/GUI/pdfexportdialog.h \
+    $$PWD/src/GUI/pngexportdialog.h \
+    $$PWD/src/GUI/pngwriter.h \
+    $$PWD/src/GUI/seeddialog.h \
+    $$PWD/src/GUI/timezoneinfo.h \
+    $$PWD/src/GUI/passwordedit.h \
+    $$PWD/src/data/gpsdumpparser.h \
+    $$PWD/src/data/style.h \
+    $$PWD/src/data/twonavparser.h \
+    $$PWD/src/data/txtparser.h \
+    $$PWD/src/map/IMG/light.h \
+    $$PWD/src/map/downloader.h \
+    $$PWD/src/map/demloader.h \
+    $$PWD/src/map/ENC/attributes.h \
+    $$PWD/src/map/ENC/mapdata.h \
+    $$PWD/src/map/ENC/atlasdata.h \
+    $$PWD/src/map/ENC/objects.h \
+    $$PWD/src/map/ENC/rastertile.h \
+    $$PWD/src/map/ENC/style.h \
+    $$PWD/src/map/IMG/demfile.h \
+    $$PWD/src/map/IMG/demtile.h \
+    $$PWD/src/map/IMG/demtree.h \
+    $$PWD/src/map/IMG/jls.h \
+    $$PWD/src/map/IMG/section.h \
+    $$PWD/src/map/IMG/zoom.h \
+    $$PWD/src/map/conversion.h \
+    $$PWD/src/map/encatlas.h \
+    $$PWD/src/map/encjob.h \
+    $$PWD/src/map/encmap.h \
+    $$PWD/src/map/ENC/iso8211.h \
+    $$PWD/src/map/filter.h \
+    $$PWD/src/map/gemfmap.h \
+    $$PWD/src/map/gmifile.h \
+    $$PWD/src/map/metatype.h \
+    $$PWD/src/map/oruxmap.h \
+    $$PWD/src/map/osmdroidmap.h \
+    $$PWD/src/map/proj/polyconic.h \
+    $$PWD/src/map/proj/webmercator.h \
+    $$PWD/src/map/proj/transversemercator.h \
+    $$PWD/src/map/proj/latlon.h \
+    $$PWD/src/map/proj/lambertconic.h \
+    $$PWD/src/map/proj/lambertazimuthal.h \
+    $$PWD/src/map/proj/albersequal.h \
+    $$PWD/src/map/proj/mercator.h \
+    $$PWD/src/map/proj/krovak.h \
+    $$PWD/src/map/proj/polarstereographic.h \
+    $$PWD/src/map/proj/obliquestereographic.h \
+    $$PWD/src/map/bitmapline.h \
+    $$PWD/src/map/IMG/bitstream.h \
+    $$PWD/src/map/IMG/deltastream.h \
+    $$PWD/src/map/IMG/gmapdata.h \
+    $$PWD/src/map/IMG/huffmanbuffer.h \
+    $$PWD/src/map/IMG/huffmanstream.h \
+    $$PWD/src/map/IMG/huffmantable.h \
+    $$PWD/src/map/IMG/huffmantext.h \
+    $$PWD/src/map/IMG/nodfile.h \
+    $$PWD/src/map/IMG/mapdata.h \
+    $$PWD/src/map/IMG/raster.h \
+    $$PWD/src/map/IMG/rastertile.h \
+    $$PWD/src/map/IMG/shield.h \
+    $$PWD/src/map/IMG/imgdata.h \
+    $$PWD/src/map/IMG/subfile.h \
+    $$PWD/src/map/IMG/trefile.h \
+    $$PWD/src/map/IMG/rgnfile.h \
+    $$PWD/src/map/IMG/lblfile.h \
+    $$PWD/src/map/IMG/vectortile.h \
+    $$PWD/src/map/IMG/subdiv.h \
+    $$PWD/src/map/IMG/style.h \
+    $$PWD/src/map/IMG/netfile.h \
+    $$PWD/src/map/IMG/label.h \
+    $$PWD/src/map/mapsforge/style.h \
+    $$PWD/src/map/mapsforge/mapdata.h \
+    $$PWD/src/map/mapsforge/rastertile.h \
+    $$PWD/src/map/mapsforge/subfile.h \
+    $$PWD/src/map/qctmap.h \
+    $$PWD/src/map/textpathitem.h \
+    $$PWD/src/map/textpointitem.h \
+    $$PWD/src/map/prjfile.h \
+    $$PWD/src/map/bsbmap.h \
+    $$PWD/src/map/invalidmap.h \
+    $$PWD/src/map/kmzmap.h \
+    $$PWD/src/map/projection.h \
+    $$PWD/src/map/ellipsoid.h \
+    $$PWD/src/map/datum.h \
+    $$PWD/src/map/sqlitemap.h \
+    $$PWD/src/map/utm.h \
+    $$PWD/src/map/map.h \
+    $$PWD/src/map/dem.h \
+    $$PWD/src/map/cachebudget.h \
+    $$PWD/src/map/prefetch.h \
+    $$PWD/src/map/renderjob.h \
+    $$PWD/src/map/maplist.h \
+    $$PWD/src/map/mapcatalog.h \
+    $$PWD/src/map/catalogmap.h \
+    $$PWD/src/map/onlinemap.h \
+    $$PWD/src/map/tile.h \
+    $$PWD/src/map/emptymap.h \
+    $$PWD/src/map/ozimap.h \
+    $$PWD/src/map/tar.h \
+    $$PWD/src/map/ozf.h \
+    $$PWD/src/map/atlas.h \
+    $$PWD/src/map/matrix.h \
+    $$PWD/src/map/geotiff.h \
+    $$PWD/src/map/pcs.h \
+    $$PWD/src/map/transform.h \
+    $$PWD/src/map/mapfile.h \
+    $$PWD/src/map/gcs.h \
+    $$PWD/src/map/angularunits.h \
+    $$PWD/src/map/primemeridian.h \
+    $$PWD/src/map/linearunits.h \
+    $$PWD/src/map/ct.h \
+    $$PWD/src/map/mapsource.h \
+    $$PWD/src/map/tileloader.h \
+    $$PWD/src/map/tilestore.h \
+    $$PWD/src/map/tileseeder.h \
+    $$PWD/src/map/wldfile.h \
+    $$PWD/src/map/wmtsmap.h \
+    $$PWD/src/map/wmts.h \
+    $$PWD/src/map/wmsmap.h \
+    $$PWD/src/map/wms.h \
+    $$PWD/src/map/crs.h \
+    $$PWD/src/map/coordinatesystem.h \
+    $$PWD/src/map/pointd.h \
+    $$PWD/src/map/rectd.h \
+    $$PWD/src/map/geocentric.h \
+    $$PWD/src/map/jnxmap.h \
+    $$PWD/src/map/geotiffmap.h \
+    $$PWD/src/map/image.h \
+    $$PWD/src/map/mbtilesmap.h \
+    $$PWD/src/map/osm.h \
+    $$PWD/src/map/rmap.h \
+    $$PWD/src/map/calibrationpoint.h \
+    $$PWD/src/map/textitem.h \
+    $$PWD/src/map/aqmmap.h \
+    $$PWD/src/map/mapsforgemap.h \
+    $$PWD/src/map/worldfilemap.h \
+    $$PWD/src/map/imgmap.h \
+    $$PWD/src/map/hillshading.h \
+    $$PWD/src/data/itnparser.h \
+    $$PWD/src/data/link.h \
+    $$PWD/src/data/onmoveparsers.h \
+    $$PWD/src/data/ov2parser.h \
+    $$PWD/src/data/graph.h \
+    $$PWD/src/data/poi.h \
+    $$PWD/src/data/poiindex.h \
+    $$PWD/src/data/corridor.h \
+    $$PWD/src/data/waypoint.h \
+    $$PWD/src/data/track.h \
+    $$PWD/src/data/route.h \
+    $$PWD/src/data/trackpoint.h \
+    $$PWD/src/data/data.h \
+    $$PWD/src/data/parser.h \
+    $$PWD/src/data/trackdata.h \
+    $$PWD/src/data/routedata.h \
+    $$PWD/src/data/path.h \
+    $$PWD/src/data/gpxparser.h \
+    $$PWD/src/data/tcxparser.h \
+    $$PWD/src/data/csvparser.h \
+    $$PWD/src/data/kmlparser.h \
+    $$PWD/src/data/fitparser.h \
+    $$PWD/src/data/igcparser.h \
+    $$PWD/src/data/nmeaparser.h \
+    $$PWD/src/data/oziparsers.h \
+    $$PWD/src/data/locparser.h \
+    $$PWD/src/data/slfparser.h \
+    $$PWD/src/data/area.h \
+    $$PWD/src/data/exifparser.h \
+    $$PWD/src/data/cupparser.h \
+    $$PWD/src/data/gpiparser.h \
+    $$PWD/src/data/address.h \
+    $$PWD/src/data/smlparser.h \
+    $$PWD/src/data/geojsonparser.h
+
+SOURCES += $$PWD/src/common/coordinates.cpp \
+    $$PWD/src/common/rectc.cpp \
+    $$PWD/src/common/range.cpp \
+    $$PWD/src/common/textcodec.cpp \
+    $$PWD/src/common/util.cpp \
+    $$PWD/src/common/greatcircle.cpp \
+    $$PWD/src/common/haversine.cpp \
+    $$PWD/src/common/programpaths.cpp \
+    $$PWD/src/common/tifffile.cpp \
+    $$PWD/src/common/csv.cpp \
+    $$PWD/src/common/trace.cpp \
+    $$PWD/src/GUI/crosshairitem.cpp \
+    $$PWD/src/GUI/motioninfoitem.cpp \
+    $$PWD/src/GUI/pluginparameters.cpp \
+    $$PWD/src/GUI/settings.cpp \
+    $$PWD/src/GUI/authenticationwidget.cpp \
+    $$PWD/src/GUI/axislabelitem.cpp \
+    $$PWD/src/GUI/dirselectwidget.cpp \
+    $$PWD/src/GUI/flowlayout.cpp \
+    $$PWD/src/GUI/infolabel.cpp \
+    $$PWD/src/GUI/mapitem.cpp \
+    $$PWD/src/GUI/marginswidget.cpp \
+    $$PWD/src/GUI/markerinfoitem.cpp \
+    $$PWD/src/GUI/popup.cpp \
+    $$PWD/src/GUI/thumbnail.cpp \
+    $$PWD/src/GUI/app.cpp \
+    $$PWD/src/GUI/batchrender.cpp \
+    $$PWD/src/GUI/gui.cpp \
+    $$PWD/src/GUI/axisitem.cpp \
+    $$PWD/src/GUI/slideritem.cpp \
+    $$PWD/src/GUI/markeritem.cpp \
+    $$PWD/src/GUI/infoitem.cpp \
+    $$PWD/src/GUI/elevationgraph.cpp \
+    $$PWD/src/GUI/speedgraph.cpp \
+    $$PWD/src/GUI/sliderinfoitem.cpp \
+    $$PWD/src/GUI/filebrowser.cpp \
+    $$PWD/src/GUI/scaleitem.cpp \
+    $$PWD/src/GUI/graphview.cpp \
+    $$PWD/src/GUI/waypointitem.cpp \
+    $$PWD/src/GUI/palette.cpp \
+    $$PWD/src/GUI/heartrategraph.cpp \
+    $$PWD/src/GUI/trackinfo.cpp \
+    $$PWD/src/GUI/fileselectwidget.cpp \
+    $$PWD/src/GUI/temperaturegraph.cpp \
+    $$PWD/src/GUI/trackitem.cpp \
+    $$PWD/src/GUI/routeitem.cpp \
+    $$PWD/src/GUI/graphitem.cpp \
+    $$PWD/src/GUI/graphsummary.cpp \
+    $$PWD/src/GUI/heatmapitem.cpp \
+    $$PWD/src/GUI/pathitem.cpp \
+    $$PWD/src/GUI/griditem.cpp \
+    $$PWD/src/GUI/format.cpp \
+    $$PWD/src/GUI/cadencegraph.cpp \
+    $$PWD/src/GUI/powergraph.cpp \
+    $$PWD/src/GUI/gearratiograph.cpp \
+    $$PWD/src/GUI/optionsdialog.cpp \
+    $$PWD/src/GUI/colorbox.cpp \
+    $$PWD/src/GUI/stylecombobox.cpp \
+    $$PWD/src/GUI/oddspinbox.cpp \
+    $$PWD/src/GUI/percentslider.cpp \
+    $$PWD/src/GUI/elevationgraphitem.cpp \
+    $$PWD/src/GUI/speedgraphitem.cpp \
+    $$PWD/src/GUI/heartrategraphitem.cpp \
+    $$PWD/src/GUI/temperaturegraphitem.cpp \
+    $$PWD/src/GUI/cadencegraphitem.cpp \
+    $$PWD/src/GUI/powergraphitem.cpp \
+    $$PWD/src/GUI/gearratiographitem.cpp \
+    $$PWD/src/GUI/mapview.cpp \
+    $$PWD/src/GUI/areaitem.cpp \
+    $$PWD/src/GUI/coordinatesitem.cpp \
+    $$PWD/src/GUI/pathtickitem.cpp \
+    $$PWD/src/GUI/graphicsscene.cpp \
+    $$PWD/src/GUI/pdfexportdialog.cpp \
+    $$PWD/src/GUI/pngexportdialog.cpp \
+    $$PWD/src/GUI/pngwriter.cpp \
+    $$PWD/src/GUI/seeddialog.cpp \
+    $$PWD/src/GUI/projectioncombobox.cpp \
+    $$PWD/src/GUI/passwordedit.cpp \
+    $$PWD/src/data/txtparser.cpp \
+    $$PWD/src/map/downloader.cpp \
+    $$PWD/src/map/demloader.cpp \
+    $$PWD/src/map/ENC/atlasdata.cpp \
+    $$PWD/src/map/ENC/mapdata.cpp \
+    $$PWD/src/map/ENC/rastertile.cpp \
+    $$PWD/src/map/ENC/style.cpp \
+    $$PWD/src/map/IMG/demfile.cpp \
+    $$PWD/src/map/IMG/demtree.cpp \
+    $$PWD/src/map/IMG/jls.cpp \
+    $$PWD/src/map/conversion.cpp \
+    $$PWD/src/map/encatlas.cpp \
+    $$PWD/src/map/encmap.cpp \
+    $$PWD/src/map/ENC/iso8211.cpp \
+    $$PWD/src/map/filter.cpp \
+    $$PWD/src/map/gemfmap.cpp \
+    $$PWD/src/map/gmifile.cpp \
+    $$PWD/src/map/oruxmap.cpp \
+    $$PWD/src/map/osmdroidmap.cpp \
+    $$PWD/src/map/proj/polyconic.cpp \
+    $$PWD/src/map/proj/webmercator.cpp \
+    $$PWD/src/map/proj/transversemercator.cpp \
+    $$PWD/src/map/proj/lambertconic.cpp \
+    $$PWD/src/map/proj/albersequal.cpp \
+    $$PWD/src/map/proj/lambertazimuthal.cpp \
+    $$PWD/src/map/proj/mercator.cpp \
+    $$PWD/src/map/proj/krovak.cpp \
+    $$PWD/src/map/proj/polarstereographic.cpp \
+    $$PWD/src/map/proj/obliquestereographic.cpp \
+    $$PWD/src/map/bitmapline.cpp \
+    $$PWD/src/map/IMG/bitstream.cpp \
+    $$PWD/src/map/IMG/deltastream.cpp \
+    $$PWD/src/map/IMG/gmapdata.cpp \
+    $$PWD/src/map/IMG/huffmanbuffer.cpp \
+    $$PWD/src/map/IMG/huffmanstream.cpp \
+    $$PWD/src/map/IMG/huffmantable.cpp \
+    $$PWD/src/map/IMG/huffmantext.cpp \
+    $$PWD/src/map/IMG/nodfile.cpp \
+    $$PWD/src/map/IMG/mapdata.cpp \
+    $$PWD/src/map/IMG/rastertile.cpp \
+    $$PWD/src/map/IMG/imgdata.cpp \
+    $$PWD/src/map/IMG/subfile.cpp \
+    $$PWD/src/map/IMG/trefile.cpp \
+    $$PWD/src/map/IMG/rgnfile.cpp \
+    $$PWD/src/map/IMG/lblfile.cpp \
+    $$PWD/src/map/IMG/vectortile.cpp \
+    $$PWD/src/map/IMG/style.cpp \
+    $$PWD/src/map/IMG/netfile.cpp \
+    $$PWD/src/map/mapsforge/style.cpp \
+    $$PWD/src/map/mapsforge/mapdata.cpp \
+    $$PWD/src/map/mapsforge/rastertile.cpp \
+    $$PWD/src/map/mapsforge/subfile.cpp \
+    $$PWD/src/map/imgmap.cpp \
+    $$PWD/src/map/prjfile.cpp \
+    $$PWD/src/map/qctmap.cpp \
+    $$PWD/src/map/textpathitem.cpp \
+    $$PWD/src/map/textpointitem.cpp \
+    $$PWD/src/map/bsbmap.cpp \
+    $$PWD/src/map/kmzmap.cpp \
+    $$PWD/src/map/maplist.cpp \
+    $$PWD/src/map/mapcatalog.cpp \
+    $$PWD/src/map/catalogmap.cpp \
+    $$PWD/src/map/onlinemap.cpp \
+    $$PWD/src/map/emptymap.cpp \
+    $$PWD/src/map/ozimap.cpp \
+    $$PWD/src/map/sqlitemap.cpp \
+    $$PWD/src/map/tar.cpp \
+    $$PWD/src/map/atlas.cpp \
+    $$PWD/src/map/ozf.cpp \
+    $$PWD/src/map/matrix.cpp \
+    $$PWD/src/map/ellipsoid.cpp \
+    $$PWD/src/map/datum.cpp \
+    $$PWD/src/map/utm.cpp \
+    $$PWD/src/map/geotiff.cpp \
+    $$PWD/src/map/pcs.cpp \
+    $$PWD/src/map/transform.cpp \
+    $$PWD/src/map/mapfile.cpp \
+    $$PWD/src/map/projection.cpp \
+    $$PWD/src/map/gcs.cpp \
+    $$PWD/src/map/angularunits.cpp \
+    $$PWD/src/map/primemeridian.cpp \
+    $$PWD/src/map/linearunits.cpp \
+    $$PWD/src/map/mapsource.cpp \
+    $$PWD/src/map/tileloader.cpp \
+    $$PWD/src/map/tilestore.cpp \
+    $$PWD/src/map/tileseeder.cpp \
+    $$PWD/src/map/cachebudget.cpp \
+    $$PWD/src/map/prefetch.cpp \
+    $$PWD/src/map/renderjob.cpp \
+    $$PWD/src/map/wldfile.cpp \
+    $$PWD/src/map/wmtsmap.cpp \
+    $$PWD/src/map/wmts.cpp \
+    $$PWD/src/map/wmsmap.cpp \
+    $$PWD/src/map/wms.cpp \
+    $$PWD/src/map/crs.cpp \
+    $$PWD/src/map/coordinatesystem.cpp \
+    $$PWD/src/map/geocentric.cpp \
+    $$PWD/src/map/jnxmap.cpp \
+    $$PWD/src/map/map.cpp \
+    $$PWD/src/map/dem.cpp \
+    $$PWD/src/map/geotiffmap.cpp \
+    $$PWD/src/map/image.cpp \
+    $$PWD/src/map/mbtilesmap.cpp \
+    $$PWD/src/map/osm.cpp \
+    $$PWD/src/map/rectd.cpp \
+    $$PWD/src/map/rmap.cpp \
+    $$PWD/src/map/textitem.cpp \
+    $$PWD/src/map/aqmmap.cpp \
+    $$PWD/src/map/mapsforgemap.cpp \
+    $$PWD/src/map/worldfilemap.cpp \
+    $$PWD/src/map/hillshading.cpp \
+    $$PWD/src/data/gpsdumpparser.cpp \
+    $$PWD/src/data/twonavparser.cpp \
+    $$PWD/src/data/address.cpp \
+    $$PWD/src/data/itnparser.cpp \
+    $$PWD/src/data/onmoveparsers.cpp \
+    $$PWD/src/data/ov2parser.cpp \
+    $$PWD/src/data/waypoint.cpp \
+    $$PWD/src/data/data.cpp \
+    $$PWD/src/data/poi.cpp \
+    $$PWD/src/data/poiindex.cpp \
+    $$PWD/src/data/corridor.cpp \
+    $$PWD/src/data/track.cpp \
+    $$PWD/src/data/route.cpp \
+    $$PWD/src/data/path.cpp \
+    $$PWD/src/data/gpxparser.cpp \
+    $$PWD/src/data/tcxparser.cpp \
+    $$PWD/src/data/csvparser.cpp \
+    $$PWD/src/data/kmlparser.cpp \
+    $$PWD/src/data/fitparser.cpp \
+    $$PWD/src/data/igcparser.cpp \
+    $$PWD/src/data/nmeaparser.cpp \
+    $$PWD/src/data/oziparsers.cpp \
+    $$PWD/src/data/locparser.cpp \
+    $$PWD/src/data/slfparser.cpp \
+    $$PWD/src/data/exifparser.cpp \
+    $$PWD/src/data/cupparser.cpp \
+    $$PWD/src/data/gpiparser.cpp \
+    $$PWD/src/data/smlparser.cpp \
+    $$PWD/src/data/geojsonparser.cpp
+
+DEFINES += APP_VERSION=\\\"$$VERSION\\\"
+# Render instrumentation (qmake CONFIG+=trace), see src/common/trace.h
+trace {
+    DEFINES += ENABLE_TRACE
+}
+
+win32 {
+    CONFIG += no_batch
+    DEFINES += _USE_MATH_DEFINES \
+        NOGDI
+}
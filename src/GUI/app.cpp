@@ -13,6 +13,7 @@
 #endif // Q_OS_ANDROID
 #include "common/programpaths.h"
 #include "common/config.h"
+#include "common/trace.h"
 #include "map/downloader.h"
 #include "map/dem.h"
 #include "map/ellipsoid.h"
@@ -22,8 +23,25 @@
 #include "data/waypoint.h"
 #include "gui.h"
 #include "mapaction.h"
+#include "batchrender.h"
 #include "app.h"
 
+#ifdef ENABLE_TRACE
+/* Removes the option and its value from the arguments list */
+static QString option(QStringList &args, const QString &name)
+{
+	QString value;
+	int i = args.indexOf(name);
+
+	if (i > 0 && i + 1 < args.count()) {
+		value = args.at(i + 1);
+		args.removeAt(i + 1);
+		args.removeAt(i);
+	}
+
+	return value;
+}
+#endif // ENABLE_TRACE
 
 App::App(int &argc, char **argv) : QApplication(argc, argv)
 {
@@ -75,7 +93,7 @@ App::App(int &argc, char **argv) : QApplication(argc, argv)
 #endif // Q_OS_WIN32 || Q_OS_MAC
 	QIcon::setFallbackThemeName(APP_NAME);
 
-	_gui = new GUI();
+	_gui = BatchRender::isBatch(argc, argv) ? 0 : new GUI();
 
 #ifdef Q_OS_ANDROID
 	connect(this, &App::applicationStateChanged, this, &App::appStateChanged);
@@ -91,9 +109,29 @@ int App::run()
 {
 	MapAction *lastReady = 0;
 	QStringList args(arguments());
+#ifdef ENABLE_TRACE
+	QString trace(option(args, "--trace"));
+	QString summary(option(args, "--trace-summary"));
+	if (!(trace.isEmpty() && summary.isEmpty()))
+		Trace::start();
+#endif // ENABLE_TRACE
 	int silent = 0;
 	int showError = (args.count() - 1 > 1) ? 2 : 1;
 
+	if (!_gui) {
+		BatchRender batch(args);
+#ifdef ENABLE_TRACE
+		int ret = batch.run();
+		if (!trace.isEmpty())
+			Trace::save(trace);
+		if (!summary.isEmpty())
+			Trace::saveSummary(summary);
+		return ret;
+#else // ENABLE_TRACE
+		return batch.run();
+#endif // ENABLE_TRACE
+	}
+
 	_gui->show();
 
 	for (int i = 1; i < args.count(); i++) {
@@ -111,7 +149,16 @@ int App::run()
 	if (lastReady)
 		lastReady->trigger();
 
+#ifdef ENABLE_TRACE
+	int ret = exec();
+	if (!trace.isEmpty())
+		Trace::save(trace);
+	if (!summary.isEmpty())
+		Trace::saveSummary(summary);
+	return ret;
+#else // ENABLE_TRACE
 	return exec();
+#endif // ENABLE_TRACE
 }
 
 #ifdef Q_OS_ANDROID
@@ -145,7 +192,7 @@ bool App::event(QEvent *event)
 	int silent = 0;
 	int showError = 1;
 
-	if (event->type() == QEvent::FileOpen) {
+	if (_gui && event->type() == QEvent::FileOpen) {
 		QFileOpenEvent *e = static_cast<QFileOpenEvent *>(event);
 
 		if (!_gui->openFile(e->file(), false, silent)) {
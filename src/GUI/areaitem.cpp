@@ -24,7 +24,7 @@ ToolTip AreaItem::info(bool extended) const
 }
 
 AreaItem::AreaItem(const Area &area, Map *map, GraphicsItem *parent)
-  : PlaneItem(parent), _area(area)
+  : PlaneItem(parent), _area(area), _projected(false)
 {
 	_digitalZoom = 0;
 	_width = 2;
@@ -57,12 +57,25 @@ QPainterPath AreaItem::painterPath(Map *map, const Polygon &polygon)
 	return path;
 }
 
-void AreaItem::updatePainterPath(Map *map)
+/* Thread-safe part of setMap(), see PathItem::project() */
+void AreaItem::project(Map *map)
 {
-	_painterPath = QPainterPath();
+	_projectedPath = QPainterPath();
 
 	for (int i = 0; i < _area.polygons().size(); i++)
-		_painterPath.addPath(painterPath(map, _area.polygons().at(i)));
+		_projectedPath.addPath(painterPath(map, _area.polygons().at(i)));
+
+	_projected = true;
+}
+
+void AreaItem::updatePainterPath(Map *map)
+{
+	if (!_projected)
+		project(map);
+
+	_painterPath.swap(_projectedPath);
+	_projectedPath = QPainterPath();
+	_projected = false;
 }
 
 void AreaItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
@@ -17,6 +17,7 @@ public:
 	const Area &area() const {return _area;}
 
 	RectC bounds() const {return _area.boundingRect();}
+	void project(Map *map);
 	void setMap(Map *map);
 
 	void setColor(const QColor &color);
@@ -54,6 +55,8 @@ private:
 	QPen _pen;
 	QBrush _brush;
 	QPainterPath _painterPath;
+	QPainterPath _projectedPath;
+	bool _projected;
 };
 
 #endif // AREAITEM_H
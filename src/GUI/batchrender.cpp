@@ -0,0 +1,463 @@
+#include <cstdio>
+#include <cstring>
+#include <QApplication>
+#include <QThread>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QPainter>
+#include <QImage>
+#include <QMutex>
+#include <QSet>
+#include <QPixmapCache>
+#include <QSettings>
+#include <QtConcurrent>
+#include <private/qguiapplication_p.h>
+#include <qpa/qplatformintegration.h>
+#include "data/data.h"
+#include "data/poi.h"
+#include "map/maplist.h"
+#include "map/emptymap.h"
+#include "map/downloader.h"
+#include "map/tilestore.h"
+#include "map/cachebudget.h"
+#include "map/prefetch.h"
+#include "map/dem.h"
+#include "map/gcs.h"
+#include "settings.h"
+#include "palette.h"
+#include "mapview.h"
+#include "elevationgraph.h"
+#include "batchrender.h"
+
+#define DEFAULT_SIZE QSize(800, 600)
+/* Only one file can be parsed at a time, so one file waiting for the parser
+   is enough to keep it busy */
+#define LOAD_AHEAD   2
+
+struct Load
+{
+	Load() : data(0), time(0) {}
+
+	Data *data;
+	qint64 time;
+};
+
+struct Write
+{
+	Write() : load(0), render(0), graph(false) {}
+
+	QString file;
+	qint64 load, render;
+	QFuture<qint64> image, graphImage;
+	bool graph;
+};
+
+/* The data parsers are shared static objects */
+static QMutex parserLock;
+
+/* The parsers create pixmaps (waypoint icons), so the files can only be
+   loaded in the worker threads if the platform supports threaded pixmaps */
+static bool threadedLoad()
+{
+	return QGuiApplicationPrivate::platformIntegration()->hasCapability(
+	  QPlatformIntegration::ThreadedPixmaps);
+}
+
+static Load loadData(const QString &path)
+{
+	QMutexLocker locker(&parserLock);
+	QElapsedTimer timer;
+	Load load;
+
+	timer.start();
+	load.data = new Data(path);
+	load.time = timer.elapsed();
+
+	return load;
+}
+
+static qint64 saveImage(const QImage &img, const QString &path)
+{
+	QElapsedTimer timer;
+
+	timer.start();
+	return img.save(path, "png") ? timer.elapsed() : -1;
+}
+
+static bool penStyle(const QString &str, Qt::PenStyle &style)
+{
+	if (str == "solid")
+		style = Qt::SolidLine;
+	else if (str == "dash")
+		style = Qt::DashLine;
+	else if (str == "dot")
+		style = Qt::DotLine;
+	else if (str == "dashdot")
+		style = Qt::DashDotLine;
+	else if (str == "dashdotdot")
+		style = Qt::DashDotDotLine;
+	else
+		return false;
+
+	return true;
+}
+
+static bool imageSize(const QString &str, QSize &size)
+{
+	QStringList list(str.split('x'));
+	bool wok, hok;
+
+	if (list.size() != 2)
+		return false;
+	size = QSize(list.at(0).toInt(&wok), list.at(1).toInt(&hok));
+
+	return (wok && hok && !size.isEmpty());
+}
+
+/* Waits for the images of the file to be written and prints the file
+   timing. Returns false on write error. */
+static bool report(Write &w)
+{
+	qint64 time = w.image.result();
+	qint64 graphTime = w.graph ? w.graphImage.result() : 0;
+
+	if (time < 0 || graphTime < 0) {
+		fprintf(stderr, "%s: error writing image file\n",
+		  qUtf8Printable(w.file));
+		return false;
+	}
+
+	printf("%s\t%lld\t%lld\t%lld\n", qUtf8Printable(w.file),
+	  (long long)w.load, (long long)w.render, (long long)(time + graphTime));
+	fflush(stdout);
+
+	return true;
+}
+
+BatchRender::BatchRender(const QStringList &args)
+  : _size(DEFAULT_SIZE), _color(Qt::blue), _width(3), _style(Qt::SolidLine),
+  _graph(false), _jobs(QThread::idealThreadCount()), _map(0), _poi(0),
+  _mapView(0), _elevationGraph(0)
+{
+	_valid = parseArgs(args);
+}
+
+BatchRender::~BatchRender()
+{
+	_pool.waitForDone();
+
+	delete _mapView;
+	delete _elevationGraph;
+	delete _poi;
+	delete _map;
+}
+
+bool BatchRender::isBatch(int argc, char **argv)
+{
+	for (int i = 1; i < argc; i++)
+		if (!strcmp(argv[i], "--batch"))
+			return true;
+
+	return false;
+}
+
+void BatchRender::usage()
+{
+	fprintf(stderr, "Usage: gpxsee --batch DIR [options] FILE|DIR...\n\n"
+	  "  --batch DIR     Output directory of the PNG images\n"
+	  "  --map FILE      Map file or directory (the first map is used)\n"
+	  "  --size WxH      Image size (default 800x600)\n"
+	  "  --color COLOR   Path color (default blue)\n"
+	  "  --width PX      Path width (default 3)\n"
+	  "  --style STYLE   Path style: solid, dash, dot, dashdot, dashdotdot\n"
+	  "  --graph         Render the elevation graph as well\n"
+	  "  --jobs N        Number of worker threads\n\n"
+	  "The per-file timing (file, load, render, write time in ms) is written"
+	  " to the\nstandard output.\n");
+}
+
+bool BatchRender::parseArgs(QStringList args)
+{
+	args.removeFirst();
+
+	while (!args.isEmpty()) {
+		QString arg(args.takeFirst());
+
+		if (arg == "--graph")
+			_graph = true;
+		else if (arg.startsWith("--")) {
+			if (args.isEmpty())
+				return false;
+			QString val(args.takeFirst());
+			bool ok = true;
+
+			if (arg == "--batch")
+				_outDir = val;
+			else if (arg == "--map")
+				_mapPath = val;
+			else if (arg == "--size")
+				ok = imageSize(val, _size);
+			else if (arg == "--color") {
+				_color = QColor(val);
+				ok = _color.isValid();
+			} else if (arg == "--width") {
+				_width = val.toInt(&ok);
+				ok = ok && _width > 0;
+			} else if (arg == "--style")
+				ok = penStyle(val, _style);
+			else if (arg == "--jobs") {
+				_jobs = val.toInt(&ok);
+				ok = ok && _jobs > 0;
+			} else
+				ok = false;
+
+			if (!ok) {
+				fprintf(stderr, "%s: invalid argument\n", qUtf8Printable(arg));
+				return false;
+			}
+		} else
+			_inputs.append(arg);
+	}
+
+	return !(_outDir.isEmpty() || _inputs.isEmpty());
+}
+
+/* Directories are searched recursively for files with known data file
+   extensions. The output images keep the path relative to the input directory,
+   colliding output names get a numeric suffix. */
+void BatchRender::dataFiles(QStringList &files, QStringList &outputs) const
+{
+	QSet<QString> used;
+
+	for (int i = 0; i < _inputs.size(); i++) {
+		QFileInfo fi(_inputs.at(i));
+		QStringList list;
+		QDir base;
+
+		if (fi.isDir()) {
+			QDirIterator it(fi.absoluteFilePath(), Data::filter(), QDir::Files,
+			  QDirIterator::Subdirectories);
+			while (it.hasNext())
+				list.append(it.next());
+			list.sort();
+			base = QDir(fi.absoluteFilePath());
+		} else {
+			list.append(fi.absoluteFilePath());
+			base = fi.absoluteDir();
+		}
+
+		for (int j = 0; j < list.size(); j++) {
+			QFileInfo file(base.relativeFilePath(list.at(j)));
+			QString name(file.path() == "." ? file.completeBaseName()
+			  : file.path() + "/" + file.completeBaseName());
+			QString out(name);
+
+			for (int k = 2; used.contains(out); k++)
+				out = name + "-" + QString::number(k);
+			used.insert(out);
+
+			files.append(list.at(j));
+			outputs.append(out);
+		}
+	}
+}
+
+bool BatchRender::loadMap()
+{
+	if (_mapPath.isEmpty()) {
+		_map = new EmptyMap();
+		return true;
+	}
+
+	TreeNode<Map*> node(MapList::loadMaps(_mapPath, GCS::gcs(4326)));
+	QList<Map*> maps;
+	QList<TreeNode<Map*> > stack;
+
+	stack.append(node);
+	while (!stack.isEmpty()) {
+		TreeNode<Map*> n(stack.takeFirst());
+		maps.append(n.items());
+		stack.append(n.childs());
+	}
+
+	for (int i = 0; i < maps.size(); i++) {
+		Map *map = maps.at(i);
+
+		if (!_map && map->isValid())
+			_map = map;
+		else {
+			if (!map->isValid())
+				fprintf(stderr, "%s: %s\n", qUtf8Printable(map->path()),
+				  qUtf8Printable(map->errorString()));
+			delete map;
+		}
+	}
+	if (!_map) {
+		fprintf(stderr, "%s: no usable map found\n", qUtf8Printable(_mapPath));
+		return false;
+	}
+
+	/* Maps with a remote capabilities file (WMS/WMTS) are loaded
+	   asynchronously */
+	if (!_map->isReady()) {
+		QEventLoop loop;
+		QObject::connect(_map, &Map::mapLoaded, &loop, &QEventLoop::quit);
+		loop.exec();
+
+		if (!_map->isValid()) {
+			fprintf(stderr, "%s: %s\n", qUtf8Printable(_mapPath),
+			  qUtf8Printable(_map->errorString()));
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int BatchRender::run()
+{
+	if (!_valid) {
+		usage();
+		return 1;
+	}
+	if (!QDir().mkpath(_outDir)) {
+		fprintf(stderr, "%s: error creating output directory\n",
+		  qUtf8Printable(_outDir));
+		return 1;
+	}
+
+	QSettings settings(qApp->applicationName(), qApp->applicationName());
+	settings.beginGroup(SETTINGS_OPTIONS);
+	Downloader::setTimeout(Settings::connectionTimeout.read(settings).toInt());
+	QPixmapCache::setCacheLimit(Settings::pixmapCache.read(settings).toInt()
+	  * 1024);
+	DEM::setCacheSize(Settings::demCache.read(settings).toInt() * 1024);
+	CacheBudget::setLimit((qint64)Settings::dataCache.read(settings).toInt()
+	  * 1024 * 1024);
+	TileStore::setQuota(Settings::tileCache.read(settings).toInt() * 1024LL
+	  * 1024LL);
+	settings.endGroup();
+	Prefetch::setRing(0);
+
+	if (!loadMap())
+		return 1;
+
+	_pool.setMaxThreadCount(_jobs);
+	_poi = new POI();
+	_mapView = new MapView(_map, _poi);
+	_mapView->setPalette(Palette(_color));
+	_mapView->setTrackWidth(_width);
+	_mapView->setRouteWidth(_width);
+	_mapView->setTrackStyle(_style);
+	_mapView->setRouteStyle(_style);
+	_mapView->resize(_size);
+	_mapView->show();
+	if (_graph) {
+		_elevationGraph = new ElevationGraph();
+		_elevationGraph->showTracks(true);
+		_elevationGraph->showRoutes(true);
+		_elevationGraph->setGraphWidth(_width);
+		_elevationGraph->setPalette(Palette(_color));
+	}
+
+	QStringList files, outputs;
+	QList<QFuture<Load> > loads;
+	QList<Write> writes;
+	QElapsedTimer total;
+	int next = 0, errors = 0;
+	bool threaded = threadedLoad();
+
+	dataFiles(files, outputs);
+
+	total.start();
+	printf("file\tload\trender\twrite\n");
+
+	for (int i = 0; i < files.size(); i++) {
+		Load load;
+		if (threaded) {
+			while (loads.size() < LOAD_AHEAD && next < files.size())
+				loads.append(QtConcurrent::run(&_pool, loadData,
+				  files.at(next++)));
+			load = loads.takeFirst().result();
+		} else
+			load = loadData(files.at(i));
+
+		if (!load.data->isValid()) {
+			fprintf(stderr, "%s: %s\n", qUtf8Printable(files.at(i)),
+			  qUtf8Printable(load.data->errorString()));
+			delete load.data;
+			errors++;
+			continue;
+		}
+
+		QElapsedTimer timer;
+		timer.start();
+
+		QImage img(_size, QImage::Format_ARGB32_Premultiplied);
+		img.fill(Qt::white);
+		QPainter p(&img);
+		p.setRenderHint(QPainter::Antialiasing);
+		_mapView->clear();
+		_mapView->loadData(*load.data);
+		_mapView->plot(&p, QRectF(QPointF(0, 0), QSizeF(_size)), 1.0,
+		  MapView::Expand);
+		p.end();
+
+		QString base(_outDir + "/" + outputs.at(i));
+		QFileInfo fi(base);
+		Write w;
+
+		if (!QDir().mkpath(fi.absolutePath())) {
+			fprintf(stderr, "%s: error creating output directory\n",
+			  qUtf8Printable(fi.absolutePath()));
+			delete load.data;
+			errors++;
+			continue;
+		}
+
+		if (_elevationGraph) {
+			_elevationGraph->clear();
+			_elevationGraph->loadData(*load.data, _map);
+			if (!_elevationGraph->isEmpty()) {
+				QImage gimg(_size.width(), _size.height() / 3,
+				  QImage::Format_ARGB32_Premultiplied);
+				gimg.fill(Qt::white);
+				QPainter gp(&gimg);
+				gp.setRenderHint(QPainter::Antialiasing);
+				_elevationGraph->plot(&gp, QRectF(QPointF(0, 0),
+				  QSizeF(gimg.size())), 1.0);
+				gp.end();
+				w.graphImage = QtConcurrent::run(&_pool, saveImage, gimg,
+				  base + "-graph.png");
+				w.graph = true;
+			}
+		}
+		delete load.data;
+
+		w.file = files.at(i);
+		w.load = load.time;
+		w.render = timer.elapsed();
+		w.image = QtConcurrent::run(&_pool, saveImage, img, base + ".png");
+		writes.append(w);
+
+		/* Limit the number of images waiting for the workers */
+		while (writes.size() > _jobs) {
+			if (!report(writes.first()))
+				errors++;
+			writes.removeFirst();
+		}
+	}
+
+	for (int i = 0; i < writes.size(); i++)
+		if (!report(writes[i]))
+			errors++;
+	_pool.waitForDone();
+
+	fprintf(stderr, "%d files, %d errors, %lld ms\n", (int)files.size(), errors,
+	  (long long)total.elapsed());
+
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,52 @@
+#ifndef BATCHRENDER_H
+#define BATCHRENDER_H
+
+#include <QStringList>
+#include <QSize>
+#include <QColor>
+#include <QThreadPool>
+
+class Map;
+class POI;
+class MapView;
+class ElevationGraph;
+
+/* Headless (offscreen) rendering of data files into PNG images. All the files
+   are plotted by a single map view, so the map tile caches are shared between
+   the files. Loading of the next files (where the platform allows it) and
+   writing of the images runs in a worker pool while the map view plots the
+   current file. */
+class BatchRender
+{
+public:
+	BatchRender(const QStringList &args);
+	~BatchRender();
+
+	int run();
+
+	static bool isBatch(int argc, char **argv);
+	static void usage();
+
+private:
+	bool parseArgs(QStringList args);
+	bool loadMap();
+	void dataFiles(QStringList &files, QStringList &outputs) const;
+
+	QString _outDir, _mapPath;
+	QStringList _inputs;
+	QSize _size;
+	QColor _color;
+	int _width;
+	Qt::PenStyle _style;
+	bool _graph;
+	int _jobs;
+	bool _valid;
+
+	Map *_map;
+	POI *_poi;
+	MapView *_mapView;
+	ElevationGraph *_elevationGraph;
+	QThreadPool _pool;
+};
+
+#endif // BATCHRENDER_H
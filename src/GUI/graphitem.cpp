@@ -1,8 +1,14 @@
+#include <algorithm>
 #include <QPainter>
 #include <QGraphicsSceneMouseEvent>
+#include "common/trace.h"
 #include "popup.h"
 #include "graphitem.h"
 
+/* Segments with less than DECIMATION_RATIO points per pixel column are drawn
+   directly, the larger ones are decimated to first/min/max/last points per
+   pixel column (M4 decimation) which does not change the rendered line. */
+#define DECIMATION_RATIO 4
 
 GraphItem::GraphItem(const Graph &graph, GraphType type, int width,
   const QColor &color, Qt::PenStyle style, QGraphicsItem *parent)
@@ -15,6 +21,11 @@ GraphItem::GraphItem(const Graph &graph, GraphType type, int width,
 	_pen = QPen(GraphItem::color(), width, style, Qt::FlatCap);
 
 	_time = _graph.hasTime();
+
+	_summary.reserve(_graph.size());
+	for (int i = 0; i < _graph.size(); i++)
+		_summary.append(GraphSummary(_graph.at(i)));
+
 	setZValue(2.0);
 	setAcceptHoverEvents(true);
 
@@ -253,30 +264,74 @@ void GraphItem::setScale(qreal sx, qreal sy)
 	updatePath();
 }
 
+void GraphItem::addPoint(const QPointF &p, QPointF &last)
+{
+	QPointF diff(last - p);
+
+	if (qAbs(diff.x()) >= 1.0 || qAbs(diff.y()) >= 1.0) {
+		_path.lineTo(p);
+		last = p;
+	}
+}
+
+void GraphItem::addSegment(const GraphSegment &segment,
+  const GraphSummary &summary)
+{
+	QPointF p1(segment.first().x(_type) * _sx, -segment.first().y() * _sy);
+	qreal columns = qAbs(segment.last().x(_type) - segment.first().x(_type))
+	  * _sx + 1.0;
+
+	_path.moveTo(p1);
+
+	if (segment.size() < DECIMATION_RATIO * columns) {
+		for (int i = 1; i < segment.size(); i++)
+			addPoint(QPointF(segment.at(i).x(_type) * _sx, -segment.at(i).y()
+			  * _sy), p1);
+		return;
+	}
+
+	int start = 0;
+	while (start < segment.size()) {
+		qreal column = floor(segment.at(start).x(_type) * _sx) + 1.0;
+		int low = start + 1, high = segment.size();
+
+		// First point of the next pixel column
+		while (low < high) {
+			int mid = low + (high - low) / 2;
+			if (segment.at(mid).x(_type) * _sx < column)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+
+		int idx[4];
+		idx[0] = start;
+		idx[3] = low - 1;
+		summary.minMax(segment, start, low - 1, idx[1], idx[2]);
+		std::sort(idx, idx + 4);
+
+		for (int i = 0; i < 4; i++) {
+			if (i && idx[i] == idx[i-1])
+				continue;
+			addPoint(QPointF(segment.at(idx[i]).x(_type) * _sx,
+			  -segment.at(idx[i]).y() * _sy), p1);
+		}
+
+		start = low;
+	}
+}
+
 void GraphItem::updatePath()
 {
+	TRACE_SCOPE("GraphItem::updatePath");
+
 	prepareGeometryChange();
 
 	_path = QPainterPath();
 
-	if (!((_type == Time && !_time) || _sx == 0 || _sy == 0)) {
-		for (int i = 0; i < _graph.size(); i++) {
-			const GraphSegment &segment = _graph.at(i);
-			QPointF p1(segment.first().x(_type) * _sx, -segment.first().y()
-			  * _sy);
-
-			_path.moveTo(p1);
-			for (int i = 1; i < segment.size(); i++) {
-				QPointF p2(segment.at(i).x(_type) * _sx, -segment.at(i).y()
-				  * _sy);
-				QPointF diff(p1 - p2);
-				if (qAbs(diff.x()) >= 1.0 || qAbs(diff.y()) >= 1.0) {
-					_path.lineTo(p2);
-					p1 = p2;
-				}
-			}
-		}
-	}
+	if (!((_type == Time && !_time) || _sx == 0 || _sy == 0))
+		for (int i = 0; i < _graph.size(); i++)
+			addSegment(_graph.at(i), _summary.at(i));
 
 	updateShape();
 }
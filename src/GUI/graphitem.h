@@ -6,6 +6,7 @@
 #include "data/graph.h"
 #include "units.h"
 #include "graphicsscene.h"
+#include "graphsummary.h"
 
 class GraphItem : public QObject, public GraphicsItem
 {
@@ -73,12 +74,15 @@ protected:
 private:
 	const GraphSegment *segment(qreal x, GraphType type) const;
 	void updatePath();
+	void addSegment(const GraphSegment &segment, const GraphSummary &summary);
+	void addPoint(const QPointF &p, QPointF &last);
 	void updateShape();
 	void updateBounds();
 	void updateColor();
 	const QColor &color() const;
 
 	Graph _graph;
+	QVector<GraphSummary> _summary;
 
 	QColor _color;
 	GraphType _type;
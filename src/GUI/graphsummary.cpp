@@ -0,0 +1,74 @@
+#include "graphsummary.h"
+
+#define BLOCK_SIZE 16
+
+static inline void update(const GraphSegment &segment, int imin, int imax,
+  int &min, int &max)
+{
+	if (segment.at(imin).y() < segment.at(min).y())
+		min = imin;
+	if (segment.at(imax).y() > segment.at(max).y())
+		max = imax;
+}
+
+GraphSummary::GraphSummary(const GraphSegment &segment)
+{
+	int blocks = segment.size() / BLOCK_SIZE;
+	if (!blocks)
+		return;
+
+	QVector<Node> level(blocks);
+	for (int i = 0; i < blocks; i++) {
+		int start = i * BLOCK_SIZE;
+		int min = start, max = start;
+		for (int j = start + 1; j < start + BLOCK_SIZE; j++)
+			update(segment, j, j, min, max);
+		level[i] = Node(min, max);
+	}
+	_levels.append(level);
+
+	while (_levels.last().size() > 1) {
+		const QVector<Node> &prev = _levels.last();
+		QVector<Node> next(prev.size() / 2);
+
+		for (int i = 0; i < next.size(); i++) {
+			int min = prev.at(2*i).min, max = prev.at(2*i).max;
+			update(segment, prev.at(2*i+1).min, prev.at(2*i+1).max, min, max);
+			next[i] = Node(min, max);
+		}
+
+		_levels.append(next);
+	}
+}
+
+/* Finds the indexes of the min/max y values in the <from, to> range */
+void GraphSummary::minMax(const GraphSegment &segment, int from, int to,
+  int &min, int &max) const
+{
+	int i = from;
+
+	min = from;
+	max = from;
+
+	while (i <= to && (i % BLOCK_SIZE)) {
+		update(segment, i, i, min, max);
+		i++;
+	}
+
+	while (i + BLOCK_SIZE - 1 <= to && !_levels.isEmpty()) {
+		int level = 0;
+		while (level + 1 < _levels.size()
+		  && !(i % (BLOCK_SIZE << (level + 1)))
+		  && i + (BLOCK_SIZE << (level + 1)) - 1 <= to)
+			level++;
+
+		const Node &n = _levels.at(level).at(i / (BLOCK_SIZE << level));
+		update(segment, n.min, n.max, min, max);
+		i += BLOCK_SIZE << level;
+	}
+
+	while (i <= to) {
+		update(segment, i, i, min, max);
+		i++;
+	}
+}
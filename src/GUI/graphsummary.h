@@ -0,0 +1,31 @@
+#ifndef GRAPHSUMMARY_H
+#define GRAPHSUMMARY_H
+
+#include <QVector>
+#include "data/graph.h"
+
+/* Multi-resolution min/max summary of a graph segment's y values. Allows
+   to find the min/max points of an arbitrary index range in O(log(n)) which
+   is what the per-pixel (M4) graph decimation needs. */
+class GraphSummary
+{
+public:
+	GraphSummary() {}
+	GraphSummary(const GraphSegment &segment);
+
+	void minMax(const GraphSegment &segment, int from, int to, int &min,
+	  int &max) const;
+
+private:
+	struct Node {
+		Node() : min(0), max(0) {}
+		Node(int min, int max) : min(min), max(max) {}
+
+		int min;
+		int max;
+	};
+
+	QVector<QVector<Node> > _levels;
+};
+
+#endif // GRAPHSUMMARY_H
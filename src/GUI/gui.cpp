@@ -10,6 +10,7 @@
 #include <QPainter>
 #include <QPaintEngine>
 #include <QPaintDevice>
+#include <QPicture>
 #include <QKeyEvent>
 #include <QMenu>
 #include <QToolBar>
@@ -26,14 +27,21 @@
 #include <QScreen>
 #include <QStyle>
 #include <QTabBar>
+#include <QProgressDialog>
+#include <QtConcurrent>
 #include <QGeoPositionInfoSource>
 #include "common/config.h"
 #include "common/programpaths.h"
 #include "data/data.h"
 #include "data/poi.h"
 #include "map/downloader.h"
+#include "map/tilestore.h"
+#include "map/tileseeder.h"
 #include "map/demloader.h"
+#include "map/cachebudget.h"
+#include "map/prefetch.h"
 #include "map/maplist.h"
+#include "map/mapcatalog.h"
 #include "map/emptymap.h"
 #include "map/crs.h"
 #include "map/hillshading.h"
@@ -55,6 +63,7 @@
 #include "pathitem.h"
 #include "mapaction.h"
 #include "poiaction.h"
+#include "pngwriter.h"
 #include "gui.h"
 #ifdef Q_OS_ANDROID
 #include "common/util.h"
@@ -65,6 +74,16 @@
 #define MAX_RECENT_FILES  10
 #define TOOLBAR_ICON_SIZE 22
 
+#define SEED_WARNING         1000
+/* Estimated average size of a map tile */
+#define SEED_TILE_SIZE       20480
+#define SEED_MESSAGE_TIMEOUT 5000
+
+/* PNG exports bigger than STRIP_THRESHOLD pixels (128MB of ARGB32 data) are
+   rendered in strips of STRIP_PIXELS pixels and streamed into the PNG file */
+#define STRIP_THRESHOLD (1<<25)
+#define STRIP_PIXELS    (1<<23)
+
 GUI::GUI()
 {
 	QString activeMap;
@@ -74,6 +93,10 @@ GUI::GUI()
 	_dem = new DEMLoader(ProgramPaths::demDir(true), this);
 	connect(_dem, &DEMLoader::finished, this, &GUI::demLoaded);
 
+	_mapSeed.area = MapSeed::View;
+	_mapSeed.radius = 1000;
+	_mapSeed.dem = false;
+
 	createMapView();
 	createGraphTabs();
 	createStatusBar();
@@ -208,6 +231,9 @@ void GUI::createActions()
 	_pathsAction = new QAction(tr("Paths"), this);
 	_pathsAction->setMenuRole(QAction::NoRole);
 	connect(_pathsAction, &QAction::triggered, this, &GUI::paths);
+	_memoryAction = new QAction(tr("Memory usage"), this);
+	_memoryAction->setMenuRole(QAction::NoRole);
+	connect(_memoryAction, &QAction::triggered, this, &GUI::memory);
 #ifndef Q_OS_ANDROID
 	_keysAction = new QAction(tr("Keyboard controls"), this);
 	_keysAction->setMenuRole(QAction::NoRole);
@@ -350,6 +376,14 @@ void GUI::createActions()
 	_clearMapCacheAction->setMenuRole(QAction::NoRole);
 	connect(_clearMapCacheAction, &QAction::triggered, this,
 	  &GUI::clearMapCache);
+	_seedMapAction = new QAction(tr("Download offline area..."), this);
+	_seedMapAction->setEnabled(false);
+	_seedMapAction->setMenuRole(QAction::NoRole);
+	connect(_seedMapAction, &QAction::triggered, this, &GUI::seedMap);
+	_cancelSeedAction = new QAction(tr("Cancel offline area download"), this);
+	_cancelSeedAction->setEnabled(false);
+	_cancelSeedAction->setMenuRole(QAction::NoRole);
+	connect(_cancelSeedAction, &QAction::triggered, this, &GUI::cancelSeed);
 	_nextMapAction = new QAction(tr("Next map"), this);
 	_nextMapAction->setMenuRole(QAction::NoRole);
 	_nextMapAction->setShortcut(NEXT_MAP_SHORTCUT);
@@ -472,6 +506,11 @@ void GUI::createActions()
 	_useStylesAction->setCheckable(true);
 	connect(_useStylesAction, &QAction::triggered, _mapView,
 	  &MapView::useStyles);
+	_trackHeatmapAction = new QAction(tr("Show tracks as heatmap"), this);
+	_trackHeatmapAction->setMenuRole(QAction::NoRole);
+	_trackHeatmapAction->setCheckable(true);
+	connect(_trackHeatmapAction, &QAction::triggered, _mapView,
+	  &MapView::useHeatmap);
 
 	// DEM actions
 	_downloadDataDEMAction = new QAction(tr("Download data DEM"), this);
@@ -692,6 +731,8 @@ void GUI::createMenus()
 	_mapMenu->addAction(_loadMapAction);
 	_mapMenu->addAction(_loadMapDirAction);
 	_mapMenu->addAction(_clearMapCacheAction);
+	_mapMenu->addAction(_seedMapAction);
+	_mapMenu->addAction(_cancelSeedAction);
 	_mapMenu->addSeparator();
 	QMenu *layersMenu = _mapMenu->addMenu(tr("Layers"));
 	layersMenu->menuAction()->setMenuRole(QAction::NoRole);
@@ -727,6 +768,7 @@ void GUI::createMenus()
 	markerMenu->addAction(_showMarkerCoordinatesAction);
 	dataMenu->addSeparator();
 	dataMenu->addAction(_useStylesAction);
+	dataMenu->addAction(_trackHeatmapAction);
 	dataMenu->addSeparator();
 	dataMenu->addAction(_showTracksAction);
 	dataMenu->addAction(_showRoutesAction);
@@ -785,6 +827,7 @@ void GUI::createMenus()
 
 	QMenu *helpMenu = menuBar()->addMenu(tr("&Help"));
 	helpMenu->addAction(_pathsAction);
+	helpMenu->addAction(_memoryAction);
 #ifndef Q_OS_ANDROID
 	helpMenu->addAction(_keysAction);
 #endif // Q_OS_ANDROID
@@ -1013,6 +1056,47 @@ void GUI::paths()
 	msgBox.exec();
 }
 
+static QString memorySize(qint64 bytes)
+{
+	return QString::number(bytes / (1024.0 * 1024.0), 'f', 1) + UNIT_SPACE
+	  + QObject::tr("MB");
+}
+
+void GUI::memory()
+{
+	QMessageBox msgBox(this);
+	QList<CacheBudget::Stats> stats(CacheBudget::stats());
+	QString table("<style>td {white-space: pre; padding-right: 1em;}</style>"
+	  "<table><tr><th align=\"left\">" + tr("Cache") + "</th><th>" + tr("Size")
+	  + "</th><th>" + tr("Entries") + "</th><th>" + tr("Hit rate")
+	  + "</th></tr>");
+
+	for (int i = 0; i < stats.size(); i++) {
+		const CacheBudget::Stats &s = stats.at(i);
+		qint64 requests = s.hits + s.misses;
+
+		table += "<tr><td>" + s.name + "</td><td align=\"right\">"
+		  + memorySize(s.size) + "</td><td align=\"right\">"
+		  + QString::number(s.count) + "</td><td align=\"right\">"
+		  + (requests ? QString::number(100.0 * s.hits / requests, 'f', 1)
+		  + "%" : QString("-")) + "</td></tr>";
+	}
+	table += "<tr><td><b>" + tr("Total") + "</b></td><td align=\"right\"><b>"
+	  + memorySize(CacheBudget::size()) + "</b></td><td colspan=\"2\">/ "
+	  + memorySize(CacheBudget::limit()) + "</td></tr></table><p>"
+	  + tr("Image cache limit:") + " " + memorySize(
+	  (qint64)QPixmapCache::cacheLimit() * 1024) + "<br/>"
+	  + tr("Prefetched tiles:") + " " + QString::number(
+	  Prefetch::renderedCount()) + " " + tr("rendered") + ", "
+	  + QString::number(Prefetch::usedCount()) + " " + tr("used") + "</p>";
+
+	msgBox.setWindowTitle(tr("Memory usage"));
+	msgBox.setText("<h3>" + tr("Memory usage") + "</h3>");
+	msgBox.setInformativeText(table);
+
+	msgBox.exec();
+}
+
 void GUI::openFile()
 {
 #ifdef Q_OS_ANDROID
@@ -1325,39 +1409,153 @@ void GUI::exportPDFFile()
 	plot(&printer);
 }
 
-void GUI::exportPNGFile()
+static MapView::Flags mapFlags(bool hires, bool expand)
 {
-	PNGExportDialog dialog(_pngExport, this);
-	if (dialog.exec() != QDialog::Accepted)
-		return;
+	MapView::Flags flags;
+	if (hires)
+		flags |= MapView::HiRes;
+	if (expand)
+		flags |= MapView::Expand;
 
-	QImage img(_pngExport.size, QImage::Format_ARGB32_Premultiplied);
-	QPainter p(&img);
-	QRectF rect(0, 0, img.width(), img.height());
+	return flags;
+}
+
+static bool writeStrip(PNGWriter *writer, const QImage &strip)
+{
+	return writer->write(strip);
+}
+
+/* Big pages are rendered in horizontal strips of a bounded size, every strip
+   is compressed in a worker thread while the next one is being rendered. */
+bool GUI::exportPNGPage(const QString &fileName, const QSize &size,
+  bool graphs, QProgressDialog *progress)
+{
+	QRectF rect(0, 0, _pngExport.size.width(), _pngExport.size.height());
 	QRectF contentRect(rect.adjusted(_pngExport.margins.left(),
 	  _pngExport.margins.top(), -_pngExport.margins.right(),
 	  -_pngExport.margins.bottom()));
+	int base = progress->value();
+
+	if ((qint64)size.width() * size.height() <= STRIP_THRESHOLD) {
+		QImage img(size, QImage::Format_ARGB32_Premultiplied);
+		QPainter p(&img);
 
+		if (_pngExport.antialiasing)
+			p.setRenderHint(QPainter::Antialiasing);
+		p.fillRect(img.rect(), Qt::white);
+		if (graphs)
+			plotGraphsPage(&p, contentRect, 1);
+		else
+			plotMainPage(&p, contentRect, 1.0, true);
+		p.end();
+
+		progress->setValue(base + size.height());
+		if (!img.save(fileName, "png")) {
+			QMessageBox::critical(this, APP_NAME, tr("Error writing PNG file:")
+			  + "\n" + Util::displayName(fileName));
+			return false;
+		}
+
+		return true;
+	}
+
+	PNGWriter writer(fileName, size);
+	int stripHeight = qBound(1, STRIP_PIXELS / size.width(), size.height());
+	QFuture<bool> future;
+	bool pending = false, plotting = false, ret = true;
+	QPicture page;
+	QRectF mapRect;
+
+	/* The info and graph part of the page is plotted only once and replayed
+	   in every strip */
+	QPainter pp(&page);
 	if (_pngExport.antialiasing)
-		p.setRenderHint(QPainter::Antialiasing);
-	p.fillRect(rect, Qt::white);
-	plotMainPage(&p, contentRect, 1.0, true);
-	img.save(_pngExport.fileName, "png");
+		pp.setRenderHint(QPainter::Antialiasing);
+	if (graphs)
+		plotGraphsPage(&pp, contentRect, 1);
+	else
+		mapRect = plotMainPageInfo(&pp, contentRect, 1.0);
+	pp.end();
 
-	if (!_tabs.isEmpty() && _options.separateGraphPage) {
-		QImage img2(_pngExport.size.width(), (int)graphPlotHeight(rect, 1)
-		  + _pngExport.margins.bottom(), QImage::Format_ARGB32_Premultiplied);
-		QPainter p2(&img2);
-		QRectF rect2(0, 0, img2.width(), img2.height());
+	if (!writer.open()) {
+		QMessageBox::critical(this, APP_NAME, tr("Error writing PNG file:")
+		  + "\n" + Util::displayName(fileName) + ": " + writer.errorString());
+		return false;
+	}
+
+	for (int y = 0; y < size.height(); y += stripHeight) {
+		QImage strip(size.width(), qMin(stripHeight, size.height() - y),
+		  QImage::Format_ARGB32_Premultiplied);
+		QRectF clip(0, y, strip.width(), strip.height());
+		QPainter p(&strip);
 
+		p.translate(0, -y);
 		if (_pngExport.antialiasing)
-			p2.setRenderHint(QPainter::Antialiasing);
-		p2.fillRect(rect2, Qt::white);
-		plotGraphsPage(&p2, contentRect, 1);
+			p.setRenderHint(QPainter::Antialiasing);
+		p.fillRect(clip, Qt::white);
+		if (page.boundingRect().intersects(clip.toAlignedRect()))
+			p.drawPicture(0, 0, page);
+
+		if (!graphs) {
+			if (!plotting) {
+				_mapView->beginPlot(&strip, mapRect, 1.0,
+				  mapFlags(_options.hiresPrint, true));
+				plotting = true;
+			}
+			_mapView->plotStrip(&p, clip);
+		}
+		p.end();
 
+		if (pending && !(ret = future.result()))
+			break;
+		future = QtConcurrent::run(writeStrip, &writer, strip);
+		pending = true;
+
+		progress->setValue(base + y + strip.height());
+		if (progress->wasCanceled()) {
+			ret = false;
+			break;
+		}
+	}
+
+	if (plotting)
+		_mapView->endPlot();
+	if (pending)
+		ret = future.result() && ret;
+	if (!writer.close() && ret && !progress->wasCanceled()) {
+		QMessageBox::critical(this, APP_NAME, tr("Error writing PNG file:")
+		  + "\n" + Util::displayName(fileName) + ": " + writer.errorString());
+		ret = false;
+	}
+	if (!ret)
+		QFile::remove(fileName);
+
+	return ret;
+}
+
+void GUI::exportPNGFile()
+{
+	PNGExportDialog dialog(_pngExport, this);
+	if (dialog.exec() != QDialog::Accepted)
+		return;
+
+	QRectF rect(0, 0, _pngExport.size.width(), _pngExport.size.height());
+	bool separate = !_tabs.isEmpty() && _options.separateGraphPage;
+	QSize graphsSize(_pngExport.size.width(), (int)graphPlotHeight(rect, 1)
+	  + _pngExport.margins.bottom());
+
+	QProgressDialog progress(tr("Exporting PNG file..."), tr("Cancel"), 0,
+	  _pngExport.size.height() + (separate ? graphsSize.height() : 0), this);
+	progress.setWindowModality(Qt::WindowModal);
+	progress.setValue(0);
+
+	if (!exportPNGPage(_pngExport.fileName, _pngExport.size, false, &progress))
+		return;
+
+	if (separate) {
 		QFileInfo fi(_pngExport.fileName);
-		img2.save(fi.absolutePath() + "/" + fi.baseName() + "-graphs."
-		  + fi.suffix(), "png");
+		exportPNGPage(fi.absolutePath() + "/" + fi.baseName() + "-graphs."
+		  + fi.suffix(), graphsSize, true, &progress);
 	}
 }
 
@@ -1470,6 +1668,15 @@ void GUI::statistics()
 
 void GUI::plotMainPage(QPainter *painter, const QRectF &rect, qreal ratio,
   bool expand)
+{
+	_mapView->plot(painter, plotMainPageInfo(painter, rect, ratio), ratio,
+	  mapFlags(_options.hiresPrint, expand));
+}
+
+/* Plots the info and the graph part of the main page and returns the rect
+   left for the map */
+QRectF GUI::plotMainPageInfo(QPainter *painter, const QRectF &rect,
+  qreal ratio)
 {
 	QLocale l(QLocale::system());
 	TrackInfo info;
@@ -1532,14 +1739,8 @@ void GUI::plotMainPage(QPainter *painter, const QRectF &rect, qreal ratio,
 		sc = 1;
 	}
 
-	MapView::Flags flags;
-	if (_options.hiresPrint)
-		flags |= MapView::HiRes;
-	if (expand)
-		flags |= MapView::Expand;
-
-	_mapView->plot(painter, QRectF(rect.x(), rect.y() + ih + mh, rect.width(),
-	  rect.height() - (ih + sc*mh + gh)), ratio, flags);
+	return QRectF(rect.x(), rect.y() + ih + mh, rect.width(),
+	  rect.height() - (ih + sc*mh + gh));
 }
 
 void GUI::plotGraphsPage(QPainter *painter, const QRectF &rect, qreal ratio)
@@ -1824,6 +2025,7 @@ void GUI::reloadMap()
 {
 	_mapView->setMap(_map);
 	updateMapDEMDownloadAction();
+	_seedMapAction->setEnabled(_map->canSeed());
 }
 
 static MapAction *findMapAction(const QList<QAction*> &mapActions,
@@ -2037,17 +2239,17 @@ void GUI::clearMapCache()
 
 void GUI::downloadDataDEM()
 {
-	downloadDEM(_mapView->boundingRect());
+	downloadDEM(QList<RectC>() << _mapView->boundingRect());
 }
 
 void GUI::downloadMapDEM()
 {
-	downloadDEM(_map->llBounds());
+	downloadDEM(QList<RectC>() << _map->llBounds());
 }
 
-void GUI::downloadDEM(const RectC &rect)
+void GUI::downloadDEM(const QList<RectC> &area)
 {
-	int cnt = _dem->numTiles(rect);
+	int cnt = _dem->numTiles(area);
 
 	if (cnt > DEM_DOWNLOAD_LIMIT)
 		QMessageBox::information(this, APP_NAME,
@@ -2055,12 +2257,108 @@ void GUI::downloadDEM(const RectC &rect)
 		  "such a huge area, download the files manually."));
 	else if (cnt < DEM_DOWNLOAD_WARNING || QMessageBox::question(this, APP_NAME,
 	  tr("Download %n DEM tiles?", "", cnt)) == QMessageBox::Yes) {
-		_demRects.append(rect);
-		if (!_dem->loadTiles(rect) && _demRects.size() == 1)
+		bool running = !_demRects.isEmpty();
+		_demRects.append(area);
+		if (!_dem->loadTiles(area) && !running)
 			demLoaded();
 	}
 }
 
+void GUI::seedMap()
+{
+	Range zooms(_map->seedZooms());
+	_mapSeed.zooms = Range(qBound(zooms.min(), _map->zoom(), zooms.max()),
+	  zooms.max());
+
+	SeedDialog dialog(_mapSeed, zooms, _mapView->boundingRect().isValid(),
+	  !_dem->url().isEmpty(), units(), this);
+	if (dialog.exec() != QDialog::Accepted)
+		return;
+
+	QList<RectC> area;
+	switch (_mapSeed.area) {
+		case MapSeed::Data:
+			area.append(_mapView->boundingRect());
+			break;
+		case MapSeed::Corridor:
+			area = _mapView->corridor(_mapSeed.radius);
+			break;
+		default:
+			area.append(_mapView->visibleRect());
+	}
+
+	TileSeeder *seeder = _map->seeder(area, _mapSeed.zooms);
+	qint64 cnt = seeder ? seeder->count() : 0;
+	if (!cnt) {
+		delete seeder;
+		QMessageBox::information(this, APP_NAME,
+		  tr("No map tiles found in the selected area."));
+		return;
+	}
+	/* The tiles cache is LRU-evicted, a seeding larger than the cache quota
+	   would evict its own tiles */
+	qint64 size = cnt * SEED_TILE_SIZE;
+	qint64 quota = _options.tileCache * 1024LL * 1024LL;
+	if (size > quota) {
+		if (QMessageBox::warning(this, APP_NAME, tr("The area requires "
+		  "approximately %1 MB of map tiles, that exceeds the map tiles cache "
+		  "size (%2 MB). Older tiles, including the downloaded ones, will be "
+		  "removed from the cache. Download anyway?").arg(QLocale::system()
+		  .toString(size / (1024 * 1024)), QLocale::system().toString(
+		  _options.tileCache)), QMessageBox::Yes | QMessageBox::No,
+		  QMessageBox::No) != QMessageBox::Yes) {
+			delete seeder;
+			return;
+		}
+	} else if (cnt > SEED_WARNING && QMessageBox::question(this, APP_NAME,
+	  tr("Download approximately %1 map tiles?").arg(QLocale::system()
+	  .toString(cnt))) != QMessageBox::Yes) {
+		delete seeder;
+		return;
+	}
+
+	cancelSeed();
+	_seeder = seeder;
+	connect(seeder, &TileSeeder::progress, this, &GUI::seedProgress);
+	connect(seeder, &TileSeeder::finished, this, &GUI::seedFinished);
+	_cancelSeedAction->setEnabled(true);
+	seeder->start();
+
+	if (_mapSeed.dem)
+		downloadDEM(area);
+}
+
+void GUI::cancelSeed()
+{
+	if (_seeder) {
+		_seeder->cancel();
+		_seeder->deleteLater();
+		_seeder = 0;
+		statusBar()->clearMessage();
+	}
+	_cancelSeedAction->setEnabled(false);
+}
+
+void GUI::seedProgress(qint64 done, qint64 total)
+{
+	statusBar()->showMessage(tr("Downloading offline area: %1%")
+	  .arg(total ? (done * 100) / total : 100));
+}
+
+void GUI::seedFinished()
+{
+	if (_seeder->failed())
+		statusBar()->showMessage(tr("Offline area downloaded, %n tiles failed",
+		  "", (int)_seeder->failed()), SEED_MESSAGE_TIMEOUT);
+	else
+		statusBar()->showMessage(tr("Offline area downloaded"),
+		  SEED_MESSAGE_TIMEOUT);
+
+	_seeder->deleteLater();
+	_seeder = 0;
+	_cancelSeedAction->setEnabled(false);
+}
+
 
 void GUI::demLoaded()
 {
@@ -2185,6 +2483,7 @@ void GUI::mapChanged(QAction *action)
 	_map = action->data().value<Map*>();
 	_mapView->setMap(_map);
 	updateMapDEMDownloadAction();
+	_seedMapAction->setEnabled(_map->canSeed());
 }
 
 void GUI::nextMap()
@@ -2621,6 +2920,7 @@ void GUI::writeSettings()
 	  || _showMarkerCoordinatesAction->isChecked());
 	WRITE(markerInfo, mi);
 	WRITE(useStyles, _useStylesAction->isChecked());
+	WRITE(trackHeatmap, _trackHeatmapAction->isChecked());
 	settings.endGroup();
 
 	/* DEM */
@@ -2716,6 +3016,9 @@ void GUI::writeSettings()
 	WRITE(enableHTTP2, _options.enableHTTP2);
 	WRITE(pixmapCache, _options.pixmapCache);
 	WRITE(demCache, _options.demCache);
+	WRITE(dataCache, _options.dataCache);
+	WRITE(tileCache, _options.tileCache);
+	WRITE(prefetchRing, _options.prefetchRing);
 	WRITE(connectionTimeout, _options.connectionTimeout);
 	WRITE(hiresPrint, _options.hiresPrint);
 	WRITE(printName, _options.printName);
@@ -2911,6 +3214,10 @@ void GUI::readSettings(QString &activeMap, QStringList &disabledPOIs,
 		_useStylesAction->setChecked(true);
 		_mapView->useStyles(true);
 	}
+	if (READ(trackHeatmap).toBool()) {
+		_trackHeatmapAction->setChecked(true);
+		_mapView->useHeatmap(true);
+	}
 	if (READ(positionMarkers).toBool()) {
 		MarkerInfoItem::Type mt = (MarkerInfoItem::Type)READ(markerInfo).toInt();
 		if (mt == MarkerInfoItem::Position)
@@ -3032,6 +3339,9 @@ void GUI::readSettings(QString &activeMap, QStringList &disabledPOIs,
 	_options.enableHTTP2 = READ(enableHTTP2).toBool();
 	_options.pixmapCache = READ(pixmapCache).toInt();
 	_options.demCache = READ(demCache).toInt();
+	_options.dataCache = READ(dataCache).toInt();
+	_options.tileCache = READ(tileCache).toInt();
+	_options.prefetchRing = READ(prefetchRing).toInt();
 	_options.connectionTimeout = READ(connectionTimeout).toInt();
 	_options.hiresPrint = READ(hiresPrint).toBool();
 	_options.printName = READ(printName).toBool();
@@ -3118,6 +3428,9 @@ void GUI::loadOptions()
 
 	QPixmapCache::setCacheLimit(_options.pixmapCache * 1024);
 	DEM::setCacheSize(_options.demCache * 1024);
+	CacheBudget::setLimit((qint64)_options.dataCache * 1024 * 1024);
+	TileStore::setQuota(_options.tileCache * 1024LL * 1024LL);
+	Prefetch::setRing(_options.prefetchRing);
 
 	HillShading::setAlpha(_options.hillshadingAlpha);
 	HillShading::setBlur(_options.hillshadingBlur);
@@ -3258,6 +3571,12 @@ void GUI::updateOptions(const Options &options)
 		QPixmapCache::setCacheLimit(options.pixmapCache * 1024);
 	if (options.demCache != _options.demCache)
 		DEM::setCacheSize(options.demCache * 1024);
+	if (options.dataCache != _options.dataCache)
+		CacheBudget::setLimit((qint64)options.dataCache * 1024 * 1024);
+	if (options.tileCache != _options.tileCache)
+		TileStore::setQuota(options.tileCache * 1024LL * 1024LL);
+	if (options.prefetchRing != _options.prefetchRing)
+		Prefetch::setRing(options.prefetchRing);
 
 	SET_HS_OPTION(hillshadingAlpha, setAlpha);
 	SET_HS_OPTION(hillshadingBlur, setBlur);
@@ -3295,7 +3614,10 @@ void GUI::loadInitialMaps(const QString &selected)
 	if (mapDir.isNull())
 		return;
 
-	TreeNode<Map*> maps(MapList::loadMaps(mapDir, _mapView->inputProjection()));
+	MapCatalog catalog(ProgramPaths::mapCatalogFile());
+	TreeNode<Map*> maps(MapList::loadMaps(mapDir, _mapView->inputProjection(),
+	  &catalog));
+	catalog.save();
 	createMapNodeMenu(createMapActionsNode(maps), _mapMenu, _mapsEnd);
 
 	// Select the active map according to the user settings
@@ -6,6 +6,7 @@
 #include <QList>
 #include <QDate>
 #include <QPrinter>
+#include <QPointer>
 #include "common/treenode.h"
 #include "common/rectc.h"
 #include "data/graph.h"
@@ -14,6 +15,7 @@
 #include "format.h"
 #include "pdfexportdialog.h"
 #include "pngexportdialog.h"
+#include "seeddialog.h"
 #include "optionsdialog.h"
 
 class QMenu;
@@ -24,6 +26,7 @@ class QAction;
 class QLabel;
 class QSplitter;
 class QPrinter;
+class QProgressDialog;
 class QGeoPositionInfoSource;
 class FileBrowser;
 class GraphTab;
@@ -35,6 +38,7 @@ class MapAction;
 class POIAction;
 class Data;
 class DEMLoader;
+class TileSeeder;
 class NavigationWidget;
 
 class GUI : public QMainWindow
@@ -55,6 +59,7 @@ private slots:
 	void keys();
 #endif // Q_OS_ANDROID
 	void paths();
+	void memory();
 	void printFile();
 	void exportPDFFile();
 	void exportPNGFile();
@@ -87,6 +92,8 @@ private slots:
 	void clearMapCache();
 	void downloadDataDEM();
 	void downloadMapDEM();
+	void seedMap();
+	void cancelSeed();
 	void showDEMTiles();
 
 	void mapChanged(QAction *action);
@@ -124,6 +131,8 @@ private slots:
 	void mapInitialized();
 
 	void demLoaded();
+	void seedProgress(qint64 done, qint64 total);
+	void seedFinished();
 
 private:
 	typedef QPair<QDateTime, QDateTime> DateTimeRange;
@@ -132,8 +141,12 @@ private:
 	void plot(QPrinter *printer);
 	void plotMainPage(QPainter *painter, const QRectF &rect, qreal ratio,
 	  bool expand = false);
+	QRectF plotMainPageInfo(QPainter *painter, const QRectF &rect,
+	  qreal ratio);
 	void plotGraphsPage(QPainter *painter, const QRectF &rect, qreal ratio);
 	qreal graphPlotHeight(const QRectF &rect, qreal ratio);
+	bool exportPNGPage(const QString &fileName, const QSize &size,
+	  bool graphs, QProgressDialog *progress);
 
 	TreeNode<POIAction*> createPOIActionsNode(const TreeNode<QString> &node);
 	TreeNode<MapAction*> createMapActionsNode(const TreeNode<Map*> &node);
@@ -195,7 +208,7 @@ private:
 	void loadRecentFiles(const QStringList &files);
 #endif // Q_OS_ANDROID
 
-	void downloadDEM(const RectC &rect);
+	void downloadDEM(const QList<RectC> &area);
 
 	void loadOptions();
 	void updateOptions(const Options &options);
@@ -231,6 +244,7 @@ private:
 	QAction *_exitAction;
 #endif // Q_OS_MAC + Q_OS_ANDROID
 	QAction *_pathsAction;
+	QAction *_memoryAction;
 	QAction *_aboutAction;
 	QAction *_printFileAction;
 	QAction *_exportPDFFileAction;
@@ -255,6 +269,8 @@ private:
 	QAction *_loadMapAction;
 	QAction *_loadMapDirAction;
 	QAction *_clearMapCacheAction;
+	QAction *_seedMapAction;
+	QAction *_cancelSeedAction;
 	QAction *_showGraphsAction;
 	QAction *_showGraphGridAction;
 	QAction *_showGraphSliderInfoAction;
@@ -294,6 +310,7 @@ private:
 	QAction *_showMarkerCoordinatesAction;
 	QAction *_showTicksAction;
 	QAction *_useStylesAction;
+	QAction *_trackHeatmapAction;
 	QAction *_showCoordinatesAction;
 	QAction *_openOptionsAction;
 	QAction *_downloadDataDEMAction;
@@ -342,6 +359,7 @@ private:
 
 	PDFExport _pdfExport;
 	PNGExport _pngExport;
+	MapSeed _mapSeed;
 	Options _options;
 
 	QString _dataDir, _mapDir, _poiDir;
@@ -349,6 +367,7 @@ private:
 	Units _units;
 
 	QList<RectC> _demRects;
+	QPointer<TileSeeder> _seeder;
 };
 
 #endif // GUI_H
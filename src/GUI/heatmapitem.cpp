@@ -0,0 +1,397 @@
+#include <cmath>
+#include <QPainter>
+#include <QPixmapCache>
+#include <QStyleOptionGraphicsItem>
+#include <QGraphicsSceneHoverEvent>
+#include "common/util.h"
+#include "map/map.h"
+#include "pathitem.h"
+#include "heatmapitem.h"
+
+
+#define TILE_SIZE   256
+#define DENSITY_STEP 24
+
+static int version = 0;
+
+static bool cb(int data, void *context)
+{
+	QList<int> *list = (QList<int>*)context;
+	list->append(data);
+
+	return true;
+}
+
+static QVector<QRgb> colorTable()
+{
+	QVector<QRgb> table(256);
+	QColor stops[] = {QColor(0, 0, 255), QColor(0, 255, 255),
+	  QColor(0, 255, 0), QColor(255, 255, 0), QColor(255, 0, 0)};
+	int n = ARRAY_SIZE(stops) - 1;
+
+	table[0] = qRgba(0, 0, 0, 0);
+	for (int i = 1; i < 256; i++) {
+		qreal pos = (i / 255.0) * n;
+		int s = qMin((int)pos, n - 1);
+		qreal f = pos - s;
+		QColor c(stops[s].red() + f * (stops[s+1].red() - stops[s].red()),
+		  stops[s].green() + f * (stops[s+1].green() - stops[s].green()),
+		  stops[s].blue() + f * (stops[s+1].blue() - stops[s].blue()),
+		  qMin(255, 96 + i));
+		table[i] = qPremultiply(c.rgba());
+	}
+
+	return table;
+}
+
+void HeatmapData::append(const QPolygonF &points, int path)
+{
+	qreal min[2], max[2];
+
+	_polylines.append(Polyline(points, path));
+
+	const QRectF &r = _polylines.last().bounds;
+	min[0] = r.left();
+	min[1] = r.top();
+	max[0] = r.right();
+	max[1] = r.bottom();
+	_tree.Insert(min, max, _polylines.size() - 1);
+}
+
+void HeatmapData::search(const QRectF &rect, QList<int> &list) const
+{
+	qreal min[2], max[2];
+
+	min[0] = rect.left();
+	min[1] = rect.top();
+	max[0] = rect.right();
+	max[1] = rect.bottom();
+	_tree.Search(min, max, cb, &list);
+}
+
+void HeatmapTile::render()
+{
+	static const QVector<QRgb> table(colorTable());
+	qreal w = _data->width();
+	QRectF br(_rect.adjusted(-w, -w, w, w));
+	QImage img(TILE_SIZE, TILE_SIZE, QImage::Format_ARGB32_Premultiplied);
+	img.fill(Qt::transparent);
+
+	/* The path density is accumulated in the alpha channel */
+	QPainter painter(&img);
+	painter.setRenderHint(QPainter::Antialiasing);
+	painter.setCompositionMode(QPainter::CompositionMode_Plus);
+	painter.setPen(QPen(QColor(0, 0, 0, DENSITY_STEP), w, Qt::SolidLine,
+	  Qt::RoundCap, Qt::RoundJoin));
+	painter.translate(-_rect.topLeft());
+
+	QList<int> list;
+	_data->search(br, list);
+	const QVector<HeatmapData::Polyline> &polylines = _data->polylines();
+	for (int i = 0; i < list.size(); i++)
+		painter.drawPolyline(polylines.at(list.at(i)).points);
+	painter.end();
+
+	for (int y = 0; y < img.height(); y++) {
+		QRgb *line = (QRgb*)img.scanLine(y);
+		for (int x = 0; x < img.width(); x++)
+			line[x] = table.at(qAlpha(line[x]));
+	}
+
+	_pixmap = QPixmap::fromImage(img);
+}
+
+
+HeatmapItem::HeatmapItem(Map *map, QGraphicsItem *parent)
+  : QGraphicsItem(parent), _map(map), _width(3), _digitalZoom(0),
+  _block(false), _dirty(false), _version(version++), _hovered(0)
+{
+	_data = QSharedPointer<const HeatmapData>(new HeatmapData(_width));
+
+	setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+	setAcceptHoverEvents(true);
+}
+
+HeatmapItem::~HeatmapItem()
+{
+	cancelJobs(true);
+}
+
+QString HeatmapItem::tileKey(const QPoint &tile) const
+{
+	return "heatmap_" + QString::number(_version) + "_"
+	  + QString::number(_map->zoom()) + "_" + QString::number(tile.x()) + "_"
+	  + QString::number(tile.y());
+}
+
+/* Paths are projected in parallel on the global thread pool, each into its
+   own polylines list. */
+struct PathProjection
+{
+	PathProjection() : path(0), map(0) {}
+	PathProjection(const Path *path, Map *map) : path(path), map(map) {}
+
+	const Path *path;
+	Map *map;
+	QList<QPolygonF> polylines;
+};
+
+static void project(PathProjection &pp)
+{
+	for (int i = 0; i < pp.path->size(); i++) {
+		const PathSegment &segment = pp.path->at(i);
+		QPolygonF pl;
+
+		pl.append(pp.map->ll2xy(segment.first().coordinates()));
+		for (int j = 1; j < segment.size(); j++) {
+			const Coordinates &c1 = segment.at(j-1).coordinates();
+			const Coordinates &c2 = segment.at(j).coordinates();
+
+			// Split the polyline on date line crossing
+			if (fabs(c1.lon() - c2.lon()) > 180.0) {
+				if (pl.size() > 1)
+					pp.polylines.append(pl);
+				pl.clear();
+				pl.append(pp.map->ll2xy(c2));
+				continue;
+			}
+
+			QPointF p(pp.map->ll2xy(c2));
+			if (qAbs(p.x() - pl.last().x()) >= 1.0
+			  || qAbs(p.y() - pl.last().y()) >= 1.0)
+				pl.append(p);
+		}
+		if (pl.size() > 1)
+			pp.polylines.append(pl);
+	}
+}
+
+/* While the layer is hidden, the projection is postponed until the layer gets
+   displayed again. */
+void HeatmapItem::updateData()
+{
+	if (!isVisible()) {
+		_dirty = true;
+		return;
+	}
+	_dirty = false;
+
+	qreal width = _width * pow(2, -_digitalZoom);
+	HeatmapData *data = new HeatmapData(width);
+	QList<PathProjection> projections;
+
+	for (int i = 0; i < _paths.size(); i++)
+		projections.append(PathProjection(&_paths.at(i)->path(), _map));
+	if (_map->ll2xyIsReentrant())
+		QtConcurrent::blockingMap(projections, project);
+	else {
+		for (int i = 0; i < projections.size(); i++)
+			project(projections[i]);
+	}
+
+	prepareGeometryChange();
+
+	_boundingRect = QRectF();
+
+	for (int i = 0; i < projections.size(); i++) {
+		const QList<QPolygonF> &polylines = projections.at(i).polylines;
+		for (int j = 0; j < polylines.size(); j++) {
+			data->append(polylines.at(j), i);
+			_boundingRect |= data->polylines().last().bounds;
+		}
+	}
+	_boundingRect.adjust(-width, -width, width, width);
+
+	_data = QSharedPointer<const HeatmapData>(data);
+}
+
+QVariant HeatmapItem::itemChange(GraphicsItemChange change,
+  const QVariant &value)
+{
+	if (change == ItemVisibleHasChanged && value.toBool() && _dirty)
+		updateData();
+
+	return QGraphicsItem::itemChange(change, value);
+}
+
+/* The paths are projected in setMap(), that must be called after all the
+   paths have been added. */
+void HeatmapItem::addPath(PathItem *path)
+{
+	_paths.append(path);
+	_version = version++;
+}
+
+void HeatmapItem::clear()
+{
+	_paths.clear();
+	_hovered = 0;
+
+	invalidate();
+	updateData();
+}
+
+/* The scene coordinates may change with the same zoom (map switch, HiDPI
+   mode change), so the rendered tiles are always dropped. */
+void HeatmapItem::setMap(Map *map)
+{
+	_map = map;
+
+	invalidate();
+	updateData();
+}
+
+void HeatmapItem::setWidth(qreal width)
+{
+	if (_width == width)
+		return;
+
+	_width = width;
+
+	invalidate();
+	updateData();
+}
+
+void HeatmapItem::setDigitalZoom(int zoom)
+{
+	if (_digitalZoom == zoom)
+		return;
+
+	_digitalZoom = zoom;
+
+	invalidate();
+	updateData();
+}
+
+/* Drops all the rendered tiles */
+void HeatmapItem::invalidate()
+{
+	_version = version++;
+
+	cancelJobs(false);
+	update();
+}
+
+void HeatmapItem::cancelJobs(bool wait)
+{
+	for (int i = 0; i < _jobs.size(); i++)
+		_jobs.at(i)->cancel(wait);
+}
+
+void HeatmapItem::jobFinished(HeatmapJob *job)
+{
+	const QList<HeatmapTile> &tiles = job->tiles();
+
+	for (int i = 0; i < tiles.size(); i++) {
+		const HeatmapTile &mt = tiles.at(i);
+		if (!mt.pixmap().isNull())
+			QPixmapCache::insert(mt.key(), mt.pixmap());
+		_running.remove(mt.key());
+	}
+
+	_jobs.removeOne(job);
+	job->deleteLater();
+
+	update();
+}
+
+void HeatmapItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
+  QWidget *widget)
+{
+	Q_UNUSED(widget);
+
+	if (_data->polylines().isEmpty())
+		return;
+
+	QRectF rect(option->exposedRect.intersected(_boundingRect));
+	QPoint tl(floor(rect.left() / TILE_SIZE), floor(rect.top() / TILE_SIZE));
+	QPoint br(ceil(rect.right() / TILE_SIZE), ceil(rect.bottom() / TILE_SIZE));
+	QList<HeatmapTile> renderTiles;
+
+	for (int i = tl.x(); i < br.x(); i++) {
+		for (int j = tl.y(); j < br.y(); j++) {
+			QPoint t(i, j);
+			QString key(tileKey(t));
+			QPointF tp(i * TILE_SIZE, j * TILE_SIZE);
+			QPixmap pm;
+
+			if (QPixmapCache::find(key, &pm))
+				painter->drawPixmap(tp, pm);
+			else if (!_running.contains(key))
+				renderTiles.append(HeatmapTile(t, QRectF(tp, QSizeF(TILE_SIZE,
+				  TILE_SIZE)), _data, key));
+		}
+	}
+
+	if (renderTiles.isEmpty())
+		return;
+
+	if (_block) {
+		QFuture<void> future = QtConcurrent::map(renderTiles,
+		  &HeatmapTile::render);
+		future.waitForFinished();
+
+		for (int i = 0; i < renderTiles.size(); i++) {
+			const HeatmapTile &mt = renderTiles.at(i);
+			QPixmapCache::insert(mt.key(), mt.pixmap());
+			painter->drawPixmap(QPointF(mt.xy().x() * TILE_SIZE,
+			  mt.xy().y() * TILE_SIZE), mt.pixmap());
+		}
+	} else {
+		HeatmapJob *job = new HeatmapJob(renderTiles);
+		for (int i = 0; i < renderTiles.size(); i++)
+			_running.insert(renderTiles.at(i).key());
+		_jobs.append(job);
+		connect(job, &HeatmapJob::finished, this, &HeatmapItem::jobFinished);
+		job->run();
+	}
+}
+
+PathItem *HeatmapItem::pathAt(const QPointF &pos) const
+{
+	qreal tolerance = (_width + 1) * pow(2, -_digitalZoom) / 2.0;
+	QRectF r(pos.x() - tolerance, pos.y() - tolerance, 2 * tolerance,
+	  2 * tolerance);
+	QList<int> candidates;
+
+	_data->search(r, candidates);
+
+	const QVector<HeatmapData::Polyline> &polylines = _data->polylines();
+	for (int i = 0; i < candidates.size(); i++) {
+		const HeatmapData::Polyline &pl = polylines.at(candidates.at(i));
+		for (int j = 1; j < pl.points.size(); j++) {
+			QLineF l(pl.points.at(j-1), pl.points.at(j));
+			QPointF d(l.p2() - l.p1());
+			qreal len2 = d.x() * d.x() + d.y() * d.y();
+			qreal u = len2 > 0 ? ((pos.x() - l.x1()) * d.x()
+			  + (pos.y() - l.y1()) * d.y()) / len2 : 0;
+			QPointF p(l.pointAt(qBound(0.0, u, 1.0)));
+			if (QLineF(p, pos).length() <= tolerance)
+				return _paths.at(pl.path);
+		}
+	}
+
+	return 0;
+}
+
+void HeatmapItem::hoverMoveEvent(QGraphicsSceneHoverEvent *event)
+{
+	PathItem *path = pathAt(event->pos());
+
+	if (path != _hovered) {
+		_hovered = path;
+		emit hoveredPathChanged(path);
+	}
+}
+
+void HeatmapItem::hoverLeaveEvent(QGraphicsSceneHoverEvent *event)
+{
+	Q_UNUSED(event);
+
+	/* The hovered path is displayed on top of the heatmap, so moving the
+	   cursor onto it also "leaves" the heatmap */
+	if (_hovered && !_hovered->isUnderMouse()) {
+		_hovered = 0;
+		emit hoveredPathChanged(0);
+	}
+}
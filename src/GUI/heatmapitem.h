@@ -0,0 +1,70 @@
+#ifndef HEATMAPITEM_H
+#define HEATMAPITEM_H
+
+#include <QGraphicsItem>
+#include <QSet>
+#include "heatmapjob.h"
+
+class Map;
+class PathItem;
+
+/* Collection layer - draws all the added paths as one density (heatmap)
+   raster. The raster is rendered in tiles on the global thread pool and
+   cached in QPixmapCache. */
+class HeatmapItem : public QObject, public QGraphicsItem
+{
+	Q_OBJECT
+
+public:
+	HeatmapItem(Map *map, QGraphicsItem *parent = 0);
+	~HeatmapItem();
+
+	QRectF boundingRect() const {return _boundingRect;}
+	void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
+	  QWidget *widget);
+
+	void addPath(PathItem *path);
+	void clear();
+
+	void setMap(Map *map);
+	void setWidth(qreal width);
+	void setDigitalZoom(int zoom);
+	void setBlockingRender(bool block) {_block = block;}
+	void invalidate();
+
+	PathItem *hoveredPath() const {return _hovered;}
+
+signals:
+	void hoveredPathChanged(PathItem *path);
+
+protected:
+	void hoverMoveEvent(QGraphicsSceneHoverEvent *event);
+	void hoverLeaveEvent(QGraphicsSceneHoverEvent *event);
+	QVariant itemChange(GraphicsItemChange change, const QVariant &value);
+
+private slots:
+	void jobFinished(HeatmapJob *job);
+
+private:
+	void updateData();
+	PathItem *pathAt(const QPointF &pos) const;
+	QString tileKey(const QPoint &tile) const;
+	void cancelJobs(bool wait);
+
+	Map *_map;
+	QList<PathItem*> _paths;
+	QSharedPointer<const HeatmapData> _data;
+	QRectF _boundingRect;
+	qreal _width;
+	int _digitalZoom;
+	bool _block;
+	bool _dirty;
+	int _version;
+
+	PathItem *_hovered;
+
+	QList<HeatmapJob*> _jobs;
+	QSet<QString> _running;
+};
+
+#endif // HEATMAPITEM_H
@@ -0,0 +1,96 @@
+#ifndef HEATMAPJOB_H
+#define HEATMAPJOB_H
+
+#include <QtConcurrent>
+#include <QSharedPointer>
+#include <QPixmap>
+#include <QPolygonF>
+#include "common/rtree.h"
+
+/* Projected paths of the heatmap. The data are immutable once created and
+   shared between the heatmap item and the tile rendering jobs. */
+class HeatmapData
+{
+public:
+	struct Polyline {
+		Polyline() : path(-1) {}
+		Polyline(const QPolygonF &points, int path)
+		  : points(points), bounds(points.boundingRect()), path(path) {}
+
+		QPolygonF points;
+		QRectF bounds;
+		int path;
+	};
+
+	HeatmapData(qreal width) : _width(width) {}
+
+	void append(const QPolygonF &points, int path);
+	void search(const QRectF &rect, QList<int> &list) const;
+
+	const QVector<Polyline> &polylines() const {return _polylines;}
+	qreal width() const {return _width;}
+
+private:
+	typedef RTree<int, qreal, 2> PolylineTree;
+
+	QVector<Polyline> _polylines;
+	PolylineTree _tree;
+	qreal _width;
+};
+
+class HeatmapTile
+{
+public:
+	HeatmapTile(const QPoint &xy, const QRectF &rect,
+	  const QSharedPointer<const HeatmapData> &data, const QString &key)
+	  : _xy(xy), _rect(rect), _data(data), _key(key) {}
+
+	void render();
+
+	const QPoint &xy() const {return _xy;}
+	const QPixmap &pixmap() const {return _pixmap;}
+	const QString &key() const {return _key;}
+
+private:
+	QPoint _xy;
+	QRectF _rect;
+	QSharedPointer<const HeatmapData> _data;
+	QString _key;
+	QPixmap _pixmap;
+};
+
+class HeatmapJob : public QObject
+{
+	Q_OBJECT
+
+public:
+	HeatmapJob(const QList<HeatmapTile> &tiles) : _tiles(tiles) {}
+
+	void run()
+	{
+		connect(&_watcher, &QFutureWatcher<void>::finished, this,
+		  &HeatmapJob::handleFinished);
+		_future = QtConcurrent::map(_tiles, &HeatmapTile::render);
+		_watcher.setFuture(_future);
+	}
+	void cancel(bool wait)
+	{
+		_future.cancel();
+		if (wait)
+			_future.waitForFinished();
+	}
+	const QList<HeatmapTile> &tiles() const {return _tiles;}
+
+signals:
+	void finished(HeatmapJob *job);
+
+private slots:
+	void handleFinished() {emit finished(this);}
+
+private:
+	QFutureWatcher<void> _watcher;
+	QFuture<void> _future;
+	QList<HeatmapTile> _tiles;
+};
+
+#endif // HEATMAPJOB_H
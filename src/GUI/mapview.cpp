@@ -4,13 +4,18 @@
 #include <QGestureEvent>
 #include <QApplication>
 #include <QScrollBar>
+#include <QTimer>
 #include <QClipboard>
 #include <QOpenGLWidget>
 #include <QGeoPositionInfoSource>
+#include <QtConcurrent>
 #include "data/poi.h"
 #include "data/data.h"
+#include "data/corridor.h"
 #include "map/map.h"
 #include "map/pcs.h"
+#include "map/prefetch.h"
+#include "common/trace.h"
 #include "trackitem.h"
 #include "routeitem.h"
 #include "waypointitem.h"
@@ -23,6 +28,7 @@
 #include "markerinfoitem.h"
 #include "crosshairitem.h"
 #include "motioninfoitem.h"
+#include "heatmapitem.h"
 #include "mapview.h"
 
 
@@ -31,6 +37,8 @@
 #define MARGIN           10
 #define SCALE_OFFSET     7
 #define COORDINATES_OFFSET SCALE_OFFSET
+#define PREFETCH_DELAY   500
+#define PLOT_STRIP       2048
 
 
 MapView::MapView(Map *map, POI *poi, QWidget *parent) : QGraphicsView(parent)
@@ -87,6 +95,13 @@ MapView::MapView(Map *map, POI *poi, QWidget *parent) : QGraphicsView(parent)
 	_motionInfo->setVisible(false);
 	_scene->addItem(_motionInfo);
 
+	_heatmap = new HeatmapItem(_map);
+	_heatmap->setVisible(false);
+	_scene->addItem(_heatmap);
+	connect(_heatmap, &HeatmapItem::hoveredPathChanged, this,
+	  &MapView::showHeatmapPath);
+	_heatmapPath = 0;
+
 	_mapOpacity = 1.0;
 	_backgroundColor = Qt::white;
 	_markerColor = Qt::red;
@@ -115,6 +130,7 @@ MapView::MapView(Map *map, POI *poi, QWidget *parent) : QGraphicsView(parent)
 	_poiSize = 8;
 	_poiColor = Qt::black;
 	_followPosition = false;
+	_useHeatmap = false;
 	_showPosition = false;
 	_showPositionCoordinates = false;
 	_showMotionInfo = false;
@@ -126,12 +142,23 @@ MapView::MapView(Map *map, POI *poi, QWidget *parent) : QGraphicsView(parent)
 	_pinchZoom = 0;
 	_wheelDelta = 0;
 
+	_prefetchTimer = new QTimer(this);
+	_prefetchTimer->setSingleShot(true);
+	_prefetchTimer->setInterval(PREFETCH_DELAY);
+	connect(_prefetchTimer, &QTimer::timeout, this, &MapView::prefetch);
+	_prefetchZoom = -1;
+
 	_res = _map->resolution(_map->bounds());
 	_scene->setSceneRect(_map->bounds());
 
 	centerOn(_scene->sceneRect().center());
 }
 
+MapView::~MapView()
+{
+	deleteHeatmapTracks();
+}
+
 void MapView::centerOn(const QPointF &pos)
 {
 	QGraphicsView::centerOn(pos);
@@ -162,7 +189,12 @@ PathItem *MapView::addTrack(const Track &track)
 	ti->showMarker(_showMarkers);
 	ti->showMarkerInfo(_markerInfoType);
 	ti->showTicks(_showPathTicks);
-	_scene->addItem(ti);
+
+	/* In the heatmap mode, only the hovered track is part of the scene */
+	if (_useHeatmap)
+		_heatmap->addPath(ti);
+	else
+		_scene->addItem(ti);
 
 	if (_showTracks)
 		addPOI(_poi->points(ti->path()));
@@ -288,8 +320,11 @@ QList<PathItem *> MapView::loadData(const Data &data)
 
 	if (fitMapZoom() != zoom)
 		rescale();
-	else
+	else {
+		if (_useHeatmap)
+			_heatmap->setMap(_map);
 		updatePOIVisibility();
+	}
 
 	centerOn(contentCenter());
 
@@ -363,13 +398,47 @@ void MapView::updatePOIVisibility()
 	}
 }
 
+/* Computes the map dependent geometry of all the items in parallel. The items
+   then only swap in the results in their setMap() call. */
+void MapView::projectItems()
+{
+	Map *map = _map;
+
+	if (!map->ll2xyIsReentrant())
+		return;
+
+	if (!_useHeatmap)
+		QtConcurrent::blockingMap(_tracks, [map](TrackItem *ti)
+		  {ti->project(map);});
+	QtConcurrent::blockingMap(_routes, [map](RouteItem *ri)
+	  {ri->project(map);});
+	QtConcurrent::blockingMap(_areas, [map](PlaneItem *pi)
+	  {pi->project(map);});
+	QtConcurrent::blockingMap(_waypoints, [map](WaypointItem *wi)
+	  {wi->project(map);});
+
+	QList<WaypointItem*> pois(_pois.values());
+	QtConcurrent::blockingMap(pois, [map](WaypointItem *wi)
+	  {wi->project(map);});
+}
+
 void MapView::rescale()
 {
 	_scene->setSceneRect(_map->bounds());
 	reloadMap();
 
-	for (int i = 0; i < _tracks.size(); i++)
-		_tracks.at(i)->setMap(_map);
+	projectItems();
+
+	/* In the heatmap mode, the track items are hidden and get updated when
+	   displayed (hovered) */
+	_heatmap->setMap(_map);
+	if (_useHeatmap) {
+		if (_heatmapPath)
+			_heatmapPath->setMap(_map);
+	} else {
+		for (int i = 0; i < _tracks.size(); i++)
+			_tracks.at(i)->setMap(_map);
+	}
 	for (int i = 0; i < _routes.size(); i++)
 		_routes.at(i)->setMap(_map);
 	for (int i = 0; i < _areas.size(); i++)
@@ -411,6 +480,7 @@ void MapView::setMap(Map *map)
 	_map = map;
 	_map->load(_inputProjection, _outputProjection, _deviceRatio, _hidpi);
 	connect(_map, &Map::tilesLoaded, this, &MapView::reloadMap);
+	_prefetchZoom = -1;
 
 	digitalZoom(0);
 
@@ -571,6 +641,7 @@ void MapView::digitalZoom(int zoom)
 	for (POIHash::const_iterator it = _pois.constBegin();
 	  it != _pois.constEnd(); it++)
 		it.value()->setDigitalZoom(_digitalZoom);
+	_heatmap->setDigitalZoom(_digitalZoom);
 
 	_mapScale->setDigitalZoom(_digitalZoom);
 	_cursorCoordinates->setDigitalZoom(_digitalZoom);
@@ -681,24 +752,33 @@ void MapView::keyReleaseEvent(QKeyEvent *event)
 
 void MapView::plot(QPainter *painter, const QRectF &target, qreal scale,
   Flags flags)
+{
+	beginPlot(painter->device(), target, scale, flags);
+	plotStrip(painter, target);
+	endPlot();
+}
+
+void MapView::beginPlot(QPaintDevice *device, const QRectF &target,
+  qreal scale, Flags flags)
 {
 	QRect orig;
 	qreal ratio, diff, q, p;
-	QPointF scenePos, scalePos, posPos, motionPos;
-	bool hidpi = _hidpi && _deviceRatio > 1.0;
-	int zoom;
 
 
 	// Enter plot mode
 	setUpdatesEnabled(false);
 	_plot = true;
+	_plotTarget = target;
+	_plotFlags = flags;
+	_plotHidpi = _hidpi && _deviceRatio > 1.0;
+	_heatmap->setBlockingRender(true);
 
 	// Compute sizes & ratios
 	orig = viewport()->rect();
 	QRectF adj(orig);
-	scalePos = _mapScale->pos();
-	posPos = _positionCoordinates->pos();
-	motionPos = _motionInfo->pos();
+	_plotScalePos = _mapScale->pos();
+	_plotPosPos = _positionCoordinates->pos();
+	_plotMotionPos = _motionInfo->pos();
 
 	if (orig.height() * (target.width() / target.height()) - orig.width() < 0) {
 		ratio = target.height() / target.width();
@@ -711,7 +791,7 @@ void MapView::plot(QPainter *painter, const QRectF &target, qreal scale,
 	}
 
 	// Expand the view if plotting into a bitmap
-	if (hidpi)
+	if (_plotHidpi)
 		setHidpi(false);
 
 	if (flags & Expand) {
@@ -724,13 +804,13 @@ void MapView::plot(QPainter *painter, const QRectF &target, qreal scale,
 
 	// Adjust the view for printing
 	if (flags & HiRes) {
-		zoom = _map->zoom();
+		_plotZoom = _map->zoom();
 		QRectF vr(mapToScene(orig).boundingRect());
-		scenePos = vr.center();
+		_plotScenePos = vr.center();
 
-		QPointF s(painter->device()->logicalDpiX()
+		QPointF s(device->logicalDpiX()
 		  / (qreal)metric(QPaintDevice::PdmDpiX),
-		  painter->device()->logicalDpiY()
+		  device->logicalDpiY()
 		  / (qreal)metric(QPaintDevice::PdmDpiY));
 		adj = QRectF(0, 0, adj.width() * s.x(), adj.height() * s.y());
 		_map->zoomFit(adj.size().toSize(), _tr | _rr | _wr | _ar);
@@ -757,33 +837,67 @@ void MapView::plot(QPainter *painter, const QRectF &target, qreal scale,
 	  (-COORDINATES_OFFSET - _motionInfo->boundingRect().width()) * p,
 	  (COORDINATES_OFFSET + _motionInfo->boundingRect().height()) * p)));
 
+	_plotSource = adj.toRect();
+}
+
+void MapView::plotStrip(QPainter *painter, const QRectF &clip)
+{
+	QRectF tr(_plotTarget.intersected(clip));
+	if (tr.isEmpty())
+		return;
+
 	// Print the view
-	render(painter, target, adj.toRect());
+	if (tr == _plotTarget) {
+		render(painter, _plotTarget, _plotSource);
+		return;
+	}
 
+	/* Render only the source rows of the strip (plus one row on each side
+	   for the antialiasing) so that the map is drawn for the strip only */
+	qreal sy = _plotSource.height() / _plotTarget.height();
+	int top = qMax(_plotSource.top(), (int)floor(_plotSource.top()
+	  + (tr.top() - _plotTarget.top()) * sy) - 1);
+	int bottom = qMin(_plotSource.top() + _plotSource.height(),
+	  (int)ceil(_plotSource.top() + (tr.bottom() - _plotTarget.top()) * sy) + 1);
+	QRect src(_plotSource.left(), top, _plotSource.width(), bottom - top);
+	QRectF dst(_plotTarget.left(), _plotTarget.top() + (top
+	  - _plotSource.top()) / sy, _plotTarget.width(), src.height() / sy);
+
+	painter->save();
+	painter->setClipRect(tr, Qt::IntersectClip);
+	render(painter, dst, src, Qt::IgnoreAspectRatio);
+	painter->restore();
+}
+
+void MapView::endPlot()
+{
 	// Revert view changes to display mode
-	if (flags & HiRes) {
-		_map->setZoom(zoom);
+	if (_plotFlags & HiRes) {
+		_map->setZoom(_plotZoom);
 		rescale();
-		centerOn(scenePos);
+		centerOn(_plotScenePos);
 	}
 
-	if (hidpi)
+	if (_plotHidpi)
 		setHidpi(true);
 
 	_mapScale->setDigitalZoom(_digitalZoom);
-	_mapScale->setPos(scalePos);
+	_mapScale->setPos(_plotScalePos);
 	_positionCoordinates->setDigitalZoom(_digitalZoom);
-	_positionCoordinates->setPos(posPos);
+	_positionCoordinates->setPos(_plotPosPos);
 	_motionInfo->setDigitalZoom(_digitalZoom);
-	_motionInfo->setPos(motionPos);
+	_motionInfo->setPos(_plotMotionPos);
 
 	// Exit plot mode
+	_heatmap->setBlockingRender(false);
 	_plot = false;
 	setUpdatesEnabled(true);
 }
 
 void MapView::clear()
 {
+	deleteHeatmapTracks();
+
 	_pois.clear();
 	_tracks.clear();
 	_routes.clear();
@@ -795,12 +909,17 @@ void MapView::clear()
 	_scene->removeItem(_positionCoordinates);
 	_scene->removeItem(_crosshair);
 	_scene->removeItem(_motionInfo);
+	_scene->removeItem(_heatmap);
 	_scene->clear();
 	_scene->addItem(_mapScale);
 	_scene->addItem(_cursorCoordinates);
 	_scene->addItem(_positionCoordinates);
 	_scene->addItem(_crosshair);
 	_scene->addItem(_motionInfo);
+	_scene->addItem(_heatmap);
+
+	_heatmap->clear();
+	_heatmapPath = 0;
 
 	_palette.reset();
 
@@ -819,8 +938,14 @@ void MapView::showTracks(bool show)
 {
 	_showTracks = show;
 
-	for (int i = 0; i < _tracks.count(); i++)
-		_tracks.at(i)->setVisible(show);
+	if (_useHeatmap) {
+		_heatmap->setVisible(show);
+		if (_heatmapPath)
+			_heatmapPath->setVisible(show);
+	} else {
+		for (int i = 0; i < _tracks.count(); i++)
+			_tracks.at(i)->setVisible(show);
+	}
 
 	updatePOI();
 }
@@ -991,6 +1116,7 @@ void MapView::setTrackWidth(int width)
 
 	for (int i = 0; i < _tracks.count(); i++)
 		_tracks.at(i)->setWidth(width);
+	_heatmap->setWidth(width);
 }
 
 void MapView::setRouteWidth(int width)
@@ -1096,34 +1222,85 @@ void MapView::setBackgroundColor(const QColor &color)
 	reloadMap();
 }
 
+static Map::Flags layerFlags(bool hillShading, MapView::Layers layers)
+{
+	Map::Flags flags = Map::NoFlags;
+
+	if (hillShading)
+		flags |= Map::HillShading;
+	if (layers & MapView::Layer::Raster)
+		flags |= Map::Rasters;
+	if (layers & MapView::Layer::Vector)
+		flags |= Map::Vectors;
+
+	return flags;
+}
+
 void MapView::drawBackground(QPainter *painter, const QRectF &rect)
 {
 	painter->fillRect(rect, _backgroundColor);
 
 	if (_showMap) {
 		QRectF ir = rect.intersected(_map->bounds());
-		Map::Flags flags = Map::NoFlags;
+		Map::Flags flags = layerFlags(_hillShading, _layers);
 
 		if (_mapOpacity < 1.0)
 			painter->setOpacity(_mapOpacity);
 
 		if (_plot)
-			flags = Map::Block;
+			flags |= Map::Block;
 		else if (_opengl)
-			flags = Map::OpenGL;
-		if (_hillShading)
-			flags |= Map::HillShading;
-		if (_layers & Layer::Raster)
-			flags |= Map::Rasters;
-		if (_layers & Layer::Vector)
-			flags |= Map::Vectors;
-
-		_map->draw(painter, ir, flags);
+			flags |= Map::OpenGL;
+
+		TRACE_SCOPE("Map::draw");
+		if (_plot && ir.height() > PLOT_STRIP) {
+			/* Big (printer) outputs are drawn in strips to bound the memory
+			   of the blocking map rendering */
+			for (qreal y = ir.top(); y < ir.bottom(); y += PLOT_STRIP) {
+				QRectF sr(ir.left(), y, ir.width(),
+				  qMin((qreal)PLOT_STRIP, ir.bottom() - y));
+				painter->save();
+				painter->setClipRect(sr, Qt::IntersectClip);
+				_map->draw(painter, sr, flags);
+				painter->restore();
+			}
+		} else
+			_map->draw(painter, ir, flags);
+
+		/* Every repaint postpones the render-ahead until the view is idle */
+		if (!_plot && Prefetch::ring())
+			_prefetchTimer->start();
+	}
+}
+
+void MapView::prefetch()
+{
+	if (!_showMap || _digitalZoom || _plot)
+		return;
+
+	QRectF vr(mapToScene(viewport()->rect()).boundingRect());
+	/* Prefetch each view only once, otherwise the prefetched tiles could
+	   push each other out of a too small pixmap cache forever */
+	if (vr == _prefetchRect && _map->zoom() == _prefetchZoom)
+		return;
+
+	Map::Flags flags = layerFlags(_hillShading, _layers);
+	if (_opengl)
+		flags |= Map::OpenGL;
+
+	if (_map->prefetch(vr, flags)) {
+		_prefetchRect = vr;
+		_prefetchZoom = _map->zoom();
 	}
 }
 
 void MapView::paintEvent(QPaintEvent *event)
 {
+#ifdef ENABLE_TRACE
+	qint64 start = Trace::now();
+#endif // ENABLE_TRACE
+	TRACE_SCOPE("MapView::paintEvent");
+
 	if (!_plot) {
 		QPointF scaleScenePos = mapToScene(rect().bottomRight() + QPoint(
 		  -(SCALE_OFFSET + _mapScale->boundingRect().width()),
@@ -1156,7 +1333,32 @@ void MapView::paintEvent(QPaintEvent *event)
 	}
 
 	QGraphicsView::paintEvent(event);
+
+#ifdef ENABLE_TRACE
+	if (Trace::isEnabled() && !_plot)
+		drawTraceOverlay(Trace::now() - start);
+#endif // ENABLE_TRACE
+}
+
+#ifdef ENABLE_TRACE
+/* Shows the last frame time and the number of pending render jobs and
+   queued/running tile downloads */
+void MapView::drawTraceOverlay(qint64 frameTime)
+{
+	QPainter painter(viewport());
+	QString text(QString("%1 ms | %2 jobs | %3/%4 downloads")
+	  .arg(frameTime / 1000.0, 0, 'f', 1).arg(Trace::value("render jobs"))
+	  .arg(Trace::value("download queue"))
+	  .arg(Trace::value("downloads running")));
+	QRect br(painter.fontMetrics().boundingRect(text).adjusted(-4, -2, 4, 2));
+
+	br.moveTopLeft(QPoint((viewport()->width() - br.width()) / 2,
+	  COORDINATES_OFFSET));
+	painter.fillRect(br, QColor(255, 255, 255, 192));
+	painter.setPen(Qt::black);
+	painter.drawText(br, Qt::AlignCenter, text);
 }
+#endif // ENABLE_TRACE
 
 void MapView::scrollContentsBy(int dx, int dy)
 {
@@ -1275,6 +1477,57 @@ void MapView::useStyles(bool use)
 		_waypoints.at(i)->updateStyle();
 }
 
+void MapView::useHeatmap(bool use)
+{
+	if (_useHeatmap == use)
+		return;
+
+	_useHeatmap = use;
+	_heatmapPath = 0;
+	_heatmap->clear();
+
+	if (use) {
+		for (int i = 0; i < _tracks.size(); i++) {
+			_scene->removeItem(_tracks.at(i));
+			_heatmap->addPath(_tracks.at(i));
+		}
+		_heatmap->setMap(_map);
+		_heatmap->setVisible(_showTracks);
+	} else {
+		_heatmap->setVisible(false);
+		for (int i = 0; i < _tracks.size(); i++) {
+			TrackItem *ti = _tracks.at(i);
+			ti->setMap(_map);
+			ti->setVisible(_showTracks);
+			if (!ti->scene())
+				_scene->addItem(ti);
+		}
+	}
+}
+
+/* The track items removed from the scene in the heatmap mode are not deleted
+   with the scene items */
+void MapView::deleteHeatmapTracks()
+{
+	for (int i = 0; i < _tracks.size(); i++)
+		if (!_tracks.at(i)->scene())
+			delete _tracks.at(i);
+}
+
+void MapView::showHeatmapPath(PathItem *path)
+{
+	if (_heatmapPath)
+		_scene->removeItem(_heatmapPath);
+
+	_heatmapPath = path;
+
+	if (_heatmapPath) {
+		_heatmapPath->setMap(_map);
+		_heatmapPath->setVisible(_showTracks);
+		_scene->addItem(_heatmapPath);
+	}
+}
+
 void MapView::setMarkerColor(const QColor &color)
 {
 	_markerColor = color;
@@ -1340,6 +1593,27 @@ RectC MapView::boundingRect() const
 	return rect;
 }
 
+RectC MapView::visibleRect() const
+{
+	QRectF vr(mapToScene(viewport()->rect()).boundingRect());
+	return RectC(_map->xy2ll(vr.topLeft()), _map->xy2ll(vr.bottomRight()));
+}
+
+/* The area around the displayed tracks and routes */
+QList<RectC> MapView::corridor(qreal radius) const
+{
+	QList<RectC> rects;
+
+	if (_showTracks)
+		for (int i = 0; i < _tracks.size(); i++)
+			rects.append(Corridor(_tracks.at(i)->path(), radius).rects());
+	if (_showRoutes)
+		for (int i = 0; i < _routes.size(); i++)
+			rects.append(Corridor(_routes.at(i)->path(), radius).rects());
+
+	return rects;
+}
+
 void MapView::showPosition(bool show)
 {
 	_showPosition = show;
@@ -17,6 +17,7 @@
 #include "graphicsscene.h"
 
 
+class QTimer;
 class QGeoPositionInfoSource;
 class QGeoPositionInfo;
 class QGestureEvent;
@@ -40,6 +41,7 @@ class QTimeZone;
 class MapAction;
 class CrosshairItem;
 class MotionInfoItem;
+class HeatmapItem;
 
 class MapView : public QGraphicsView
 {
@@ -61,6 +63,7 @@ public:
 	Q_DECLARE_FLAGS(Layers, Layer)
 
 	MapView(Map *map, POI *poi, QWidget *parent = 0);
+	~MapView();
 
 	QList<PathItem *> loadData(const Data &data);
 	void loadMaps(const QList<MapAction*> &maps);
@@ -74,6 +77,13 @@ public:
 	void showExtendedInfo(bool show) {_scene->showExtendedInfo(show);}
 
 	void plot(QPainter *painter, const QRectF &target, qreal scale, Flags flags);
+	/* Strip-wise plotting of big outputs. The clip rects of the plotStrip()
+	   calls are in the painter coordinates of the target rect passed to
+	   beginPlot(), the painter may be a different one for every strip. */
+	void beginPlot(QPaintDevice *device, const QRectF &target, qreal scale,
+	  Flags flags);
+	void plotStrip(QPainter *painter, const QRectF &clip);
+	void endPlot();
 
 	void clear();
 
@@ -105,6 +115,8 @@ public:
 	void fitContentToSize();
 
 	RectC boundingRect() const;
+	RectC visibleRect() const;
+	QList<RectC> corridor(qreal radius) const;
 	const Projection &inputProjection() const {return _inputProjection;}
 
 #ifdef Q_OS_ANDROID
@@ -135,13 +147,16 @@ public slots:
 	void followPosition(bool follow);
 	void showMotionInfo(bool show);
 	void useStyles(bool use);
+	void useHeatmap(bool use);
 	void drawHillShading(bool draw);
 	void selectLayers(MapView::Layers layers);
 
 private slots:
 	void updatePOI();
 	void reloadMap();
+	void prefetch();
 	void updatePosition(const QGeoPositionInfo &pos);
+	void showHeatmapPath(PathItem *path);
 
 private:
 	typedef QHash<SearchPointer<Waypoint>, WaypointItem*> POIHash;
@@ -158,14 +173,19 @@ private:
 	int fitMapZoom() const;
 	QPointF contentCenter() const;
 	void rescale();
+	void projectItems();
 	void centerOn(const QPointF &pos);
 	void zoom(int zoom, const QPoint &pos, bool shift);
 	void digitalZoom(int zoom);
 	void updatePOIVisibility();
+	void deleteHeatmapTracks();
 	bool gestureEvent(QGestureEvent *event);
 	void pinchGesture(QPinchGesture *gesture);
 	void skipColor() {_palette.nextColor();}
 	void setHidpi(bool hidpi);
+#ifdef ENABLE_TRACE
+	void drawTraceOverlay(qint64 frameTime);
+#endif // ENABLE_TRACE
 
 	void mouseMoveEvent(QMouseEvent *event);
 	void mousePressEvent(QMouseEvent *event);
@@ -185,6 +205,8 @@ private:
 	CoordinatesItem *_cursorCoordinates, *_positionCoordinates;
 	CrosshairItem *_crosshair;
 	MotionInfoItem *_motionInfo;
+	HeatmapItem *_heatmap;
+	PathItem *_heatmapPath;
 	QList<TrackItem*> _tracks;
 	QList<RouteItem*> _routes;
 	QList<WaypointItem*> _waypoints;
@@ -207,7 +229,7 @@ private:
 	  _showMarkers, _showPathTicks, _showPOIIcons, _showWaypointIcons,
 	  _showPosition, _showPositionCoordinates, _showMotionInfo;
 	MarkerInfoItem::Type _markerInfoType;
-	bool _overlapPOIs, _followPosition;
+	bool _overlapPOIs, _followPosition, _useHeatmap;
 	int _trackWidth, _routeWidth, _areaWidth;
 	Qt::PenStyle _trackStyle, _routeStyle, _areaStyle;
 	int _waypointSize, _poiSize;
@@ -220,6 +242,12 @@ private:
 
 	int _digitalZoom;
 	bool _plot;
+	QRectF _plotTarget;
+	QRect _plotSource;
+	QPointF _plotScenePos, _plotScalePos, _plotPosPos, _plotMotionPos;
+	int _plotZoom;
+	bool _plotHidpi;
+	Flags _plotFlags;
 	QCursor _cursor;
 
 	qreal _deviceRatio;
@@ -228,6 +256,10 @@ private:
 
 	int _pinchZoom;
 	int _wheelDelta;
+
+	QTimer *_prefetchTimer;
+	QRectF _prefetchRect;
+	int _prefetchZoom;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(MapView::Layers)
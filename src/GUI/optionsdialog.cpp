@@ -785,6 +785,27 @@ QWidget *OptionsDialog::createSystemPage()
 	_demCache->setSuffix(UNIT_SPACE + tr("MB"));
 	_demCache->setValue(_options.demCache);
 
+	_dataCache = new QSpinBox();
+	_dataCache->setMinimum(64);
+	_dataCache->setMaximum(4096);
+	_dataCache->setSuffix(UNIT_SPACE + tr("MB"));
+	_dataCache->setValue(_options.dataCache);
+
+	_tileCache = new QSpinBox();
+	_tileCache->setMinimum(64);
+	_tileCache->setMaximum(65536);
+	_tileCache->setSuffix(UNIT_SPACE + tr("MB"));
+	_tileCache->setValue(_options.tileCache);
+
+	_prefetchRing = new QSpinBox();
+	_prefetchRing->setMinimum(0);
+	_prefetchRing->setMaximum(3);
+	_prefetchRing->setSpecialValueText(tr("Disabled"));
+	_prefetchRing->setSuffix(UNIT_SPACE + tr("tiles"));
+	_prefetchRing->setValue(_options.prefetchRing);
+	_prefetchRing->setToolTip(tr("Width of the area around the visible map "
+	  "area rendered in advance when the map is idle (vector maps only)."));
+
 	_connectionTimeout = new QSpinBox();
 	_connectionTimeout->setMinimum(30);
 	_connectionTimeout->setMaximum(120);
@@ -796,6 +817,9 @@ QWidget *OptionsDialog::createSystemPage()
 	QFormLayout *systemTabLayout = new QFormLayout();
 	systemTabLayout->addRow(tr("Image cache size:"), _pixmapCache);
 	systemTabLayout->addRow(tr("DEM cache size:"), _demCache);
+	systemTabLayout->addRow(tr("Map data cache size:"), _dataCache);
+	systemTabLayout->addRow(tr("Map tiles cache size:"), _tileCache);
+	systemTabLayout->addRow(tr("Render-ahead:"), _prefetchRing);
 	systemTabLayout->addRow(tr("Connection timeout:"), _connectionTimeout);
 	systemTabLayout->addWidget(_enableHTTP2);
 	systemTabLayout->addWidget(_useOpenGL);
@@ -804,6 +828,9 @@ QWidget *OptionsDialog::createSystemPage()
 	QFormLayout *formLayout = new QFormLayout();
 	formLayout->addRow(tr("Image cache size:"), _pixmapCache);
 	formLayout->addRow(tr("DEM cache size:"), _demCache);
+	formLayout->addRow(tr("Map data cache size:"), _dataCache);
+	formLayout->addRow(tr("Map tiles cache size:"), _tileCache);
+	formLayout->addRow(tr("Render-ahead:"), _prefetchRing);
 	formLayout->addRow(tr("Connection timeout:"), _connectionTimeout);
 	QFormLayout *checkboxLayout = new QFormLayout();
 	checkboxLayout->addWidget(_enableHTTP2);
@@ -1011,6 +1038,9 @@ void OptionsDialog::accept()
 	_options.enableHTTP2 = _enableHTTP2->isChecked();
 	_options.pixmapCache = _pixmapCache->value();
 	_options.demCache = _demCache->value();
+	_options.dataCache = _dataCache->value();
+	_options.tileCache = _tileCache->value();
+	_options.prefetchRing = _prefetchRing->value();
 	_options.connectionTimeout = _connectionTimeout->value();
 	_options.dataPath = _dataPath->dir();
 	_options.mapsPath = _mapsPath->dir();
@@ -87,6 +87,9 @@ struct Options {
 	bool enableHTTP2;
 	int pixmapCache;
 	int demCache;
+	int dataCache;
+	int tileCache;
+	int prefetchRing;
 	int connectionTimeout;
 	QString dataPath;
 	QString mapsPath;
@@ -197,6 +200,9 @@ private:
 	// System
 	QSpinBox *_pixmapCache;
 	QSpinBox *_demCache;
+	QSpinBox *_dataCache;
+	QSpinBox *_tileCache;
+	QSpinBox *_prefetchRing;
 	QSpinBox *_connectionTimeout;
 	QCheckBox *_useOpenGL;
 	QCheckBox *_enableHTTP2;
@@ -3,6 +3,8 @@
 #include <QPainter>
 #include <QGraphicsSceneMouseEvent>
 #include "common/greatcircle.h"
+#include "common/util.h"
+#include "common/trace.h"
 #include "map/map.h"
 #include "pathtickitem.h"
 #include "popup.h"
@@ -25,8 +27,44 @@ static inline unsigned segments(qreal distance)
 	return ceil(distance / GEOGRAPHICAL_MILE);
 }
 
+static bool intersects(const QLineF &line, const QRectF &rect)
+{
+	if (rect.contains(line.p1()) || rect.contains(line.p2()))
+		return true;
+
+	QLineF edges[] = {
+		QLineF(rect.topLeft(), rect.topRight()),
+		QLineF(rect.topRight(), rect.bottomRight()),
+		QLineF(rect.bottomRight(), rect.bottomLeft()),
+		QLineF(rect.bottomLeft(), rect.topLeft())
+	};
+	for (size_t i = 0; i < ARRAY_SIZE(edges); i++)
+		if (line.intersects(edges[i], 0) == QLineF::BoundedIntersection)
+			return true;
+
+	return false;
+}
+
+struct HitContext
+{
+	HitContext(const QVector<QLineF> &segments, const QRectF &rect)
+	  : segments(segments), rect(rect), hit(false) {}
+
+	const QVector<QLineF> &segments;
+	const QRectF &rect;
+	bool hit;
+};
+
+static bool hitCb(int data, void *context)
+{
+	HitContext *ctx = (HitContext*)context;
+	ctx->hit = intersects(ctx->segments.at(data), ctx->rect);
+
+	return !ctx->hit;
+}
+
 PathItem::PathItem(const Path &path, Map *map, QGraphicsItem *parent)
-  : GraphicsItem(parent), _path(path), _map(map), _graph(0)
+  : GraphicsItem(parent), _path(path), _map(map), _graph(0), _projected(false)
 {
 	Q_ASSERT(_path.isValid());
 
@@ -40,6 +78,7 @@ PathItem::PathItem(const Path &path, Map *map, QGraphicsItem *parent)
 
 	_pen = QPen(color(), width());
 
+	project(_map);
 	updatePainterPath();
 	updateShape();
 	updateTicks();
@@ -55,14 +94,82 @@ PathItem::PathItem(const Path &path, Map *map, QGraphicsItem *parent)
 	setAcceptHoverEvents(true);
 }
 
+/* Instead of stroking the (possibly huge) painter path, hit-testing is done
+   using a R-tree of the projected path segments and a width tolerance. */
 void PathItem::updateShape()
 {
-	QPainterPathStroker s;
-	s.setWidth((_width + 1) * pow(2, -_digitalZoom));
-	_shape = s.createStroke(_painterPath);
+	_tolerance = (_width + 1) * pow(2, -_digitalZoom) / 2.0;
+	_boundingRect = _painterPath.boundingRect().adjusted(-_tolerance,
+	  -_tolerance, _tolerance, _tolerance);
+}
+
+void PathItem::updateSegmentIndex()
+{
+	qreal min[2], max[2];
+
+	_projectedTree.RemoveAll();
+	_projectedSegments.clear();
+
+	for (int i = 1; i < _projectedPath.elementCount(); i++) {
+		const QPainterPath::Element &e = _projectedPath.elementAt(i);
+		if (!e.isLineTo())
+			continue;
+		const QPainterPath::Element &pe = _projectedPath.elementAt(i - 1);
+
+		QLineF l(pe.x, pe.y, e.x, e.y);
+		min[0] = qMin(l.x1(), l.x2());
+		min[1] = qMin(l.y1(), l.y2());
+		max[0] = qMax(l.x1(), l.x2());
+		max[1] = qMax(l.y1(), l.y2());
+
+		_projectedTree.Insert(min, max, _projectedSegments.size());
+		_projectedSegments.append(l);
+	}
 }
 
-bool PathItem::addSegment(const Coordinates &c1, const Coordinates &c2)
+bool PathItem::hit(const QRectF &rect) const
+{
+	QRectF r(rect.normalized().adjusted(-_tolerance, -_tolerance, _tolerance,
+	  _tolerance));
+	qreal min[2], max[2];
+
+	if (!r.intersects(_boundingRect))
+		return false;
+
+	min[0] = r.left();
+	min[1] = r.top();
+	max[0] = r.right();
+	max[1] = r.bottom();
+
+	HitContext ctx(_segments, r);
+	_segmentTree.Search(min, max, hitCb, &ctx);
+
+	return ctx.hit;
+}
+
+QPainterPath PathItem::shape() const
+{
+	QPainterPath path;
+	path.addRect(_boundingRect);
+	return path;
+}
+
+bool PathItem::contains(const QPointF &point) const
+{
+	return hit(QRectF(point, point));
+}
+
+bool PathItem::collidesWithPath(const QPainterPath &path,
+  Qt::ItemSelectionMode mode) const
+{
+	if (mode == Qt::IntersectsItemShape)
+		return hit(path.boundingRect());
+	else
+		return GraphicsItem::collidesWithPath(path, mode);
+}
+
+bool PathItem::addSegment(Map *map, const Coordinates &c1,
+  const Coordinates &c2)
 {
 	if (fabs(c1.lon() - c2.lon()) > 180.0) {
 		// Split segment on date line crossing
@@ -73,43 +180,49 @@ bool PathItem::addSegment(const Coordinates &c1, const Coordinates &c2)
 			  c2.lat()));
 			QLineF dl(QPointF(180, -90), QPointF(180, 90));
 			l.intersects(dl, &p);
-			_painterPath.lineTo(_map->ll2xy(Coordinates(180, p.y())));
-			_painterPath.moveTo(_map->ll2xy(Coordinates(-180, p.y())));
+			_projectedPath.lineTo(map->ll2xy(Coordinates(180, p.y())));
+			_projectedPath.moveTo(map->ll2xy(Coordinates(-180, p.y())));
 		} else {
 			QLineF l(QPointF(c1.lon(), c1.lat()), QPointF(c2.lon() - 360,
 			  c2.lat()));
 			QLineF dl(QPointF(-180, -90), QPointF(-180, 90));
 			l.intersects(dl, &p);
-			_painterPath.lineTo(_map->ll2xy(Coordinates(-180, p.y())));
-			_painterPath.moveTo(_map->ll2xy(Coordinates(180, p.y())));
+			_projectedPath.lineTo(map->ll2xy(Coordinates(-180, p.y())));
+			_projectedPath.moveTo(map->ll2xy(Coordinates(180, p.y())));
 		}
-		_painterPath.lineTo(_map->ll2xy(c2));
+		_projectedPath.lineTo(map->ll2xy(c2));
 
 		return true;
 	} else {
-		QPointF p(_map->ll2xy(c2));
-		const QPainterPath::Element &e = _painterPath.elementAt(
-		  _painterPath.elementCount() - 1);
+		QPointF p(map->ll2xy(c2));
+		const QPainterPath::Element &e = _projectedPath.elementAt(
+		  _projectedPath.elementCount() - 1);
 		qreal dx = qAbs(p.x() - e.x);
 		qreal dy = qAbs(p.y() - e.y);
 
 		if (dx >= 1.0 || dy >= 1.0) {
-			_painterPath.lineTo(p);
+			_projectedPath.lineTo(p);
 			return true;
 		} else
 			return false;
 	}
 }
 
-void PathItem::updatePainterPath()
+/* Computes the map dependent geometry (painter path & segment index) of the
+   item. The function does not touch the item's current geometry nor the scene
+   so it can be run on a worker thread for multiple items at once, provided
+   the map's ll2xy() is reentrant. The result is applied in setMap(). */
+void PathItem::project(Map *map)
 {
-	_painterPath = QPainterPath();
+	TRACE_SCOPE("PathItem::project");
+
+	_projectedPath = QPainterPath();
 
 	for (int i = 0; i < _path.size(); i++) {
 		const PathSegment &segment = _path.at(i);
 		const PathPoint *p1 = &segment.first();
 
-		_painterPath.moveTo(_map->ll2xy(p1->coordinates()));
+		_projectedPath.moveTo(map->ll2xy(p1->coordinates()));
 
 		for (int j = 1; j < segment.size(); j++) {
 			const PathPoint *p2 = &segment.at(j);
@@ -122,16 +235,34 @@ void PathItem::updatePainterPath()
 
 				for (unsigned k = 1; k <= n; k++) {
 					Coordinates c(gc.pointAt(k/(double)n));
-					addSegment(last, c);
+					addSegment(map, last, c);
 					last = c;
 				}
 				p1 = p2;
 			} else {
-				if (addSegment(p1->coordinates(), p2->coordinates()))
+				if (addSegment(map, p1->coordinates(), p2->coordinates()))
 					p1 = p2;
 			}
 		}
 	}
+
+	updateSegmentIndex();
+
+	_projected = true;
+}
+
+void PathItem::updatePainterPath()
+{
+	Q_ASSERT(_projected);
+
+	_painterPath.swap(_projectedPath);
+	_projectedPath = QPainterPath();
+	_segments.swap(_projectedSegments);
+	_projectedSegments.clear();
+	_segmentTree.Swap(_projectedTree);
+	_projectedTree.RemoveAll();
+
+	_projected = false;
 }
 
 void PathItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
@@ -155,6 +286,8 @@ void PathItem::setMap(Map *map)
 
 	_map = map;
 
+	if (!_projected)
+		project(map);
 	updatePainterPath();
 	updateShape();
 	updateTicks();
@@ -3,6 +3,7 @@
 
 #include <QPen>
 #include <QTimeZone>
+#include "common/rtree.h"
 #include "data/path.h"
 #include "graphicsscene.h"
 #include "markerinfoitem.h"
@@ -22,8 +23,11 @@ public:
 	PathItem(const Path &path, Map *map, QGraphicsItem *parent = 0);
 	virtual ~PathItem() {}
 
-	QPainterPath shape() const {return _shape;}
-	QRectF boundingRect() const {return _shape.boundingRect();}
+	QPainterPath shape() const;
+	QRectF boundingRect() const {return _boundingRect;}
+	bool contains(const QPointF &point) const;
+	bool collidesWithPath(const QPainterPath &path,
+	  Qt::ItemSelectionMode mode = Qt::IntersectsItemShape) const;
 	void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
 	  QWidget *widget);
 
@@ -33,6 +37,7 @@ public:
 
 	void addGraph(GraphItem *graph);
 
+	void project(Map *map);
 	void setMap(Map *map);
 	void setGraph(int index);
 
@@ -71,11 +76,15 @@ protected:
 	static QTimeZone _timeZone;
 
 private:
+	typedef RTree<int, qreal, 2> SegmentTree;
+
 	const PathSegment *segment(qreal x) const;
+	bool hit(const QRectF &rect) const;
 	QPointF position(qreal distance) const;
 	void updatePainterPath();
 	void updateShape();
-	bool addSegment(const Coordinates &c1, const Coordinates &c2);
+	void updateSegmentIndex();
+	bool addSegment(Map *map, const Coordinates &c1, const Coordinates &c2);
 	void setMarkerInfo(qreal pos);
 	void updateColor();
 	void updateWidth();
@@ -97,8 +106,15 @@ private:
 	QVector<PathTickItem*> _ticks;
 
 	QPen _pen;
-	QPainterPath _shape;
 	QPainterPath _painterPath;
+	QVector<QLineF> _segments;
+	SegmentTree _segmentTree;
+	QPainterPath _projectedPath;
+	QVector<QLineF> _projectedSegments;
+	SegmentTree _projectedTree;
+	bool _projected;
+	QRectF _boundingRect;
+	qreal _tolerance;
 
 	qreal _width;
 	QColor _color;
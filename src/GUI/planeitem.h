@@ -13,6 +13,7 @@ public:
 
 	virtual RectC bounds() const = 0;
 	virtual void setMap(Map *map) = 0;
+	virtual void project(Map *map) {Q_UNUSED(map);}
 
 	virtual void setColor(const QColor &color) = 0;
 	virtual void setOpacity(qreal opacity) = 0;
@@ -0,0 +1,341 @@
+#include <cstring>
+#include <QImage>
+#include <QtEndian>
+#include "pngwriter.h"
+
+#define IDAT_SIZE  65536
+#define WSIZE      32768
+#define WMASK      (WSIZE - 1)
+#define HASH_BITS  15
+#define HASH_SIZE  (1 << HASH_BITS)
+#define MIN_MATCH  3
+#define MAX_MATCH  258
+#define MAX_CHAIN  16
+#define ADLER_MOD  65521
+#define ADLER_NMAX 5552
+
+static const quint16 lengthBase[] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17,
+  19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const quint8 lengthExtra[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2,
+  2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const quint16 distBase[] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65,
+  97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193,
+  12289, 16385, 24577};
+static const quint8 distExtra[] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5,
+  6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+static quint32 reverse(quint32 code, int bits)
+{
+	quint32 r = 0;
+
+	for (int i = 0; i < bits; i++) {
+		r = (r << 1) | (code & 1);
+		code >>= 1;
+	}
+
+	return r;
+}
+
+struct CRCTable
+{
+	CRCTable()
+	{
+		for (quint32 n = 0; n < 256; n++) {
+			quint32 c = n;
+			for (int k = 0; k < 8; k++)
+				c = (c & 1) ? 0xEDB88320U ^ (c >> 1) : c >> 1;
+			table[n] = c;
+		}
+	}
+
+	quint32 table[256];
+};
+
+static quint32 crc32(const char *data, int size, quint32 crc = 0)
+{
+	static const CRCTable t;
+
+	crc = ~crc;
+	for (int i = 0; i < size; i++)
+		crc = t.table[(crc ^ (quint8)data[i]) & 0xFF] ^ (crc >> 8);
+
+	return ~crc;
+}
+
+static int hash(const uchar *p)
+{
+	return ((p[0] << 10) ^ (p[1] << 5) ^ p[2]) & (HASH_SIZE - 1);
+}
+
+/* Deflate (RFC 1951) compressor in a zlib (RFC 1950) envelope. All the data
+   is encoded using the fixed Huffman codes in a single block that spans all
+   the compress() calls, matches are found using hash chains over the last
+   32KB of the data. */
+PNGWriter::Deflate::Deflate() : _total(0), _head(HASH_SIZE, -1),
+  _prev(WSIZE, -1), _bitBuf(0), _bitCnt(0), _a(1), _b(0)
+{
+}
+
+void PNGWriter::Deflate::putBits(quint32 value, int bits, QByteArray &out)
+{
+	_bitBuf |= value << _bitCnt;
+	_bitCnt += bits;
+
+	while (_bitCnt >= 8) {
+		out.append((char)(_bitBuf & 0xFF));
+		_bitBuf >>= 8;
+		_bitCnt -= 8;
+	}
+}
+
+void PNGWriter::Deflate::putSymbol(int symbol, QByteArray &out)
+{
+	if (symbol < 144)
+		putBits(reverse(0x30 + symbol, 8), 8, out);
+	else if (symbol < 256)
+		putBits(reverse(0x190 + symbol - 144, 9), 9, out);
+	else if (symbol < 280)
+		putBits(reverse(symbol - 256, 7), 7, out);
+	else
+		putBits(reverse(0xC0 + symbol - 280, 8), 8, out);
+}
+
+void PNGWriter::Deflate::putMatch(int length, int distance, QByteArray &out)
+{
+	int lc = 28;
+	while (lengthBase[lc] > length)
+		lc--;
+	putSymbol(257 + lc, out);
+	if (lengthExtra[lc])
+		putBits(length - lengthBase[lc], lengthExtra[lc], out);
+
+	int dc = 29;
+	while (distBase[dc] > distance)
+		dc--;
+	putBits(reverse(dc, 5), 5, out);
+	if (distExtra[dc])
+		putBits(distance - distBase[dc], distExtra[dc], out);
+}
+
+void PNGWriter::Deflate::insert(qint64 pos, int hash)
+{
+	_prev[pos & WMASK] = _head.at(hash);
+	_head[hash] = pos;
+}
+
+void PNGWriter::Deflate::compress(const QByteArray &data, QByteArray &out)
+{
+	if (!_total) {
+		/* zlib header (deflate, 32KB window) + fixed Huffman block header */
+		out.append((char)0x78);
+		out.append((char)0x01);
+		putBits(0, 1, out);
+		putBits(1, 2, out);
+	}
+
+	const uchar *d = (const uchar*)data.constData();
+	for (int n = data.size(); n > 0; ) {
+		int k = qMin(n, ADLER_NMAX);
+		n -= k;
+		while (k--) {
+			_a += *d++;
+			_b += _a;
+		}
+		_a %= ADLER_MOD;
+		_b %= ADLER_MOD;
+	}
+
+	int start = _window.size();
+	qint64 base = _total - start;
+	_window.append(data);
+	const uchar *w = (const uchar*)_window.constData();
+	int size = _window.size();
+
+	int i = start;
+	while (i < size) {
+		int bestLen = 0, bestDist = 0;
+
+		if (i + MIN_MATCH <= size) {
+			int h = hash(w + i);
+			qint64 pos = base + i;
+			qint64 cand = _head.at(h);
+			int maxLen = qMin(MAX_MATCH, size - i);
+
+			for (int chain = 0; chain < MAX_CHAIN && cand >= 0
+			  && pos - cand <= WSIZE; chain++) {
+				const uchar *c = w + (cand - base);
+				if (c[bestLen] == w[i + bestLen]) {
+					int len = 0;
+					while (len < maxLen && c[len] == w[i + len])
+						len++;
+					if (len > bestLen) {
+						bestLen = len;
+						bestDist = (int)(pos - cand);
+						if (len == maxLen)
+							break;
+					}
+				}
+
+				qint64 next = _prev.at(cand & WMASK);
+				if (next >= cand)
+					break;
+				cand = next;
+			}
+
+			insert(pos, h);
+		}
+
+		if (bestLen >= MIN_MATCH) {
+			putMatch(bestLen, bestDist, out);
+			for (int j = 1; j < bestLen; j++)
+				if (i + j + MIN_MATCH <= size)
+					insert(base + i + j, hash(w + i + j));
+			i += bestLen;
+		} else {
+			putSymbol(w[i], out);
+			i++;
+		}
+	}
+
+	_total += data.size();
+	if (_window.size() > WSIZE)
+		_window = _window.right(WSIZE);
+}
+
+void PNGWriter::Deflate::finish(QByteArray &out)
+{
+	if (!_total)
+		compress(QByteArray(), out);
+
+	/* End of the data block followed by an empty final block */
+	putSymbol(256, out);
+	putBits(1, 1, out);
+	putBits(1, 2, out);
+	putSymbol(256, out);
+	if (_bitCnt)
+		putBits(0, 8 - _bitCnt, out);
+
+	quint32 adler = (_b << 16) | _a;
+	char be[4];
+	qToBigEndian(adler, (uchar*)be);
+	out.append(be, 4);
+}
+
+
+PNGWriter::PNGWriter(const QString &fileName, const QSize &size)
+  : _file(fileName), _size(size), _rows(0)
+{
+}
+
+bool PNGWriter::writeChunk(const char *type, const QByteArray &data)
+{
+	char len[4];
+	qToBigEndian((quint32)data.size(), (uchar*)len);
+	char crc[4];
+	qToBigEndian(crc32(data.constData(), data.size(), crc32(type, 4)),
+	  (uchar*)crc);
+
+	return (_file.write(len, 4) == 4 && _file.write(type, 4) == 4
+	  && _file.write(data) == data.size() && _file.write(crc, 4) == 4);
+}
+
+bool PNGWriter::open()
+{
+	static const char signature[] = {(char)0x89, 'P', 'N', 'G', '\r', '\n',
+	  0x1A, '\n'};
+
+	if (!_file.open(QIODevice::WriteOnly))
+		return false;
+	if (_file.write(signature, sizeof(signature)) != sizeof(signature))
+		return false;
+
+	QByteArray ihdr(13, 0);
+	qToBigEndian((quint32)_size.width(), (uchar*)ihdr.data());
+	qToBigEndian((quint32)_size.height(), (uchar*)ihdr.data() + 4);
+	ihdr[8] = 8;
+	ihdr[9] = 2;
+
+	_prevRow = QByteArray(_size.width() * 3, 0);
+
+	return writeChunk("IHDR", ihdr);
+}
+
+/* Picks the filter with the minimal sum of absolute differences, which is
+   the libpng heuristic restricted to the cheap None/Sub/Up filters */
+void PNGWriter::filterRow(const uchar *row, QByteArray &out)
+{
+	int size = _size.width() * 3;
+	const uchar *up = (const uchar*)_prevRow.constData();
+	qint64 sum[3] = {0, 0, 0};
+
+	for (int i = 0; i < size; i++) {
+		sum[0] += (qint8)row[i] < 0 ? -(qint8)row[i] : (qint8)row[i];
+		qint8 s = (qint8)(row[i] - (i >= 3 ? row[i - 3] : 0));
+		sum[1] += s < 0 ? -s : s;
+		qint8 u = (qint8)(row[i] - up[i]);
+		sum[2] += u < 0 ? -u : u;
+	}
+
+	int filter = 0;
+	for (int f = 1; f < 3; f++)
+		if (sum[f] < sum[filter])
+			filter = f;
+
+	int offset = out.size();
+	out.resize(offset + size + 1);
+	uchar *o = (uchar*)out.data() + offset;
+
+	*o++ = filter;
+	for (int i = 0; i < size; i++) {
+		if (filter == 0)
+			o[i] = row[i];
+		else if (filter == 1)
+			o[i] = row[i] - (i >= 3 ? row[i - 3] : 0);
+		else
+			o[i] = row[i] - up[i];
+	}
+
+	memcpy(_prevRow.data(), row, size);
+}
+
+bool PNGWriter::write(const QImage &strip)
+{
+	Q_ASSERT(strip.width() == _size.width());
+
+	QImage rgb(strip.convertToFormat(QImage::Format_RGB888));
+	int rows = qMin(rgb.height(), _size.height() - _rows);
+	QByteArray data;
+
+	data.reserve(rows * (_size.width() * 3 + 1));
+	for (int i = 0; i < rows; i++)
+		filterRow(rgb.constScanLine(i), data);
+	_rows += rows;
+
+	_deflate.compress(data, _idat);
+	while (_idat.size() >= IDAT_SIZE) {
+		if (!writeChunk("IDAT", _idat.left(IDAT_SIZE)))
+			return false;
+		_idat.remove(0, IDAT_SIZE);
+	}
+
+	return true;
+}
+
+bool PNGWriter::close()
+{
+	bool ret = true;
+
+	if (_rows < _size.height()) {
+		QImage blank(_size.width(), _size.height() - _rows,
+		  QImage::Format_RGB888);
+		blank.fill(Qt::white);
+		ret = write(blank);
+	}
+
+	_deflate.finish(_idat);
+	ret = ret && writeChunk("IDAT", _idat) && writeChunk("IEND", QByteArray());
+	_idat.clear();
+	_file.close();
+
+	return ret && _file.error() == QFileDevice::NoError;
+}
@@ -0,0 +1,63 @@
+#ifndef PNGWRITER_H
+#define PNGWRITER_H
+
+#include <QFile>
+#include <QSize>
+#include <QVector>
+#include <QByteArray>
+
+class QImage;
+
+/* Streaming PNG encoder. The image is passed in horizontal strips of rows
+   that are compressed and written out right away, so the memory usage does
+   not depend on the image size. Opaque 8bit RGB images only. The encoder uses
+   the fixed Huffman codes only, so the files are bigger than the ones written
+   by QImage::save() and it should be used for images that do not fit into
+   memory only. */
+class PNGWriter
+{
+public:
+	PNGWriter(const QString &fileName, const QSize &size);
+
+	bool open();
+	/* The strips must be of the image width and are written top-down */
+	bool write(const QImage &strip);
+	bool close();
+
+	QString errorString() const {return _file.errorString();}
+
+private:
+	class Deflate
+	{
+	public:
+		Deflate();
+
+		void compress(const QByteArray &data, QByteArray &out);
+		void finish(QByteArray &out);
+
+	private:
+		void putBits(quint32 value, int bits, QByteArray &out);
+		void putSymbol(int symbol, QByteArray &out);
+		void putMatch(int length, int distance, QByteArray &out);
+		void insert(qint64 pos, int hash);
+
+		QByteArray _window;
+		qint64 _total;
+		QVector<qint64> _head, _prev;
+		quint32 _bitBuf;
+		int _bitCnt;
+		quint32 _a, _b;
+	};
+
+	bool writeChunk(const char *type, const QByteArray &data);
+	void filterRow(const uchar *row, QByteArray &out);
+
+	QFile _file;
+	QSize _size;
+	int _rows;
+	QByteArray _prevRow;
+	QByteArray _idat;
+	Deflate _deflate;
+};
+
+#endif // PNGWRITER_H
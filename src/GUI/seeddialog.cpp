@@ -0,0 +1,126 @@
+#include <QVBoxLayout>
+#include <QFormLayout>
+#include <QDialogButtonBox>
+#include <QGroupBox>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QCheckBox>
+#include "seeddialog.h"
+
+
+SeedDialog::SeedDialog(MapSeed &seed, const Range &zooms, bool data, bool dem,
+  Units units, QWidget *parent) : QDialog(parent), _seed(seed), _units(units)
+{
+#ifdef Q_OS_ANDROID
+	setWindowFlags(Qt::Window);
+	setWindowState(Qt::WindowFullScreen);
+#endif /* Q_OS_ANDROID */
+
+	_area = new QComboBox();
+	_area->addItem(tr("Visible area"), QVariant(MapSeed::View));
+	if (data) {
+		_area->addItem(tr("Data bounds"), QVariant(MapSeed::Data));
+		_area->addItem(tr("Data corridor"), QVariant(MapSeed::Corridor));
+	}
+	_area->setCurrentIndex(_area->findData(QVariant(_seed.area)));
+	if (_area->currentIndex() < 0)
+		_area->setCurrentIndex(0);
+
+	_radius = new QDoubleSpinBox();
+	_radius->setSingleStep(1);
+	_radius->setDecimals(1);
+	_radius->setMinimum(0.1);
+	if (_units == Imperial) {
+		_radius->setValue(_seed.radius / MIINM);
+		_radius->setSuffix(UNIT_SPACE + tr("mi"));
+	} else if (_units == Nautical) {
+		_radius->setValue(_seed.radius / NMIINM);
+		_radius->setSuffix(UNIT_SPACE + tr("nmi"));
+	} else {
+		_radius->setValue(_seed.radius / KMINM);
+		_radius->setSuffix(UNIT_SPACE + tr("km"));
+	}
+
+	_minZoom = new QSpinBox();
+	_minZoom->setRange(zooms.min(), zooms.max());
+	_minZoom->setValue(qBound(zooms.min(), _seed.zooms.min(), zooms.max()));
+	_maxZoom = new QSpinBox();
+	_maxZoom->setRange(zooms.min(), zooms.max());
+	_maxZoom->setValue(qBound(zooms.min(), _seed.zooms.max(), zooms.max()));
+
+	_dem = new QCheckBox(tr("Download DEM"));
+	_dem->setChecked(dem && _seed.dem);
+	_dem->setEnabled(dem);
+
+	connect(_area, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+	  &SeedDialog::areaChanged);
+	connect(_minZoom, QOverload<int>::of(&QSpinBox::valueChanged), this,
+	  &SeedDialog::minZoomChanged);
+	connect(_maxZoom, QOverload<int>::of(&QSpinBox::valueChanged), this,
+	  &SeedDialog::maxZoomChanged);
+	areaChanged();
+
+#ifndef Q_OS_MAC
+	QGroupBox *seedBox = new QGroupBox(tr("Offline area"));
+#endif // Q_OS_MAC
+	QFormLayout *seedLayout = new QFormLayout;
+	seedLayout->addRow(tr("Area:"), _area);
+	seedLayout->addRow(tr("Corridor radius:"), _radius);
+	seedLayout->addRow(tr("Min zoom:"), _minZoom);
+	seedLayout->addRow(tr("Max zoom:"), _maxZoom);
+	seedLayout->addWidget(_dem);
+#ifndef Q_OS_MAC
+	seedBox->setLayout(seedLayout);
+#endif // Q_OS_MAC
+
+	QDialogButtonBox *buttonBox = new QDialogButtonBox();
+	buttonBox->addButton(tr("Download"), QDialogButtonBox::AcceptRole);
+	buttonBox->addButton(QDialogButtonBox::Cancel);
+	connect(buttonBox, &QDialogButtonBox::accepted, this, &SeedDialog::accept);
+	connect(buttonBox, &QDialogButtonBox::rejected, this, &SeedDialog::reject);
+
+	QVBoxLayout *layout = new QVBoxLayout;
+#ifdef Q_OS_MAC
+	layout->addLayout(seedLayout);
+#else // Q_OS_MAC
+	layout->addWidget(seedBox);
+#ifdef Q_OS_ANDROID
+	layout->addStretch();
+#endif // Q_OS_ANDROID
+#endif // Q_OS_MAC
+	layout->addWidget(buttonBox);
+	setLayout(layout);
+
+	setWindowTitle(tr("Download Offline Area"));
+	setWindowFlags(windowFlags() & ~Qt::WindowContextHelpButtonHint);
+}
+
+void SeedDialog::areaChanged()
+{
+	_radius->setEnabled(_area->currentData().toInt() == MapSeed::Corridor);
+}
+
+void SeedDialog::minZoomChanged(int zoom)
+{
+	if (_maxZoom->value() < zoom)
+		_maxZoom->setValue(zoom);
+}
+
+void SeedDialog::maxZoomChanged(int zoom)
+{
+	if (_minZoom->value() > zoom)
+		_minZoom->setValue(zoom);
+}
+
+void SeedDialog::accept()
+{
+	_seed.area = (MapSeed::Area)_area->currentData().toInt();
+	_seed.zooms = Range(_minZoom->value(), _maxZoom->value());
+	_seed.radius = (_units == Imperial)
+	  ? _radius->value() * MIINM : (_units == Nautical)
+	  ? _radius->value() * NMIINM : _radius->value() * KMINM;
+	_seed.dem = _dem->isEnabled() && _dem->isChecked();
+
+	QDialog::accept();
+}
@@ -0,0 +1,54 @@
+#ifndef SEEDDIALOG_H
+#define SEEDDIALOG_H
+
+#include <QDialog>
+#include "common/range.h"
+#include "units.h"
+
+class QComboBox;
+class QSpinBox;
+class QDoubleSpinBox;
+class QCheckBox;
+
+struct MapSeed
+{
+	enum Area {
+		View,
+		Data,
+		Corridor
+	};
+
+	Area area;
+	Range zooms;
+	qreal radius;
+	bool dem;
+};
+
+class SeedDialog : public QDialog
+{
+	Q_OBJECT
+
+public:
+	SeedDialog(MapSeed &seed, const Range &zooms, bool data, bool dem,
+	  Units units, QWidget *parent = 0);
+
+public slots:
+	void accept();
+
+private slots:
+	void areaChanged();
+	void minZoomChanged(int zoom);
+	void maxZoomChanged(int zoom);
+
+private:
+	MapSeed &_seed;
+	Units _units;
+
+	QComboBox *_area;
+	QDoubleSpinBox *_radius;
+	QSpinBox *_minZoom;
+	QSpinBox *_maxZoom;
+	QCheckBox *_dem;
+};
+
+#endif // SEEDDIALOG_H
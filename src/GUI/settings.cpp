@@ -37,9 +37,15 @@
 #ifdef Q_OS_ANDROID
 #define PIXMAP_CACHE 384
 #define DEM_CACHE    128
+#define DATA_CACHE   256
+#define TILE_CACHE   512
+#define PREFETCH_RING 0
 #else // Q_OS_ANDROID
 #define PIXMAP_CACHE 512
 #define DEM_CACHE    256
+#define DATA_CACHE   512
+#define TILE_CACHE   2048
+#define PREFETCH_RING 1
 #endif // Q_OS_ANDROID
 
 
@@ -176,6 +182,7 @@ SETTING(pathTicks,           "pathTicks",              false                  );
 SETTING(positionMarkers,     "positionMarkers",        true                   );
 SETTING(markerInfo,          "markerInfo",             MarkerInfoItem::None   );
 SETTING(useStyles,           "styles",                 true                   );
+SETTING(trackHeatmap,        "trackHeatmap",           false                  );
 
 /* DEM */
 SETTING(drawHillShading,     "hillshading",            true                   );
@@ -259,6 +266,9 @@ SETTING(useOpenGL,           "useOpenGL",              false                  );
 SETTING(enableHTTP2,         "enableHTTP2",            true                   );
 SETTING(pixmapCache,         "pixmapCache",            PIXMAP_CACHE           );
 SETTING(demCache,            "demCache",               DEM_CACHE              );
+SETTING(dataCache,           "dataCache",              DATA_CACHE             );
+SETTING(tileCache,           "tileCache",              TILE_CACHE             );
+SETTING(prefetchRing,        "prefetchRing",           PREFETCH_RING          );
 SETTING(connectionTimeout,   "connectionTimeout",      30                     );
 SETTING(hiresPrint,          "hiresPrint",             false                  );
 SETTING(printName,           "printName",              true                   );
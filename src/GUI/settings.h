@@ -125,6 +125,7 @@ public:
 	static const Setting positionMarkers;
 	static const Setting markerInfo;
 	static const Setting useStyles;
+	static const Setting trackHeatmap;
 
 	/* DEM */
 	static const Setting drawHillShading;
@@ -208,6 +209,9 @@ public:
 	static const Setting enableHTTP2;
 	static const Setting pixmapCache;
 	static const Setting demCache;
+	static const Setting dataCache;
+	static const Setting tileCache;
+	static const Setting prefetchRing;
 	static const Setting connectionTimeout;
 	static const Setting hiresPrint;
 	static const Setting printName;
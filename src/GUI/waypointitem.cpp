@@ -74,7 +74,7 @@ ToolTip WaypointItem::info(bool extended) const
 }
 
 WaypointItem::WaypointItem(const Waypoint &waypoint, Map *map,
-  QGraphicsItem *parent) : GraphicsItem(parent), _map(map)
+  QGraphicsItem *parent) : GraphicsItem(parent), _map(map), _projected(false)
 {
 	_waypoint = waypoint;
 	_showLabel = false;
@@ -96,10 +96,18 @@ WaypointItem::WaypointItem(const Waypoint &waypoint, Map *map,
 	setAcceptHoverEvents(true);
 }
 
+/* Thread-safe part of setMap(), see PathItem::project() */
+void WaypointItem::project(Map *map)
+{
+	_projectedPos = map->ll2xy(_waypoint.coordinates());
+	_projected = true;
+}
+
 void WaypointItem::setMap(Map *map)
 {
 	_map = map;
-	setPos(map->ll2xy(_waypoint.coordinates()));
+	setPos(_projected ? _projectedPos : map->ll2xy(_waypoint.coordinates()));
+	_projected = false;
 }
 
 void WaypointItem::updateCache()
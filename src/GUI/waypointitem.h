@@ -17,6 +17,7 @@ public:
 
 	const Waypoint &waypoint() const {return _waypoint;}
 
+	void project(Map *map);
 	void setMap(Map *map);
 	void setSize(int size);
 	void setColor(const QColor &color);
@@ -52,6 +53,8 @@ private:
 	Waypoint _waypoint;
 
 	Map *_map;
+	QPointF _projectedPos;
+	bool _projected;
 
 	QColor _color;
 	int _size;
@@ -0,0 +1,40 @@
+#include "wgs84.h"
+#include "haversine.h"
+
+static inline double haversine(double dLat, double dLon, double cosLat1,
+  double cosLat2)
+{
+	double sLat = sin(dLat / 2.0);
+	double sLon = sin(dLon / 2.0);
+	double a = sLat * sLat + cosLat1 * cosLat2 * sLon * sLon;
+
+	return (WGS84_RADIUS * (2.0 * atan2(sqrt(a), sqrt(1.0 - a))));
+}
+
+double Haversine::distance(int i, int j) const
+{
+	return haversine(_lat.at(j) - _lat.at(i), _lon.at(j) - _lon.at(i),
+	  _cosLat.at(i), _cosLat.at(j));
+}
+
+/* Returns the distances between consecutive points, the first item is zero. */
+QVector<double> Haversine::distances() const
+{
+	int n = _lat.size();
+	QVector<double> ds(n);
+
+	if (!n)
+		return ds;
+
+	const double *lat = _lat.constData();
+	const double *lon = _lon.constData();
+	const double *cosLat = _cosLat.constData();
+	double *d = ds.data();
+
+	d[0] = 0;
+	for (int i = 1; i < n; i++)
+		d[i] = haversine(lat[i] - lat[i-1], lon[i] - lon[i-1], cosLat[i-1],
+		  cosLat[i]);
+
+	return ds;
+}
@@ -0,0 +1,42 @@
+#ifndef HAVERSINE_H
+#define HAVERSINE_H
+
+#include <QVector>
+#include "coordinates.h"
+
+/* Batch version of Coordinates::distanceTo() for point sequences. The point
+   coordinates are stored in separate contiguous arrays (in radians) together
+   with the precomputed cos(lat) values, so a distance costs two sin(), two
+   sqrt() and one atan2() call instead of the additional two cos() and pow()
+   calls of Coordinates::distanceTo(). */
+class Haversine
+{
+public:
+	template<class T> Haversine(const QVector<T> &points);
+
+	int size() const {return _lat.size();}
+
+	double distance(int i, int j) const;
+	QVector<double> distances() const;
+
+private:
+	QVector<double> _lat, _lon, _cosLat;
+};
+
+template<class T>
+Haversine::Haversine(const QVector<T> &points)
+  : _lat(points.size()), _lon(points.size()), _cosLat(points.size())
+{
+	for (int i = 0; i < points.size(); i++) {
+		const Coordinates &c = points.at(i).coordinates();
+		_lat[i] = deg2rad(c.lat());
+		_lon[i] = deg2rad(c.lon());
+	}
+
+	const double *lat = _lat.constData();
+	double *cosLat = _cosLat.data();
+	for (int i = 0; i < _lat.size(); i++)
+		cosLat[i] = cos(lat[i]);
+}
+
+#endif // HAVERSINE_H
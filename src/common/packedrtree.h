@@ -0,0 +1,235 @@
+#ifndef PACKEDRTREE_H
+#define PACKEDRTREE_H
+
+#include <cmath>
+#include <algorithm>
+#include <QVector>
+#include <QVarLengthArray>
+
+/* Read-only 2D R-tree for static data. The entries are collected with Insert()
+   and the tree is bulk loaded with Pack() using Sort-Tile-Recursive ordering.
+   All the nodes and entries are stored in two contiguous arrays, the tree
+   levels are stored bottom-up with the root being the last node.
+
+   The API mirrors the RTree Insert()/Search()/Count()/RemoveAll() calls
+   except of that the tree must be packed after the last Insert() and before
+   the first Search(). A packed tree can be searched from multiple threads at
+   once. BOUNDTYPE may be float to halve the bounds memory, the bounds are
+   then rounded outwards so no entries are ever missed. */
+template<class DATATYPE, class ELEMTYPE = double, class BOUNDTYPE = ELEMTYPE>
+class PackedRTree
+{
+public:
+	PackedRTree() : _leafNodes(0), _packed(true) {}
+
+	void Insert(const ELEMTYPE min[2], const ELEMTYPE max[2],
+	  const DATATYPE &data)
+	{
+		Entry entry;
+		entry.box = Box(min, max);
+		entry.data = data;
+		_entries.append(entry);
+
+		_packed = false;
+	}
+
+	void Pack()
+	{
+		_nodes.clear();
+		_leafNodes = 0;
+		_packed = true;
+
+		if (_entries.isEmpty())
+			return;
+
+		strSort(_entries.data(), _entries.data() + _entries.size());
+		for (int i = 0; i < _entries.size(); i += NODE_SIZE)
+			_nodes.append(node(_entries, i));
+		_leafNodes = _nodes.size();
+
+		int level = 0;
+		while (_nodes.size() - level > 1) {
+			int end = _nodes.size();
+			strSort(_nodes.data() + level, _nodes.data() + end);
+			for (int i = level; i < end; i += NODE_SIZE)
+				_nodes.append(node(_nodes, i, end));
+			level = end;
+		}
+
+		_entries.squeeze();
+		_nodes.squeeze();
+	}
+
+	/* The visitor is called with every entry overlapping the search rect,
+	   the search stops when it returns false. Returns the number of entries
+	   found. */
+	template<class VISITOR>
+	int Search(const ELEMTYPE min[2], const ELEMTYPE max[2],
+	  VISITOR visitor) const
+	{
+		Q_ASSERT(_packed);
+
+		if (_nodes.isEmpty())
+			return 0;
+
+		Box box(min, max);
+		QVarLengthArray<int, 64> stack;
+		int found = 0;
+
+		stack.append(_nodes.size() - 1);
+		while (!stack.isEmpty()) {
+			int idx = stack.last();
+			stack.removeLast();
+			const Node &n = _nodes.at(idx);
+
+			if (idx < _leafNodes) {
+				for (int i = n.first; i < n.first + n.count; i++) {
+					const Entry &e = _entries.at(i);
+					if (e.box.overlaps(box)) {
+						found++;
+						if (!visitor(e.data))
+							return found;
+					}
+				}
+			} else {
+				for (int i = n.first; i < n.first + n.count; i++)
+					if (_nodes.at(i).box.overlaps(box))
+						stack.append(i);
+			}
+		}
+
+		return found;
+	}
+
+	int Search(const ELEMTYPE min[2], const ELEMTYPE max[2],
+	  bool callback(DATATYPE data, void *context), void *context) const
+	{
+		return Search(min, max, Callback(callback, context));
+	}
+
+	int Count() const {return _entries.size();}
+	const DATATYPE &At(int i) const {return _entries.at(i).data;}
+
+	void RemoveAll()
+	{
+		_entries.clear();
+		_nodes.clear();
+		_leafNodes = 0;
+		_packed = true;
+	}
+
+private:
+	enum {NODE_SIZE = 16};
+
+	static BOUNDTYPE lower(ELEMTYPE val)
+	{
+		BOUNDTYPE b = (BOUNDTYPE)val;
+		return ((ELEMTYPE)b > val)
+		  ? std::nextafter(b, (BOUNDTYPE)-INFINITY) : b;
+	}
+	static BOUNDTYPE upper(ELEMTYPE val)
+	{
+		BOUNDTYPE b = (BOUNDTYPE)val;
+		return ((ELEMTYPE)b < val)
+		  ? std::nextafter(b, (BOUNDTYPE)INFINITY) : b;
+	}
+
+	struct Box
+	{
+		Box()
+		{
+			min[0] = min[1] = INFINITY;
+			max[0] = max[1] = -INFINITY;
+		}
+		Box(const ELEMTYPE min[2], const ELEMTYPE max[2])
+		{
+			for (int i = 0; i < 2; i++) {
+				this->min[i] = lower(min[i]);
+				this->max[i] = upper(max[i]);
+			}
+		}
+
+		bool overlaps(const Box &other) const
+		{
+			return !(min[0] > other.max[0] || other.min[0] > max[0]
+			  || min[1] > other.max[1] || other.min[1] > max[1]);
+		}
+		void extend(const Box &other)
+		{
+			for (int i = 0; i < 2; i++) {
+				min[i] = qMin(min[i], other.min[i]);
+				max[i] = qMax(max[i], other.max[i]);
+			}
+		}
+		double center(int dim) const {return (double)min[dim] + max[dim];}
+
+		BOUNDTYPE min[2];
+		BOUNDTYPE max[2];
+	};
+
+	struct Entry
+	{
+		Box box;
+		DATATYPE data;
+	};
+
+	struct Node
+	{
+		Box box;
+		int first;
+		int count;
+	};
+
+	class Callback
+	{
+	public:
+		Callback(bool callback(DATATYPE data, void *context), void *context)
+		  : _callback(callback), _context(context) {}
+		bool operator()(const DATATYPE &data) const
+		  {return _callback(data, _context);}
+
+	private:
+		bool (*_callback)(DATATYPE data, void *context);
+		void *_context;
+	};
+
+	template<class T> static bool xLessThan(const T &a, const T &b)
+	  {return a.box.center(0) < b.box.center(0);}
+	template<class T> static bool yLessThan(const T &a, const T &b)
+	  {return a.box.center(1) < b.box.center(1);}
+
+	/* Sorts the items by x, splits them into sqrt(N/NODE_SIZE) vertical
+	   slices and sorts each slice by y. Consecutive runs of NODE_SIZE items
+	   then form the nodes of the next tree level. */
+	template<class T> static void strSort(T *begin, T *end)
+	{
+		int size = end - begin;
+		int nodes = (size + NODE_SIZE - 1) / NODE_SIZE;
+		int slices = (int)ceil(sqrt((double)nodes));
+		int sliceSize = slices * NODE_SIZE;
+
+		std::sort(begin, end, xLessThan<T>);
+		for (int i = 0; i < size; i += sliceSize)
+			std::sort(begin + i, begin + qMin(i + sliceSize, size),
+			  yLessThan<T>);
+	}
+
+	template<class T> static Node node(const QVector<T> &items, int first,
+	  int end = -1)
+	{
+		Node n;
+		n.first = first;
+		n.count = qMin((int)NODE_SIZE, (end < 0 ? items.size() : end) - first);
+		for (int i = first; i < first + n.count; i++)
+			n.box.extend(items.at(i).box);
+
+		return n;
+	}
+
+	QVector<Entry> _entries;
+	QVector<Node> _nodes;
+	int _leafNodes;
+	bool _packed;
+};
+
+#endif // PACKEDRTREE_H
@@ -9,6 +9,7 @@
 #define CRS_DIR          "CRS"
 #define DEM_DIR          "DEM"
 #define TILES_DIR        "tiles"
+#define POI_INDEX_DIR    "POI"
 #define TRANSLATIONS_DIR "translations"
 #define STYLE_DIR        "style"
 #define SYMBOLS_DIR      "symbols"
@@ -19,6 +20,7 @@
 #define PCS_FILE         "pcs.csv"
 #define TYP_FILE         "style.typ"
 #define RENDERTHEME_FILE "style.xml"
+#define MAP_CATALOG_FILE "maps.cat"
 
 #ifdef Q_OS_ANDROID
 #define DATA_LOCATION QStandardPaths::GenericDataLocation
@@ -119,6 +121,18 @@ QString ProgramPaths::tilesDir()
 	  QStandardPaths::CacheLocation)).filePath(TILES_DIR);
 }
 
+QString ProgramPaths::poiIndexDir()
+{
+	return QDir(QStandardPaths::writableLocation(
+	  QStandardPaths::CacheLocation)).filePath(POI_INDEX_DIR);
+}
+
+QString ProgramPaths::mapCatalogFile()
+{
+	return QDir(QStandardPaths::writableLocation(
+	  QStandardPaths::CacheLocation)).filePath(MAP_CATALOG_FILE);
+}
+
 QString ProgramPaths::translationsDir()
 {
 #ifdef Q_OS_ANDROID
@@ -12,6 +12,8 @@ namespace ProgramPaths
 	QString styleDir(bool writable = false);
 	QString symbolsDir(bool writable = false);
 	QString tilesDir();
+	QString mapCatalogFile();
+	QString poiIndexDir();
 	QString translationsDir();
 	QString ellipsoidsFile();
 	QString gcsFile();
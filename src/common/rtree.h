@@ -113,6 +113,9 @@ public:
 	/// Remove all entries from tree
 	void RemoveAll();
 
+	/// Swap the content of the tree with another tree
+	void Swap(RTree &other) {qSwap(m_root, other.m_root);}
+
 	/// Count the data elements in this container.  This is slow as no internal
 	/// counter is maintained.
 	int Count() const;
@@ -0,0 +1,210 @@
+#include "trace.h"
+
+#ifdef ENABLE_TRACE
+
+#include <QFile>
+#include <QMutex>
+#include <QVector>
+#include <QMap>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+
+/* Hard limit of the recorded events (~100MB), tracing stops when reached */
+#define MAX_EVENTS 4000000
+
+struct Event
+{
+	const char *name;
+	char type;
+	int tid;
+	qint64 ts;
+	qint64 value;
+};
+
+static QAtomicInt enabled;
+static QElapsedTimer timer;
+static QMutex eventsLock;
+static QVector<Event> events;
+static QMap<QByteArray, qint64> counters;
+static QAtomicInt threads;
+
+static int threadId()
+{
+	static thread_local int id = threads.fetchAndAddRelaxed(1);
+	return id;
+}
+
+static void append(const char *name, char type, qint64 ts, qint64 value)
+{
+	if (events.size() >= MAX_EVENTS) {
+		enabled.storeRelaxed(0);
+		qWarning("Trace event limit reached, tracing stopped");
+		return;
+	}
+
+	Event e = {name, type, threadId(), ts, value};
+	events.append(e);
+}
+
+Trace::Scope::Scope(const char *name)
+  : _name(name), _start(isEnabled() ? now() : -1) {}
+
+Trace::Scope::~Scope()
+{
+	if (_start >= 0)
+		complete(_name, _start, now() - _start);
+}
+
+void Trace::start()
+{
+	QMutexLocker locker(&eventsLock);
+
+	events.clear();
+	counters.clear();
+	timer.start();
+	enabled.storeRelaxed(1);
+}
+
+bool Trace::isEnabled()
+{
+	return enabled.loadRelaxed();
+}
+
+qint64 Trace::now()
+{
+	return timer.nsecsElapsed() / 1000;
+}
+
+void Trace::complete(const char *name, qint64 start, qint64 duration)
+{
+	if (!isEnabled())
+		return;
+
+	QMutexLocker locker(&eventsLock);
+	append(name, 'X', start, duration);
+}
+
+void Trace::count(const char *name, qint64 delta)
+{
+	if (!isEnabled())
+		return;
+
+	QMutexLocker locker(&eventsLock);
+	qint64 &value = counters[QByteArray(name)];
+	value += delta;
+	append(name, 'C', now(), value);
+}
+
+qint64 Trace::value(const char *name)
+{
+	QMutexLocker locker(&eventsLock);
+	return counters.value(QByteArray(name));
+}
+
+/* Lock waits are only recorded when the mutex is not immediately available */
+void Trace::lock(QMutex *mutex)
+{
+	if (!isEnabled()) {
+		mutex->lock();
+		return;
+	}
+	if (mutex->tryLock())
+		return;
+
+	qint64 start = now();
+	mutex->lock();
+	complete("lock wait", start, now() - start);
+	count("lock waits", 1);
+}
+
+bool Trace::save(const QString &path)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		qWarning("%s: %s", qUtf8Printable(path),
+		  qUtf8Printable(file.errorString()));
+		return false;
+	}
+
+	QMutexLocker locker(&eventsLock);
+
+	file.write("{\"traceEvents\":[\n");
+	for (int i = 0; i < events.size(); i++) {
+		const Event &e = events.at(i);
+		QByteArray ev("{\"name\":\"" + QByteArray(e.name) + "\",\"ph\":\""
+		  + e.type + "\",\"pid\":1,\"tid\":" + QByteArray::number(e.tid)
+		  + ",\"ts\":" + QByteArray::number(e.ts));
+		if (e.type == 'X')
+			ev += ",\"dur\":" + QByteArray::number(e.value) + "}";
+		else
+			ev += ",\"args\":{\"value\":" + QByteArray::number(e.value) + "}}";
+		if (i < events.size() - 1)
+			ev += ",";
+		file.write(ev + "\n");
+	}
+	file.write("],\"displayTimeUnit\":\"ms\"}\n");
+
+	return (file.error() == QFile::NoError);
+}
+
+struct Stats
+{
+	Stats() : count(0), total(0), min(0), max(0) {}
+
+	qint64 count;
+	qint64 total;
+	qint64 min;
+	qint64 max;
+};
+
+bool Trace::saveSummary(const QString &path)
+{
+	QFile file(path);
+	QMap<QByteArray, Stats> scopes;
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		qWarning("%s: %s", qUtf8Printable(path),
+		  qUtf8Printable(file.errorString()));
+		return false;
+	}
+
+	QMutexLocker locker(&eventsLock);
+
+	for (int i = 0; i < events.size(); i++) {
+		const Event &e = events.at(i);
+		if (e.type != 'X')
+			continue;
+
+		Stats &s = scopes[QByteArray(e.name)];
+		s.min = s.count ? qMin(s.min, e.value) : e.value;
+		s.max = qMax(s.max, e.value);
+		s.total += e.value;
+		s.count++;
+	}
+
+	file.write("{\"scopes\":{");
+	for (QMap<QByteArray, Stats>::const_iterator it = scopes.constBegin();
+	  it != scopes.constEnd(); ++it) {
+		const Stats &s = it.value();
+		if (it != scopes.constBegin())
+			file.write(",");
+		file.write("\n\"" + it.key() + "\":{\"count\":"
+		  + QByteArray::number(s.count) + ",\"total\":"
+		  + QByteArray::number(s.total) + ",\"min\":"
+		  + QByteArray::number(s.min) + ",\"max\":"
+		  + QByteArray::number(s.max) + "}");
+	}
+	file.write("},\n\"counters\":{");
+	for (QMap<QByteArray, qint64>::const_iterator it = counters.constBegin();
+	  it != counters.constEnd(); ++it) {
+		if (it != counters.constBegin())
+			file.write(",");
+		file.write("\n\"" + it.key() + "\":" + QByteArray::number(it.value()));
+	}
+	file.write("}}\n");
+
+	return (file.error() == QFile::NoError);
+}
+
+#endif // ENABLE_TRACE
@@ -0,0 +1,60 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/* Render instrumentation. The trace points compile to nothing unless the
+   application is built with ENABLE_TRACE (qmake CONFIG+=trace) and even then
+   they only record events after Trace::start(). The recorded events are saved
+   in the Chrome trace event format (chrome://tracing, Perfetto), the summary
+   (per scope totals and final counter values) is meant for comparing runs of
+   different builds. */
+
+#ifdef ENABLE_TRACE
+
+#include <QString>
+
+class QMutex;
+
+namespace Trace
+{
+	class Scope
+	{
+	public:
+		Scope(const char *name);
+		~Scope();
+
+	private:
+		const char *_name;
+		qint64 _start;
+	};
+
+	void start();
+	bool isEnabled();
+	qint64 now();
+
+	void complete(const char *name, qint64 start, qint64 duration);
+	void count(const char *name, qint64 delta);
+	qint64 value(const char *name);
+	void lock(QMutex *mutex);
+
+	bool save(const QString &path);
+	bool saveSummary(const QString &path);
+}
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+/* The names must be string literals, only the pointers are stored */
+#define TRACE_SCOPE(name) \
+  Trace::Scope TRACE_CONCAT(_traceScope, __LINE__)(name)
+#define TRACE_COUNT(name, delta) Trace::count(name, delta)
+#define TRACE_LOCK(mutex) Trace::lock(&(mutex))
+
+#else // ENABLE_TRACE
+
+#define TRACE_SCOPE(name)
+#define TRACE_COUNT(name, delta)
+#define TRACE_LOCK(mutex) (mutex).lock()
+
+#endif // ENABLE_TRACE
+
+#endif // TRACE_H
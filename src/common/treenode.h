@@ -14,6 +14,8 @@ public:
 	const QString &name() const {return _name;}
 	const QList<TreeNode<T> > &childs() const {return _childs;}
 	const QList<T> &items() const {return _items;}
+	QList<TreeNode<T> > &rchilds() {return _childs;}
+	QList<T> &ritems() {return _items;}
 
 	void addItem(T node) {_items.append(node);}
 	void addChild(const TreeNode<T> &child) {_childs.append(child);}
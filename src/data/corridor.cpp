@@ -0,0 +1,248 @@
+#include "common/greatcircle.h"
+#include "common/wgs84.h"
+#include "path.h"
+#include "corridor.h"
+
+/* Max number of segments in one envelope */
+#define ENVELOPE_SIZE  16
+/* Max segment length (in radius units). Longer segments are split so that
+   their envelopes stay reasonably tight. */
+#define SEGMENT_LENGTH 64
+
+static inline bool overlaps(double min1, double max1, double min2,
+  double max2)
+{
+	return (min1 <= max2 && max1 >= min2);
+}
+
+static double bearing(double lat1, double lon1, double lat2, double lon2)
+{
+	return atan2(sin(lon2 - lon1) * cos(lat2), cos(lat1) * sin(lat2)
+	  - sin(lat1) * cos(lat2) * cos(lon2 - lon1));
+}
+
+/* Angular distance (haversine) */
+static double distance(double lat1, double lon1, double lat2, double lon2)
+{
+	double sLat = sin((lat2 - lat1) / 2.0);
+	double sLon = sin((lon2 - lon1) / 2.0);
+	double a = sLat * sLat + cos(lat1) * cos(lat2) * sLon * sLon;
+
+	return 2.0 * atan2(sqrt(a), sqrt(1.0 - a));
+}
+
+/* Distance of point p from the great circle segment c1-c2 (cross-track
+   distance if the projection of p lies on the segment, the distance to the
+   nearest end point otherwise). */
+static double segmentDistance(const Coordinates &p, const Coordinates &c1,
+  const Coordinates &c2)
+{
+	double lat1 = deg2rad(c1.lat()), lon1 = deg2rad(c1.lon());
+	double lat2 = deg2rad(c2.lat()), lon2 = deg2rad(c2.lon());
+	double lat3 = deg2rad(p.lat()), lon3 = deg2rad(p.lon());
+
+	double d13 = distance(lat1, lon1, lat3, lon3);
+	double d12 = distance(lat1, lon1, lat2, lon2);
+	if (d12 < 1e-12)
+		return d13 * WGS84_RADIUS;
+
+	double dxt = asin(sin(d13) * sin(bearing(lat1, lon1, lat3, lon3)
+	  - bearing(lat1, lon1, lat2, lon2)));
+	double dat = acos(qBound(-1.0, cos(d13) / cos(dxt), 1.0));
+
+	if (cos(bearing(lat1, lon1, lat3, lon3) - bearing(lat1, lon1, lat2, lon2))
+	  < 0 || dat > d12)
+		return qMin(d13, distance(lat2, lon2, lat3, lon3)) * WGS84_RADIUS;
+	else
+		return qAbs(dxt) * WGS84_RADIUS;
+}
+
+/* Latitude range of the great circle segment c1-c2 (in degrees). The segment
+   may bulge poleward out of the end points latitude range, in that case the
+   range is extended to the latitude of the great circle vertex (Clairaut's
+   relation). */
+static void latitudeRange(const Coordinates &c1, const Coordinates &c2,
+  double &min, double &max)
+{
+	double lat1 = deg2rad(c1.lat()), lon1 = deg2rad(c1.lon());
+	double lat2 = deg2rad(c2.lat()), lon2 = deg2rad(c2.lon());
+
+	min = qMin(c1.lat(), c2.lat());
+	max = qMax(c1.lat(), c2.lat());
+
+	if (distance(lat1, lon1, lat2, lon2) < 1e-12)
+		return;
+
+	double b1 = bearing(lat1, lon1, lat2, lon2);
+	/* Cosine of the final course at c2 */
+	double cb2 = -cos(bearing(lat2, lon2, lat1, lon1));
+	double vertex = rad2deg(acos(qMin(qAbs(sin(b1) * cos(lat1)), 1.0)));
+
+	if (cos(b1) > 0 && cb2 < 0)
+		max = vertex;
+	else if (cos(b1) < 0 && cb2 > 0)
+		min = -vertex;
+}
+
+
+Corridor::Corridor(const Path &path, double radius) : _radius(radius)
+{
+	for (int i = 0; i < path.count(); i++) {
+		const PathSegment &segment = path.at(i);
+		int first = _segments.size();
+
+		if (segment.size() == 1)
+			addSegment(segment.first().coordinates(),
+			  segment.first().coordinates());
+		for (int j = 1; j < segment.size(); j++) {
+			double ds = segment.at(j).distance() - segment.at(j-1).distance();
+			unsigned n = (unsigned)ceil(ds / (SEGMENT_LENGTH * _radius));
+
+			if (n > 1) {
+				GreatCircle gc(segment.at(j-1).coordinates(),
+				  segment.at(j).coordinates());
+				Coordinates last(segment.at(j-1).coordinates());
+				for (unsigned k = 1; k <= n; k++) {
+					Coordinates c(k == n ? segment.at(j).coordinates()
+					  : gc.pointAt((double)k/n));
+					addSegment(last, c);
+					last = c;
+				}
+			} else
+				addSegment(segment.at(j-1).coordinates(),
+				  segment.at(j).coordinates());
+		}
+
+		/* Date line crossing segments get an envelope of their own */
+		for (int j = first; j < _segments.size(); ) {
+			int count = 0;
+			while (j + count < _segments.size() && count < ENVELOPE_SIZE) {
+				const Segment &s = _segments.at(j + count);
+				if (fabs(s.c1.lon() - s.c2.lon()) > 180.0) {
+					if (!count)
+						count = 1;
+					break;
+				}
+				count++;
+			}
+			addEnvelope(j, count);
+			j += count;
+		}
+	}
+}
+
+void Corridor::addSegment(const Coordinates &c1, const Coordinates &c2)
+{
+	_segments.append(Segment(c1, c2));
+}
+
+void Corridor::addEnvelope(int first, int count)
+{
+	Envelope e;
+	double dLat = rad2deg(_radius / WGS84_RADIUS);
+
+	e.min[0] = e.min[1] = 180.0;
+	e.max[0] = e.max[1] = -180.0;
+	e.first = first;
+	e.count = count;
+	e.wrap = false;
+
+	for (int i = first; i < first + count; i++) {
+		const Segment &s = _segments.at(i);
+		double min, max;
+
+		if (fabs(s.c1.lon() - s.c2.lon()) > 180.0)
+			e.wrap = true;
+		latitudeRange(s.c1, s.c2, min, max);
+		e.min[0] = qMin(e.min[0], qMin(s.c1.lon(), s.c2.lon()));
+		e.max[0] = qMax(e.max[0], qMax(s.c1.lon(), s.c2.lon()));
+		e.min[1] = qMin(e.min[1], min);
+		e.max[1] = qMax(e.max[1], max);
+	}
+
+	double maxLat = qMax(qAbs(e.min[1]), qAbs(e.max[1])) + dLat;
+	double dLon = (maxLat >= 89.0) ? 360.0 : dLat / cos(deg2rad(maxLat));
+
+	e.min[1] -= dLat;
+	e.max[1] += dLat;
+	if (e.wrap) {
+		/* The envelope covers [max, 180] + [-180, min] in this case */
+		double min = e.min[0];
+		e.min[0] = e.max[0] - dLon;
+		e.max[0] = min + dLon;
+	} else {
+		e.min[0] -= dLon;
+		e.max[0] += dLon;
+	}
+
+	_envelopes.append(e);
+}
+
+bool Corridor::intersects(int envelope, const double min[2],
+  const double max[2]) const
+{
+	const Envelope &e = _envelopes.at(envelope);
+
+	if (min[1] > e.max[1] || max[1] < e.min[1])
+		return false;
+	if (e.wrap)
+		return (max[0] >= e.min[0] || min[0] <= e.max[0]);
+	else
+		return (overlaps(min[0], max[0], e.min[0], e.max[0])
+		  || overlaps(min[0], max[0], e.min[0] + 360.0, e.max[0] + 360.0)
+		  || overlaps(min[0], max[0], e.min[0] - 360.0, e.max[0] - 360.0));
+}
+
+/* Covers the corridor with rects of the size of the corridor width, for
+   use cases where the area covered by the envelopes is much too large
+   (tiles downloads). */
+QList<RectC> Corridor::rects() const
+{
+	QList<RectC> list;
+	double dLat = rad2deg(_radius / WGS84_RADIUS);
+
+	for (int i = 0; i < _segments.size(); i++) {
+		const Segment &s = _segments.at(i);
+		bool wrap = (fabs(s.c1.lon() - s.c2.lon()) > 180.0);
+		unsigned n = wrap ? 1 : qMax(1U, (unsigned)ceil(s.c1.distanceTo(s.c2)
+		  / (2 * _radius)));
+		GreatCircle gc(s.c1, s.c2);
+		Coordinates last(s.c1);
+
+		for (unsigned j = 1; j <= n; j++) {
+			Coordinates c(j == n ? s.c2 : gc.pointAt((double)j/n));
+			double top = qMin(qMax(last.lat(), c.lat()) + dLat, 90.0);
+			double bottom = qMax(qMin(last.lat(), c.lat()) - dLat, -90.0);
+			double maxLat = qMax(qAbs(top), qAbs(bottom));
+			double dLon = (maxLat >= 89.0) ? 360.0 : dLat / cos(deg2rad(maxLat));
+			double left = qMin(last.lon(), c.lon());
+			double right = qMax(last.lon(), c.lon());
+
+			if (wrap) {
+				list.append(RectC(Coordinates(qMax(right - dLon, -180.0), top),
+				  Coordinates(180.0, bottom)));
+				list.append(RectC(Coordinates(-180.0, top),
+				  Coordinates(qMin(left + dLon, 180.0), bottom)));
+			} else
+				list.append(RectC(Coordinates(qMax(left - dLon, -180.0), top),
+				  Coordinates(qMin(right + dLon, 180.0), bottom)));
+
+			last = c;
+		}
+	}
+
+	return list;
+}
+
+bool Corridor::contains(int envelope, const Coordinates &c) const
+{
+	const Envelope &e = _envelopes.at(envelope);
+
+	for (int i = e.first; i < e.first + e.count; i++) {
+		const Segment &s = _segments.at(i);
+		if (segmentDistance(c, s.c1, s.c2) <= _radius)
+			return true;
+	}
+
+	return false;
+}
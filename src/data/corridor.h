@@ -0,0 +1,50 @@
+#ifndef CORRIDOR_H
+#define CORRIDOR_H
+
+#include <QVector>
+#include <QList>
+#include "common/coordinates.h"
+#include "common/rectc.h"
+
+class Path;
+
+/* The area within a given distance from a path. The path segments are merged
+   into a small number of lon/lat envelopes used to prune a spatial index
+   traversal, the candidate points are then checked using the exact
+   (spherical) point-to-segment distance. */
+class Corridor
+{
+public:
+	Corridor(const Path &path, double radius);
+
+	int envelopes() const {return _envelopes.size();}
+	bool intersects(int envelope, const double min[2],
+	  const double max[2]) const;
+	bool contains(int envelope, const Coordinates &c) const;
+
+	QList<RectC> rects() const;
+
+private:
+	struct Segment {
+		Segment() {}
+		Segment(const Coordinates &c1, const Coordinates &c2)
+		  : c1(c1), c2(c2) {}
+
+		Coordinates c1, c2;
+	};
+
+	struct Envelope {
+		double min[2], max[2];
+		bool wrap;
+		int first, count;
+	};
+
+	void addSegment(const Coordinates &c1, const Coordinates &c2);
+	void addEnvelope(int first, int count);
+
+	QVector<Segment> _segments;
+	QVector<Envelope> _envelopes;
+	double _radius;
+};
+
+#endif // CORRIDOR_H
@@ -10,6 +10,8 @@
 #define PROJ(object, parent) \
 	((object).isNull() ? (parent) : (object))
 
+#define BUFFER_SIZE 65536
+
 /*
  * Mapbox Simple Style
  * https://github.com/mapbox/simplestyle-spec
@@ -185,6 +187,132 @@ static bool isWS(char c)
 	return (c == 0x20 || c == 0x09 || c == 0x0A || c == 0x0D) ? true : false;
 }
 
+/* Buffered JSON byte stream splitting the document into its values without
+   parsing them. Only the structure (brackets, strings and their escapes) is
+   checked, the values themselves are validated by QJsonDocument. */
+class JSONStream
+{
+public:
+	JSONStream(QFile *file) : _file(file), _offset(0), _pos(0) {}
+
+	qint64 offset() const {return _offset + _pos;}
+	bool seek(qint64 offset);
+
+	bool skipWS();
+	bool getChar(char *c);
+	bool readValue(QByteArray *value);
+
+private:
+	bool fill();
+	bool readString(QByteArray *value);
+
+	QFile *_file;
+	QByteArray _buffer;
+	qint64 _offset;
+	int _pos;
+};
+
+bool JSONStream::fill()
+{
+	if (_pos < _buffer.size())
+		return true;
+
+	_offset += _buffer.size();
+	_buffer = _file->read(BUFFER_SIZE);
+	_pos = 0;
+
+	return !_buffer.isEmpty();
+}
+
+bool JSONStream::seek(qint64 offset)
+{
+	if (!_file->seek(offset))
+		return false;
+
+	_buffer.clear();
+	_offset = offset;
+	_pos = 0;
+
+	return true;
+}
+
+bool JSONStream::skipWS()
+{
+	while (fill()) {
+		if (!isWS(_buffer.at(_pos)))
+			return true;
+		_pos++;
+	}
+
+	return false;
+}
+
+bool JSONStream::getChar(char *c)
+{
+	if (!fill())
+		return false;
+
+	*c = _buffer.at(_pos++);
+	return true;
+}
+
+bool JSONStream::readString(QByteArray *value)
+{
+	char c;
+
+	while (getChar(&c)) {
+		if (value)
+			value->append(c);
+		if (c == '"')
+			return true;
+		else if (c == '\\') {
+			if (!getChar(&c))
+				return false;
+			if (value)
+				value->append(c);
+		}
+	}
+
+	return false;
+}
+
+/* Reads the next value including all its nested values. If value is null,
+   the value is skipped. */
+bool JSONStream::readValue(QByteArray *value)
+{
+	int depth = 0;
+	char c;
+
+	if (!skipWS())
+		return false;
+
+	do {
+		if (!fill())
+			return false;
+
+		c = _buffer.at(_pos);
+		if (!depth && (isWS(c) || c == ',' || c == '}' || c == ']'
+		  || c == ':'))
+			return true;
+
+		_pos++;
+		if (value)
+			value->append(c);
+
+		if (c == '"') {
+			if (!readString(value))
+				return false;
+		} else if (c == '{' || c == '[')
+			depth++;
+		else if (c == '}' || c == ']') {
+			if (!depth--)
+				return false;
+		}
+	} while (depth || (c != '"' && c != '}' && c != ']'));
+
+	return true;
+}
+
 static bool possiblyJSONObject(QFile *file)
 {
 	char c;
@@ -645,25 +773,120 @@ bool GeoJSONParser::feature(const QJsonObject &object, const QString &file,
 	}
 }
 
-bool GeoJSONParser::featureCollection(const QJsonObject &object,
-  const QString &file, const Projection &parent, QList<TrackData> &tracks,
-  QList<Area> &areas, QVector<Waypoint> &waypoints)
+bool GeoJSONParser::parseError(JSONStream &stream, const QString &error)
 {
-	if (!object["features"].isArray()) {
+	_errorString = QString("JSON parse error on offset %1: %2")
+	  .arg(QString::number(stream.offset()), error);
+	return false;
+}
+
+/* The features are parsed one by one directly from the file, so only a single
+   feature JSON DOM exists at any time. */
+bool GeoJSONParser::featureCollection(JSONStream &stream, qint64 features,
+  const QJsonObject &object, const QString &file, const Projection &parent,
+  QList<TrackData> &tracks, QList<Area> &areas, QVector<Waypoint> &waypoints)
+{
+	char c;
+
+	if (features < 0 || !stream.seek(features) || !stream.skipWS()
+	  || !stream.getChar(&c) || c != '[') {
 		_errorString = "Invalid/missing FeatureCollection features array";
 		return false;
 	}
 
-	QJsonArray features(object["features"].toArray());
 	Projection proj;
 	if (!crs(object, proj))
 		return false;
 
-	for (int i = 0; i < features.size(); i++)
-		if (!feature(features.at(i).toObject(), file, PROJ(proj, parent),
-		  tracks, areas, waypoints))
+	if (!stream.skipWS())
+		return parseError(stream, "unterminated array");
+	while (true) {
+		QByteArray data;
+		qint64 offset = stream.offset();
+
+		if (!stream.readValue(&data))
+			return parseError(stream, "unterminated array");
+		if (data.isEmpty() && stream.getChar(&c) && c == ']')
+			return true;
+
+		QJsonParseError error;
+		QJsonDocument doc(QJsonDocument::fromJson(data, &error));
+		if (doc.isNull()) {
+			_errorString = QString("JSON parse error on offset %1: %2")
+			  .arg(QString::number(offset + error.offset), error.errorString());
+			return false;
+		}
+
+		if (!feature(doc.object(), file, PROJ(proj, parent), tracks, areas,
+		  waypoints))
 			return false;
 
+		if (!stream.skipWS() || !stream.getChar(&c))
+			return parseError(stream, "unterminated array");
+		if (c == ']')
+			return true;
+		else if (c != ',')
+			return parseError(stream, "missing value separator");
+	}
+}
+
+/* Parses all the top-level object members except of the FeatureCollection
+   features array, that is only skipped and its offset recorded. */
+bool GeoJSONParser::header(JSONStream &stream, QJsonObject &object,
+  qint64 &features)
+{
+	QByteArray data("{");
+	char c;
+
+	features = -1;
+
+	if (!stream.skipWS() || !stream.getChar(&c) || c != '{')
+		return parseError(stream, "illegal value");
+
+	if (!stream.skipWS())
+		return parseError(stream, "unterminated object");
+	while (true) {
+		QByteArray key;
+
+		if (!stream.readValue(&key))
+			return parseError(stream, "unterminated object");
+		if (key.isEmpty() && stream.getChar(&c) && c == '}')
+			break;
+		if (!stream.skipWS() || !stream.getChar(&c) || c != ':')
+			return parseError(stream, "missing name separator");
+
+		if (key == "\"features\"") {
+			if (!stream.skipWS())
+				return parseError(stream, "unterminated object");
+			features = stream.offset();
+			if (!stream.readValue(0))
+				return parseError(stream, "unterminated object");
+		} else {
+			if (data.size() > 1)
+				data.append(',');
+			data.append(key);
+			data.append(':');
+			if (!stream.readValue(&data))
+				return parseError(stream, "unterminated object");
+		}
+
+		if (!stream.skipWS() || !stream.getChar(&c))
+			return parseError(stream, "unterminated object");
+		if (c == '}')
+			break;
+		else if (c != ',')
+			return parseError(stream, "missing value separator");
+	}
+	data.append('}');
+
+	QJsonParseError error;
+	QJsonDocument doc(QJsonDocument::fromJson(data, &error));
+	if (doc.isNull()) {
+		_errorString = QString("JSON parse error: %1").arg(error.errorString());
+		return false;
+	}
+	object = doc.object();
+
 	return true;
 }
 
@@ -679,16 +902,12 @@ bool GeoJSONParser::parse(QFile *file, QList<TrackData> &tracks,
 	} else
 		file->reset();
 
-	QJsonParseError error;
-	QJsonDocument doc(QJsonDocument::fromJson(file->readAll(), &error));
-
-	if (doc.isNull()) {
-		_errorString = QString("JSON parse error on offset %1: %2")
-		  .arg(QString::number(error.offset), error.errorString());
+	JSONStream stream(file);
+	QJsonObject object;
+	qint64 features;
+	if (!header(stream, object, features))
 		return false;
-	}
 
-	QJsonObject object(doc.object());
 	Projection proj(GCS::WGS84());
 	QString fileName(file->fileName());
 
@@ -707,8 +926,8 @@ bool GeoJSONParser::parse(QFile *file, QList<TrackData> &tracks,
 		case Feature:
 			return feature(object, fileName, proj, tracks, areas, waypoints);
 		case FeatureCollection:
-			return featureCollection(object, fileName, proj, tracks, areas,
-			  waypoints);
+			return featureCollection(stream, features, object, fileName, proj,
+			  tracks, areas, waypoints);
 		case Polygon:
 			return polygon(object, proj, QJsonValue(), areas);
 		case MultiPolygon:
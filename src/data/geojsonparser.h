@@ -7,6 +7,7 @@
 class QJsonObject;
 class QJsonArray;
 class Projection;
+class JSONStream;
 
 class GeoJSONParser : public Parser
 {
@@ -53,9 +54,12 @@ private:
 	bool feature(const QJsonObject &json, const QString &file,
 	  const Projection &parent, QList<TrackData> &tracks, QList<Area> &areas,
 	  QVector<Waypoint> &waypoints);
-	bool featureCollection(const QJsonObject &object, const QString &file,
-	  const Projection &parent, QList<TrackData> &tracks, QList<Area> &areas,
+	bool featureCollection(JSONStream &stream, qint64 features,
+	  const QJsonObject &object, const QString &file, const Projection &parent,
+	  QList<TrackData> &tracks, QList<Area> &areas,
 	  QVector<Waypoint> &waypoints);
+	bool header(JSONStream &stream, QJsonObject &object, qint64 &features);
+	bool parseError(JSONStream &stream, const QString &error);
 
 	QString _errorString;
 };
@@ -1,59 +1,37 @@
 #include <QFile>
 #include <QDir>
+#include <QCryptographicHash>
 #include "common/rectc.h"
-#include "common/greatcircle.h"
 #include "common/wgs84.h"
+#include "common/programpaths.h"
 #include "data.h"
 #include "path.h"
+#include "corridor.h"
 #include "poi.h"
 
 
-static bool cb(size_t data, void* context)
+void POI::File::search(const RectC &rect, QSet<quint32> &set) const
 {
-	QSet<int> *set = (QSet<int>*) context;
-	set->insert((int)data);
-
-	return true;
-}
-
-POI::File::File(int start, int end, const QVector<Waypoint> &data)
-  : _enabled(true)
-{
-	qreal c[2];
-
-	for (int i = start; i <= end; i++) {
-		const Coordinates &p = data.at(i).coordinates();
-
-		c[0] = p.lon();
-		c[1] = p.lat();
-		_tree.Insert(c, c, i);
-	}
-}
-
-void POI::File::search(const RectC &rect, QSet<int> &set) const
-{
-	qreal min[2], max[2];
-
-	if (_enabled) {
-		if (rect.left() > rect.right()) {
-			min[0] = rect.topLeft().lon();
-			min[1] = rect.bottomRight().lat();
-			max[0] = 180.0;
-			max[1] = rect.topLeft().lat();
-			_tree.Search(min, max, cb, &set);
-
-			min[0] = -180.0;
-			min[1] = rect.bottomRight().lat();
-			max[0] = rect.bottomRight().lon();
-			max[1] = rect.topLeft().lat();
-			_tree.Search(min, max, cb, &set);
-		} else {
-			min[0] = rect.topLeft().lon();
-			min[1] = rect.bottomRight().lat();
-			max[0] = rect.bottomRight().lon();
-			max[1] = rect.topLeft().lat();
-			_tree.Search(min, max, cb, &set);
-		}
+	double min[2], max[2];
+
+	if (rect.left() > rect.right()) {
+		min[0] = rect.topLeft().lon();
+		min[1] = rect.bottomRight().lat();
+		max[0] = 180.0;
+		max[1] = rect.topLeft().lat();
+		_index.search(min, max, set);
+
+		min[0] = -180.0;
+		min[1] = rect.bottomRight().lat();
+		max[0] = rect.bottomRight().lon();
+		max[1] = rect.topLeft().lat();
+		_index.search(min, max, set);
+	} else {
+		min[0] = rect.topLeft().lon();
+		min[1] = rect.bottomRight().lat();
+		max[0] = rect.bottomRight().lon();
+		max[1] = rect.topLeft().lat();
+		_index.search(min, max, set);
 	}
 }
 
@@ -69,20 +47,36 @@ POI::~POI()
 	qDeleteAll(_files);
 }
 
+QString POI::indexFile(const QString &path)
+{
+	QByteArray id(QCryptographicHash::hash(QFileInfo(path).absoluteFilePath()
+	  .toUtf8(), QCryptographicHash::Sha1).toHex());
+	return QDir(ProgramPaths::poiIndexDir()).filePath(QString::fromLatin1(id)
+	  + ".idx");
+}
+
+/* The POI files are only parsed when their (cached) index does not exist or
+   is outdated. */
 bool POI::loadFile(const QString &path)
 {
-	Data data(path);
+	QFileInfo fi(path);
+	QString ip(indexFile(path));
+	File *file = new File();
+
+	if (!file->index().load(ip, fi)) {
+		Data data(path);
+
+		if (!data.isValid()) {
+			_errorString = data.errorString();
+			_errorLine = data.errorLine();
+			delete file;
+			return false;
+		}
 
-	if (!data.isValid()) {
-		_errorString = data.errorString();
-		_errorLine = data.errorLine();
-		return false;
+		file->index().create(ip, fi, data.waypoints());
 	}
 
-	int start = _data.size();
-	_data.append(data.waypoints());
-
-	_files.insert(path, new File(start, _data.size() - 1, _data));
+	_files.insert(path, file);
 
 	emit pointsChanged();
 
@@ -116,79 +110,58 @@ TreeNode<QString> POI::loadDir(const QString &path)
 	return tree;
 }
 
-void POI::search(const RectC &rect, QSet<int> &set) const
-{
-	for (ConstIterator it = _files.constBegin(); it != _files.constEnd(); ++it)
-		(*it)->search(rect, set);
-}
-
-QList<Waypoint> POI::points(const Path &path) const
+QList<Waypoint> POI::search(const QList<RectC> &rects) const
 {
 	QList<Waypoint> ret;
-	QSet<int> set;
-	QSet<int>::const_iterator it;
-
-
-	for (int i = 0; i < path.count(); i++) {
-		const PathSegment &segment = path.at(i);
-
-		for (int j = 1; j < segment.size(); j++) {
-			double ds = segment.at(j).distance() - segment.at(j-1).distance();
-			unsigned n = (unsigned)ceil(ds / _radius);
-
-			if (n > 1) {
-				GreatCircle gc(segment.at(j-1).coordinates(),
-				  segment.at(j).coordinates());
-				for (unsigned k = 0; k < n; k++) {
-					RectC br(gc.pointAt((double)k/n), _radius);
-					search(br, set);
-				}
-			} else {
-				RectC br(segment.at(j-1).coordinates(), _radius);
-				search(br, set);
-			}
-		}
-	}
 
-	RectC br(path.last().last().coordinates(), _radius);
-	search(br, set);
+	for (ConstIterator it = _files.constBegin(); it != _files.constEnd(); ++it) {
+		const File *file = *it;
+		QSet<quint32> set;
 
+		if (!file->isEnabled())
+			continue;
 
-	for (it = set.constBegin(); it != set.constEnd(); ++it)
-		ret.append(_data.at(*it));
+		for (int i = 0; i < rects.size(); i++)
+			file->search(rects.at(i), set);
+		for (QSet<quint32>::const_iterator jt = set.constBegin();
+		  jt != set.constEnd(); ++jt)
+			ret.append(file->waypoint(*jt));
+	}
 
 	return ret;
 }
 
-QList<Waypoint> POI::points(const Waypoint &point) const
+QList<Waypoint> POI::points(const Path &path) const
 {
 	QList<Waypoint> ret;
-	QSet<int> set;
-	QSet<int>::const_iterator it;
+	Corridor corridor(path, _radius);
 
-	RectC br(point.coordinates(), _radius);
-	search(br, set);
+	for (ConstIterator it = _files.constBegin(); it != _files.constEnd(); ++it) {
+		const File *file = *it;
+		QVector<quint32> ids;
 
-	for (it = set.constBegin(); it != set.constEnd(); ++it)
-		ret.append(_data.at(*it));
+		if (!file->isEnabled())
+			continue;
+
+		file->search(corridor, ids);
+		for (int i = 0; i < ids.size(); i++)
+			ret.append(file->waypoint(ids.at(i)));
+	}
 
 	return ret;
 }
 
-QList<Waypoint> POI::points(const RectC &rect) const
+QList<Waypoint> POI::points(const Waypoint &point) const
 {
-	QList<Waypoint> ret;
-	QSet<int> set;
-	QSet<int>::const_iterator it;
+	return search(QList<RectC>() << RectC(point.coordinates(), _radius));
+}
 
+QList<Waypoint> POI::points(const RectC &rect) const
+{
 	double offset = rad2deg(_radius / WGS84_RADIUS);
 	RectC br(rect.adjusted(-offset, offset, offset, -offset));
-	search(br, set);
 
-	for (it = set.constBegin(); it != set.constEnd(); ++it)
-		ret.append(_data.at(*it));
-
-	return ret;
+	return search(QList<RectC>() << br);
 }
 
 bool POI::enableFile(const QString &fileName, bool enable)
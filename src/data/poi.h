@@ -5,12 +5,12 @@
 #include <QPointF>
 #include <QString>
 #include <QStringList>
-#include "common/rtree.h"
 #include "common/treenode.h"
-#include "waypoint.h"
+#include "poiindex.h"
 
 class Path;
 class RectC;
+class Corridor;
 
 class POI : public QObject
 {
@@ -39,24 +39,28 @@ signals:
 	void pointsChanged();
 
 private:
-	typedef RTree<size_t, qreal, 2> POITree;
 	class File {
 	public:
-		File(int start, int end, const QVector<Waypoint> &data);
-
-		void search(const RectC &rect, QSet<int> &set) const;
+		File() : _enabled(true) {}
+
+		POIIndex &index() {return _index;}
+		void search(const RectC &rect, QSet<quint32> &set) const;
+		void search(const Corridor &corridor, QVector<quint32> &ids) const
+		  {_index.search(corridor, ids);}
+		Waypoint waypoint(quint32 id) const {return _index.waypoint(id);}
+		bool isEnabled() const {return _enabled;}
 		void enable(bool enable) {_enabled = enable;}
 
 	private:
 		bool _enabled;
-		POITree _tree;
+		POIIndex _index;
 	};
 	typedef QHash<QString, File*>::const_iterator ConstIterator;
 	typedef QHash<QString, File*>::iterator Iterator;
 
-	void search(const RectC &rect, QSet<int> &set) const;
+	QList<Waypoint> search(const QList<RectC> &rects) const;
+	static QString indexFile(const QString &path);
 
-	QVector<Waypoint> _data;
 	QHash<QString, File*> _files;
 
 	unsigned _radius;
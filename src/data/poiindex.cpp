@@ -0,0 +1,407 @@
+#include <cmath>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QDataStream>
+#include "corridor.h"
+#include "poiindex.h"
+
+
+#define MAGIC     0x49494F50 // "POII"
+#define VERSION   1
+#define NODE_SIZE 16
+
+struct POIHeader
+{
+	quint32 magic;
+	quint32 version;
+	quint32 streamVersion;
+	quint32 levels;
+	qint64 size;
+	qint64 mtime;
+	quint64 points;
+	quint64 pointsOffset;
+	quint64 payloadOffset;
+	quint64 payloadSize;
+};
+
+struct POILevel
+{
+	quint64 offset;
+	quint32 count;
+	quint32 reserved;
+};
+
+struct POINode
+{
+	double min[2];
+	double max[2];
+	quint32 first;
+	quint32 count;
+};
+
+struct POIPoint
+{
+	double c[2];
+	quint64 offset;
+};
+
+static QDataStream &operator<<(QDataStream &stream, const Waypoint &w)
+{
+	stream << w.coordinates().lon() << w.coordinates().lat() << w.name()
+	  << w.description() << w.comment() << w.address() << w.phone()
+	  << w.symbol() << w.images() << (qint32)w.links().size();
+	for (int i = 0; i < w.links().size(); i++)
+		stream << w.links().at(i).URL() << w.links().at(i).text();
+	stream << w.timestamp() << w.elevation() << w.style().icon()
+	  << w.style().color() << (qint32)w.style().size();
+
+	return stream;
+}
+
+static QDataStream &operator>>(QDataStream &stream, Waypoint &w)
+{
+	double lon, lat;
+	QString name, description, comment, address, phone, symbol, url, text;
+	QVector<QString> images;
+	qint32 links, size;
+	QDateTime timestamp;
+	qreal elevation;
+	QPixmap icon;
+	QColor color;
+
+	stream >> lon >> lat >> name >> description >> comment >> address >> phone
+	  >> symbol >> images >> links;
+	w.setCoordinates(Coordinates(lon, lat));
+	w.setName(name);
+	w.setDescription(description);
+	w.setComment(comment);
+	w.setAddress(address);
+	w.setPhone(phone);
+	w.setSymbol(symbol);
+	for (int i = 0; i < images.size(); i++)
+		w.addImage(images.at(i));
+	for (qint32 i = 0; i < links && stream.status() == QDataStream::Ok; i++) {
+		stream >> url >> text;
+		w.addLink(Link(url, text));
+	}
+	stream >> timestamp >> elevation >> icon >> color >> size;
+	w.setTimestamp(timestamp);
+	w.setElevation(elevation);
+	w.setStyle(PointStyle(icon, color, size));
+
+	return stream;
+}
+
+static inline double cx(const POIPoint &p) {return p.c[0];}
+static inline double cy(const POIPoint &p) {return p.c[1];}
+static inline double cx(const POINode &n) {return n.min[0] + n.max[0];}
+static inline double cy(const POINode &n) {return n.min[1] + n.max[1];}
+
+template<class T> static bool xLessThan(const T &a, const T &b)
+  {return cx(a) < cx(b);}
+template<class T> static bool yLessThan(const T &a, const T &b)
+  {return cy(a) < cy(b);}
+
+/* Sort-Tile-Recursive ordering - sorts the items by x, splits them into
+   sqrt(N/NODE_SIZE) vertical slices and sorts each slice by y. Consecutive
+   runs of NODE_SIZE items then form the nodes of the next tree level. */
+template<class T> static void strSort(QVector<T> &items)
+{
+	int nodes = (items.size() + NODE_SIZE - 1) / NODE_SIZE;
+	int slices = (int)ceil(sqrt((double)nodes));
+	int sliceSize = slices * NODE_SIZE;
+
+	std::sort(items.begin(), items.end(), xLessThan<T>);
+	for (int i = 0; i < items.size(); i += sliceSize)
+		std::sort(items.begin() + i, items.begin() + qMin(i + sliceSize,
+		  items.size()), yLessThan<T>);
+}
+
+static void extend(POINode &node, const double min[2],
+  const double max[2])
+{
+	for (int i = 0; i < 2; i++) {
+		node.min[i] = qMin(node.min[i], min[i]);
+		node.max[i] = qMax(node.max[i], max[i]);
+	}
+}
+
+static QVector<POINode> parentNodes(const QVector<POIPoint> &items)
+{
+	QVector<POINode> nodes;
+
+	for (int i = 0; i < items.size(); i += NODE_SIZE) {
+		POINode node;
+		node.min[0] = node.min[1] = INFINITY;
+		node.max[0] = node.max[1] = -INFINITY;
+		node.first = i;
+		node.count = qMin(NODE_SIZE, items.size() - i);
+		for (quint32 j = 0; j < node.count; j++)
+			extend(node, items.at(i + j).c, items.at(i + j).c);
+		nodes.append(node);
+	}
+
+	return nodes;
+}
+
+static QVector<POINode> parentNodes(const QVector<POINode> &items)
+{
+	QVector<POINode> nodes;
+
+	for (int i = 0; i < items.size(); i += NODE_SIZE) {
+		POINode node;
+		node.min[0] = node.min[1] = INFINITY;
+		node.max[0] = node.max[1] = -INFINITY;
+		node.first = i;
+		node.count = qMin(NODE_SIZE, items.size() - i);
+		for (quint32 j = 0; j < node.count; j++)
+			extend(node, items.at(i + j).min, items.at(i + j).max);
+		nodes.append(node);
+	}
+
+	return nodes;
+}
+
+static qint64 mtime(const QFileInfo &fi)
+{
+	return fi.lastModified().toMSecsSinceEpoch();
+}
+
+
+static inline const POIHeader *header(const uchar *data)
+{
+	return (const POIHeader*)data;
+}
+
+static inline const POILevel *level(const uchar *data, quint32 level)
+{
+	return (const POILevel*)(data + sizeof(POIHeader)) + level;
+}
+
+bool POIIndex::map(const QFileInfo &source)
+{
+	const POIHeader *hdr = header(_data);
+
+	if (_size < (qint64)sizeof(POIHeader) || hdr->magic != MAGIC
+	  || hdr->version != VERSION
+	  || hdr->streamVersion != (quint32)QDataStream().version()
+	  || hdr->size != source.size() || hdr->mtime != mtime(source))
+		return false;
+	if (sizeof(POIHeader) + hdr->levels * sizeof(POILevel) > (quint64)_size
+	  || hdr->pointsOffset + hdr->points * sizeof(POIPoint) > (quint64)_size
+	  || hdr->payloadOffset + hdr->payloadSize > (quint64)_size)
+		return false;
+	for (quint32 i = 0; i < hdr->levels; i++) {
+		const POILevel *l = level(_data, i);
+		if (l->offset + l->count * sizeof(POINode) > (quint64)_size)
+			return false;
+	}
+
+	return true;
+}
+
+bool POIIndex::load(const QString &path, const QFileInfo &source)
+{
+	_file.setFileName(path);
+	if (!_file.open(QIODevice::ReadOnly))
+		return false;
+
+	_size = _file.size();
+	_data = _file.map(0, _size);
+	if (!_data || !map(source)) {
+		_file.close();
+		_data = 0;
+		_size = 0;
+		return false;
+	}
+
+	return true;
+}
+
+bool POIIndex::create(const QString &path, const QFileInfo &source,
+  const QVector<Waypoint> &waypoints)
+{
+	QVector<POIPoint> points(waypoints.size());
+	QByteArray payload;
+	QDataStream ps(&payload, QIODevice::WriteOnly);
+	QList<QVector<POINode> > levels;
+
+	for (int i = 0; i < waypoints.size(); i++) {
+		const Waypoint &w = waypoints.at(i);
+		POIPoint &p = points[i];
+		p.c[0] = w.coordinates().lon();
+		p.c[1] = w.coordinates().lat();
+		p.offset = payload.size();
+		ps << w;
+	}
+
+	if (!points.isEmpty()) {
+		strSort(points);
+		levels.prepend(parentNodes(points));
+		while (levels.first().size() > 1) {
+			strSort(levels.first());
+			levels.prepend(parentNodes(levels.first()));
+		}
+	}
+
+	POIHeader hdr;
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic = MAGIC;
+	hdr.version = VERSION;
+	hdr.streamVersion = QDataStream().version();
+	hdr.levels = levels.size();
+	hdr.size = source.size();
+	hdr.mtime = mtime(source);
+	hdr.points = points.size();
+
+	QVector<POILevel> ld(levels.size());
+	quint64 offset = sizeof(POIHeader) + levels.size() * sizeof(POILevel);
+	for (int i = 0; i < levels.size(); i++) {
+		ld[i].offset = offset;
+		ld[i].count = levels.at(i).size();
+		ld[i].reserved = 0;
+		offset += levels.at(i).size() * sizeof(POINode);
+	}
+	hdr.pointsOffset = offset;
+	hdr.payloadOffset = offset + points.size() * sizeof(POIPoint);
+	hdr.payloadSize = payload.size();
+
+	_buffer.reserve(hdr.payloadOffset + hdr.payloadSize);
+	_buffer.append((const char*)&hdr, sizeof(hdr));
+	_buffer.append((const char*)ld.constData(), ld.size() * sizeof(POILevel));
+	for (int i = 0; i < levels.size(); i++)
+		_buffer.append((const char*)levels.at(i).constData(),
+		  levels.at(i).size() * sizeof(POINode));
+	_buffer.append((const char*)points.constData(),
+	  points.size() * sizeof(POIPoint));
+	_buffer.append(payload);
+
+	/* If the index can not be written to the cache, it is used directly from
+	   the memory buffer. */
+	QFile file(path);
+	if (QDir().mkpath(QFileInfo(path).absolutePath())
+	  && file.open(QIODevice::WriteOnly)
+	  && file.write(_buffer) == _buffer.size()) {
+		file.close();
+		if (load(path, source)) {
+			_buffer.clear();
+			return true;
+		}
+	} else
+		qWarning("%s: %s", qUtf8Printable(path),
+		  qUtf8Printable(file.errorString()));
+
+	_data = (const uchar*)_buffer.constData();
+	_size = _buffer.size();
+
+	return true;
+}
+
+quint32 POIIndex::count() const
+{
+	return _data ? header(_data)->points : 0;
+}
+
+void POIIndex::search(const double min[2], const double max[2],
+  QSet<quint32> &set) const
+{
+	if (!_data || !header(_data)->levels)
+		return;
+
+	const POIHeader *hdr = header(_data);
+	const POIPoint *points = (const POIPoint*)(_data + hdr->pointsOffset);
+	QVector<QPair<quint32, quint32> > stack;
+
+	for (quint32 i = 0; i < level(_data, 0)->count; i++)
+		stack.append(QPair<quint32, quint32>(0, i));
+
+	while (!stack.isEmpty()) {
+		QPair<quint32, quint32> item(stack.takeLast());
+		const POINode *nodes = (const POINode*)(_data
+		  + level(_data, item.first)->offset);
+		const POINode &node = nodes[item.second];
+
+		if (node.min[0] > max[0] || node.max[0] < min[0]
+		  || node.min[1] > max[1] || node.max[1] < min[1])
+			continue;
+
+		if (item.first + 1 < hdr->levels) {
+			for (quint32 i = 0; i < node.count; i++)
+				stack.append(QPair<quint32, quint32>(item.first + 1,
+				  node.first + i));
+		} else {
+			for (quint32 i = node.first; i < node.first + node.count; i++) {
+				const POIPoint &p = points[i];
+				if (p.c[0] >= min[0] && p.c[0] <= max[0] && p.c[1] >= min[1]
+				  && p.c[1] <= max[1])
+					set.insert(i);
+			}
+		}
+	}
+}
+
+/* The envelopes that do not intersect a node are dropped for the node's
+   subtree, so every point is visited at most once and only checked against
+   the few envelopes around it. */
+static void search(const uchar *data, quint32 lvl, const POINode &node,
+  const Corridor &corridor, const QVector<int> &envelopes,
+  QVector<quint32> &ids)
+{
+	const POIHeader *hdr = header(data);
+	QVector<int> candidates;
+
+	for (int i = 0; i < envelopes.size(); i++)
+		if (corridor.intersects(envelopes.at(i), node.min, node.max))
+			candidates.append(envelopes.at(i));
+	if (candidates.isEmpty())
+		return;
+
+	if (lvl + 1 < hdr->levels) {
+		const POINode *nodes = (const POINode*)(data
+		  + level(data, lvl + 1)->offset);
+		for (quint32 i = node.first; i < node.first + node.count; i++)
+			search(data, lvl + 1, nodes[i], corridor, candidates, ids);
+	} else {
+		const POIPoint *points = (const POIPoint*)(data + hdr->pointsOffset);
+		for (quint32 i = node.first; i < node.first + node.count; i++) {
+			const POIPoint &p = points[i];
+			for (int j = 0; j < candidates.size(); j++) {
+				if (corridor.intersects(candidates.at(j), p.c, p.c)
+				  && corridor.contains(candidates.at(j),
+				  Coordinates(p.c[0], p.c[1]))) {
+					ids.append(i);
+					break;
+				}
+			}
+		}
+	}
+}
+
+void POIIndex::search(const Corridor &corridor, QVector<quint32> &ids) const
+{
+	if (!_data || !header(_data)->levels || !corridor.envelopes())
+		return;
+
+	const POINode *nodes = (const POINode*)(_data + level(_data, 0)->offset);
+	QVector<int> envelopes(corridor.envelopes());
+	for (int i = 0; i < envelopes.size(); i++)
+		envelopes[i] = i;
+
+	for (quint32 i = 0; i < level(_data, 0)->count; i++)
+		::search(_data, 0, nodes[i], corridor, envelopes, ids);
+}
+
+Waypoint POIIndex::waypoint(quint32 id) const
+{
+	const POIHeader *hdr = header(_data);
+	const POIPoint &p = ((const POIPoint*)(_data + hdr->pointsOffset))[id];
+	QByteArray ba(QByteArray::fromRawData((const char*)_data
+	  + hdr->payloadOffset + p.offset, hdr->payloadSize - p.offset));
+	QDataStream stream(ba);
+	Waypoint w;
+
+	stream >> w;
+
+	return w;
+}
@@ -0,0 +1,40 @@
+#ifndef POIINDEX_H
+#define POIINDEX_H
+
+#include <QFile>
+#include <QByteArray>
+#include <QSet>
+#include "waypoint.h"
+
+class QFileInfo;
+class Corridor;
+
+/* Read-only spatial index of a POI file. The index is a STR-packed R-tree of
+   the waypoint coordinates followed by the serialized waypoints. It is stored
+   in a cache file that is memory-mapped when used, so only the actually
+   queried parts of the index are ever read from the disk. */
+class POIIndex
+{
+public:
+	POIIndex() : _data(0), _size(0) {}
+
+	bool load(const QString &path, const QFileInfo &source);
+	bool create(const QString &path, const QFileInfo &source,
+	  const QVector<Waypoint> &waypoints);
+
+	quint32 count() const;
+	void search(const double min[2], const double max[2],
+	  QSet<quint32> &set) const;
+	void search(const Corridor &corridor, QVector<quint32> &ids) const;
+	Waypoint waypoint(quint32 id) const;
+
+private:
+	bool map(const QFileInfo &source);
+
+	QFile _file;
+	QByteArray _buffer;
+	const uchar *_data;
+	qint64 _size;
+};
+
+#endif // POIINDEX_H
@@ -1,3 +1,4 @@
+#include "common/haversine.h"
 #include "map/map.h"
 #include "route.h"
 
@@ -6,12 +7,12 @@ bool Route::_show2ndElevation = false;
 
 Route::Route(const RouteData &data) : _data(data)
 {
+	QVector<double> ds(Haversine(_data).distances());
 	qreal dist = 0;
 
-	_distance.append(0);
-
-	for (int i = 1; i < _data.count(); i++) {
-		dist += _data.at(i).coordinates().distanceTo(_data.at(i-1).coordinates());
+	_distance.reserve(ds.size());
+	for (int i = 0; i < ds.size(); i++) {
+		dist += ds.at(i);
 		_distance.append(dist);
 	}
 }
@@ -1,3 +1,4 @@
+#include "common/haversine.h"
 #include "map/map.h"
 #include "track.h"
 
@@ -32,8 +33,9 @@ static qreal avg(const QVector<qreal> &v)
 
 static qreal median(QVector<qreal> &v)
 {
-	std::sort(v.begin(), v.end());
-	return v.at(v.size() / 2);
+	QVector<qreal>::iterator m = v.begin() + v.size() / 2;
+	std::nth_element(v.begin(), m, v.end());
+	return *m;
 }
 
 static qreal MAD(QVector<qreal> &v, qreal m)
@@ -129,6 +131,13 @@ Track::Track(const TrackData &data) : _pause(0)
 
 		// precompute distances, times, speeds and acceleration
 		QVector<qreal> acceleration;
+		Haversine hs(sd);
+		QVector<double> dist(hs.distances());
+		QVector<qint64> msecs(sd.size());
+
+		for (int j = 0; j < sd.size(); j++)
+			msecs[j] = sd.at(j).timestamp().isValid()
+			  ? sd.at(j).timestamp().toMSecsSinceEpoch() : -1;
 
 		Segment &seg = _segments.last();
 
@@ -140,13 +149,12 @@ Track::Track(const TrackData &data) : _pause(0)
 		bool hasTime = !std::isnan(seg.time.first());
 
 		for (int j = 1; j < sd.size(); j++) {
-			ds = sd.at(j).coordinates().distanceTo(sd.at(j-1).coordinates());
+			ds = dist.at(j);
 			seg.distance.append(seg.distance.last() + ds);
 
 			if (hasTime && sd.at(j).timestamp().isValid()) {
-				if (sd.at(j).timestamp() > sd.at(j-1).timestamp())
-					dt = sd.at(j-1).timestamp().msecsTo(
-					  sd.at(j).timestamp()) / 1000.0;
+				if (msecs.at(j) > msecs.at(j-1))
+					dt = (msecs.at(j) - msecs.at(j-1)) / 1000.0;
 				else {
 					qWarning("%s: %s: time skew detected",
 					  qUtf8Printable(_data.name()),
@@ -238,8 +246,7 @@ Track::Track(const TrackData &data) : _pause(0)
 				seg.distance[j] = seg.distance.at(last);
 				seg.speed[j] = 0;
 			} else {
-				ds = sd.at(j).coordinates().distanceTo(
-				  sd.at(last).coordinates());
+				ds = hs.distance(last, j);
 				seg.distance[j] = seg.distance.at(last) + ds;
 
 				dt = seg.time.at(j) - seg.time.at(last);
@@ -2,6 +2,7 @@
 #include <QSurfaceFormat>
 #include "GUI/app.h"
 #include "GUI/timezoneinfo.h"
+#include "GUI/batchrender.h"
 
 int main(int argc, char *argv[])
 {
@@ -16,6 +17,11 @@ int main(int argc, char *argv[])
 	  Qt::HighDpiScaleFactorRoundingPolicy::Round);
 #endif // QT6
 
+	/* The batch mode must not require any display */
+	if (BatchRender::isBatch(argc, argv)
+	  && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+
 	QSurfaceFormat fmt;
 	fmt.setProfile(QSurfaceFormat::CoreProfile);
 #ifdef Q_OS_ANDROID
@@ -1,7 +1,15 @@
+#include <QFileInfo>
 #include "atlasdata.h"
 
 using namespace ENC;
 
+/* The decoded map data size is not known, the cell file size is used as an
+   estimate of the memory it occupies */
+qint64 AtlasData::cost(const QString &path)
+{
+	return QFileInfo(path).size();
+}
+
 bool AtlasData::pointCb(MapEntry *map, void *context)
 {
 	PointCTX *ctx = (PointCTX*)context;
@@ -17,13 +25,15 @@ bool AtlasData::pointCb(MapEntry *map, void *context)
 		data->points(ctx->rect, ctx->points);
 
 		ctx->cacheLock.lock();
-		ctx->cache.insert(map->path, data);
+		ctx->cache.insert(map->path, data, cost(map->path));
 	} else
 		cached->points(ctx->rect, ctx->points);
 
 	ctx->cacheLock.unlock();
 	map->lock.unlock();
 
+	CacheBudget::enforce();
+
 	return true;
 }
 
@@ -43,7 +53,7 @@ bool AtlasData::polyCb(MapEntry *map, void *context)
 		data->lines(ctx->rect, ctx->lines);
 
 		ctx->cacheLock.lock();
-		ctx->cache.insert(map->path, data);
+		ctx->cache.insert(map->path, data, cost(map->path));
 	} else {
 		cached->polygons(ctx->rect, ctx->polygons);
 		cached->lines(ctx->rect, ctx->lines);
@@ -52,14 +62,15 @@ bool AtlasData::polyCb(MapEntry *map, void *context)
 	ctx->cacheLock.unlock();
 	map->lock.unlock();
 
+	CacheBudget::enforce();
+
 	return true;
 }
 
 AtlasData::~AtlasData()
 {
-	MapTree::Iterator it;
-	for (_tree.GetFirst(it); !_tree.IsNull(it); _tree.GetNext(it))
-		delete _tree.GetAt(it);
+	for (int i = 0; i < _tree.Count(); i++)
+		delete _tree.At(i);
 }
 
 void AtlasData::addMap(const RectC &bounds, const QString &path)
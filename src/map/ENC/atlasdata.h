@@ -1,14 +1,14 @@
 #ifndef ENC_ATLASDATA_H
 #define ENC_ATLASDATA_H
 
-#include <QCache>
 #include <QMutex>
-#include "common/rtree.h"
+#include "common/packedrtree.h"
+#include "map/cachebudget.h"
 #include "mapdata.h"
 
 namespace ENC {
 
-typedef QCache<QString, MapData> MapCache;
+typedef BudgetCache<QString, MapData> MapCache;
 
 class AtlasData
 {
@@ -18,6 +18,8 @@ public:
 	~AtlasData();
 
 	void addMap(const RectC &bounds, const QString &path);
+	/* Must be called after the last addMap() */
+	void createIndex() {_tree.Pack();}
 
 	void polys(const RectC &rect, QList<MapData::Poly> *polygons,
 	  QList<MapData::Line> *lines);
@@ -31,7 +33,7 @@ private:
 		QMutex lock;
 	};
 
-	typedef RTree<MapEntry*, double, 2> MapTree;
+	typedef PackedRTree<MapEntry*> MapTree;
 
 	struct PolyCTX
 	{
@@ -61,6 +63,7 @@ private:
 
 	static bool polyCb(MapEntry *map, void *context);
 	static bool pointCb(MapEntry *map, void *context);
+	static qint64 cost(const QString &path);
 
 	MapTree _tree;
 	MapCache &_cache;
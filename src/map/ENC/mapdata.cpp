@@ -849,21 +849,20 @@ MapData::MapData(const QString &path)
 				break;
 		}
 	}
+
+	_points.Pack();
+	_lines.Pack();
+	_areas.Pack();
 }
 
 MapData::~MapData()
 {
-	LineTree::Iterator lit;
-	for (_lines.GetFirst(lit); !_lines.IsNull(lit); _lines.GetNext(lit))
-		delete _lines.GetAt(lit);
-
-	PolygonTree::Iterator ait;
-	for (_areas.GetFirst(ait); !_areas.IsNull(ait); _areas.GetNext(ait))
-		delete _areas.GetAt(ait);
-
-	PointTree::Iterator pit;
-	for (_points.GetFirst(pit); !_points.IsNull(pit); _points.GetNext(pit))
-		delete _points.GetAt(pit);
+	for (int i = 0; i < _lines.Count(); i++)
+		delete _lines.At(i);
+	for (int i = 0; i < _areas.Count(); i++)
+		delete _areas.At(i);
+	for (int i = 0; i < _points.Count(); i++)
+		delete _points.At(i);
 }
 
 void MapData::points(const RectC &rect, QList<Point> *points) const
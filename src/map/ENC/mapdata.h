@@ -2,7 +2,7 @@
 #define ENC_MAPDATA_H
 
 #include "common/rectc.h"
-#include "common/rtree.h"
+#include "common/packedrtree.h"
 #include "common/polygon.h"
 #include "iso8211.h"
 
@@ -89,9 +89,10 @@ private:
 
 	typedef QMap<uint, ISO8211::Record> RecordMap;
 	typedef QMap<uint, ISO8211::Record>::const_iterator RecordMapIterator;
-	typedef RTree<const Poly*, double, 2> PolygonTree;
-	typedef RTree<const Line*, double, 2> LineTree;
-	typedef RTree<const Point*, double, 2> PointTree;
+	typedef PackedRTree<const Poly*> PolygonTree;
+	typedef PackedRTree<const Line*> LineTree;
+	/* Float bounds, there are usually lots of soundings */
+	typedef PackedRTree<const Point*, double, float> PointTree;
 
 	static QVector<Sounding> soundings(const ISO8211::Record &r, uint COMF,
 	  uint SOMF);
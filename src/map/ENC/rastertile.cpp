@@ -1,5 +1,7 @@
 #include <QtMath>
 #include <QPainter>
+#include <QVarLengthArray>
+#include "common/trace.h"
 #include "map/bitmapline.h"
 #include "map/textpathitem.h"
 #include "map/textpointitem.h"
@@ -41,6 +43,14 @@ static bool showLabel(const QImage *img, const Range &range, int zoom, int type)
 	return true;
 }
 
+void RasterTile::ll2xy(const Coordinates *c, QPointF *p, int n) const
+{
+	QVarLengthArray<PointD, 256> xy(n);
+
+	_proj.ll2xy(c, xy.data(), n);
+	_transform.proj2img(xy.constData(), p, n);
+}
+
 QPainterPath RasterTile::painterPath(const Polygon &polygon) const
 {
 	QPainterPath path;
@@ -48,14 +58,16 @@ QPainterPath RasterTile::painterPath(const Polygon &polygon) const
 	for (int i = 0; i < polygon.size(); i++) {
 		const QVector<Coordinates> &subpath = polygon.at(i);
 
-		QVector<QPointF> p;
-		p.reserve(subpath.size());
+		QVector<QPointF> p(subpath.size());
+		ll2xy(subpath.constData(), p.data(), subpath.size());
+
+		/* Remove the null (mask) points */
+		int size = 0;
+		for (int j = 0; j < subpath.size(); j++)
+			if (!subpath.at(j).isNull())
+				p[size++] = p.at(j);
+		p.resize(size);
 
-		for (int j = 0; j < subpath.size(); j++) {
-			const Coordinates &c = subpath.at(j);
-			if (!c.isNull())
-				p.append(ll2xy(c));
-		}
 		path.addPolygon(p);
 	}
 
@@ -64,11 +76,8 @@ QPainterPath RasterTile::painterPath(const Polygon &polygon) const
 
 QPolygonF RasterTile::polyline(const QVector<Coordinates> &path) const
 {
-	QPolygonF polygon;
-	polygon.reserve(path.size());
-
-	for (int i = 0; i < path.size(); i++)
-		polygon.append(ll2xy(path.at(i)));
+	QPolygonF polygon(path.size());
+	ll2xy(path.constData(), polygon.data(), path.size());
 
 	return polygon;
 }
@@ -77,9 +86,11 @@ QVector<QPolygonF> RasterTile::polylineM(const QVector<Coordinates> &path) const
 {
 	QVector<QPolygonF> polys;
 	QPolygonF polygon;
+	QVarLengthArray<QPointF, 256> xy(path.size());
 	bool mask = false;
 
 	polygon.reserve(path.size());
+	ll2xy(path.constData(), xy.data(), path.size());
 
 	for (int i = 0; i < path.size(); i++) {
 		const Coordinates &c = path.at(i);
@@ -93,7 +104,7 @@ QVector<QPolygonF> RasterTile::polylineM(const QVector<Coordinates> &path) const
 				mask = true;
 			}
 		} else if (!mask)
-			polygon.append(ll2xy(c));
+			polygon.append(xy.at(i));
 	}
 
 	if (!polygon.isEmpty())
@@ -380,6 +391,9 @@ void RasterTile::fetchData(QList<MapData::Poly> &polygons,
 
 void RasterTile::render()
 {
+	TRACE_SCOPE("ENC::RasterTile::render");
+	TRACE_COUNT("tiles rendered", 1);
+
 	QImage img(_rect.width() * _ratio, _rect.height() * _ratio,
 	  QImage::Format_ARGB32_Premultiplied);
 	QList<MapData::Line> lines;
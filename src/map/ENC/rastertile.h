@@ -18,17 +18,20 @@ class RasterTile
 public:
 	RasterTile(const Projection &proj, const Transform &transform,
 	  const Style *style, const MapData *data, int zoom, const Range &zoomRange,
-	  const QRect &rect, qreal ratio) :
+	  const QRect &rect, qreal ratio, const QString &key) :
 		_proj(proj), _transform(transform), _style(style), _map(data), _atlas(0),
-		_zoom(zoom), _zoomRange(zoomRange), _rect(rect), _ratio(ratio) {}
+		_zoom(zoom), _zoomRange(zoomRange), _rect(rect), _ratio(ratio),
+		_key(key) {}
 	RasterTile(const Projection &proj, const Transform &transform,
 	  const Style *style, AtlasData *data, int zoom, const Range &zoomRange,
-	  const QRect &rect, qreal ratio) :
+	  const QRect &rect, qreal ratio, const QString &key) :
 		_proj(proj), _transform(transform), _style(style), _map(0), _atlas(data),
-		_zoom(zoom), _zoomRange(zoomRange), _rect(rect), _ratio(ratio) {}
+		_zoom(zoom), _zoomRange(zoomRange), _rect(rect), _ratio(ratio),
+		_key(key) {}
 
 	int zoom() const {return _zoom;}
 	QPoint xy() const {return _rect.topLeft();}
+	const QString &key() const {return _key;}
 	const QPixmap &pixmap() const {return _pixmap;}
 
 	void render();
@@ -55,6 +58,7 @@ private:
 	  QList<MapData::Point> &points);
 	QPointF ll2xy(const Coordinates &c) const
 	  {return _transform.proj2img(_proj.ll2xy(c));}
+	void ll2xy(const Coordinates *c, QPointF *p, int n) const;
 	QPainterPath painterPath(const Polygon &polygon) const;
 	QPolygonF polyline(const QVector<Coordinates> &path) const;
 	QVector<QPolygonF> polylineM(const QVector<Coordinates> &path) const;
@@ -83,6 +87,7 @@ private:
 	Range _zoomRange;
 	QRect _rect;
 	qreal _ratio;
+	QString _key;
 	QPixmap _pixmap;
 };
 
@@ -94,6 +94,8 @@ DEMTree::DEMTree(const QList<MapData::Elevation> &tiles)
 
 		_tree.Insert(min, max, &e);
 	}
+
+	_tree.Pack();
 }
 
 double DEMTree::elevation(const Coordinates &c) const
@@ -134,6 +134,7 @@ GMAPData::GMAPData(const QString &fileName) : MapData(fileName)
 		if (fi.isDir())
 			loadTile(QDir(fi.absoluteFilePath()));
 	}
+	_tileTree.Pack();
 
 	if (baseDir.exists(typFilePath))
 		_typ = new SubFile(baseDir.filePath(typFilePath));
@@ -163,6 +163,8 @@ bool IMGData::createTileTree(QFile *file, const TileMap &tileMap)
 		_hasDEM |= tile->hasDem();
 	}
 
+	_tileTree.Pack();
+
 	return (_tileTree.Count() > 0);
 }
 
@@ -113,6 +113,10 @@ void LBLFile::clear()
 	_rasters = QVector<Image>();
 	delete _huffmanText;
 	_huffmanText = 0;
+
+	_labelsLock.lock();
+	_labels.clear();
+	_labelsLock.unlock();
 }
 
 Label LBLFile::str2label(const QVector<quint8> &str, bool capitalize,
@@ -158,9 +162,15 @@ Label LBLFile::str2label(const QVector<quint8> &str, bool capitalize,
 		}
 	} else if (convert)
 		label = ft2m(label, &ok);
+	/* The decoder is stateful and the labels are decoded from multiple
+	   threads at once */
+	_codecLock.lock();
 	QString text(_codec.toString(label));
+	QString shieldText(_codec.toString(shieldLabel));
+	_codecLock.unlock();
+
 	return Label(capitalize && isAllUpperCase(text) ? capitalized(text) : text,
-	  Shield(shieldType, _codec.toString(shieldLabel)));
+	  Shield(shieldType, shieldText));
 }
 
 Label LBLFile::label6b(const SubFile *file, Handle &fileHdl, quint32 size,
@@ -318,6 +328,33 @@ Label LBLFile::labelHuffman(Handle &hdl, const SubFile *file, Handle &fileHdl,
 
 Label LBLFile::label(Handle &hdl, quint32 offset, bool poi, bool capitalize,
   bool convert)
+{
+	quint64 key = offset | (quint64)poi << 32 | (quint64)capitalize << 33
+	  | (quint64)convert << 34;
+
+	_labelsLock.lock();
+	Label *cached = _labels.object(key);
+	if (cached) {
+		Label label(*cached);
+		_labelsLock.unlock();
+		return label;
+	}
+	_labelsLock.unlock();
+
+	Label label(decodeLabel(hdl, offset, poi, capitalize, convert));
+	qint64 cost = sizeof(Label) + (label.text().size()
+	  + label.shield().text().size()) * sizeof(QChar);
+
+	_labelsLock.lock();
+	_labels.insert(key, new Label(label), cost);
+	_labelsLock.unlock();
+	CacheBudget::enforce();
+
+	return label;
+}
+
+Label LBLFile::decodeLabel(Handle &hdl, quint32 offset, bool poi,
+  bool capitalize, bool convert)
 {
 	quint32 labelOffset;
 	if (poi) {
@@ -2,7 +2,9 @@
 #define IMG_LBLFILE_H
 
 #include <QPixmap>
+#include <QMutex>
 #include "common/textcodec.h"
+#include "map/cachebudget.h"
 #include "section.h"
 #include "subfile.h"
 #include "label.h"
@@ -17,13 +19,13 @@ class LBLFile : public SubFile
 public:
 	LBLFile(const IMGData *img)
 	  : SubFile(img), _huffmanText(0), _imgIdSize(0), _poiShift(0), _shift(0),
-	  _encoding(0) {}
+	  _encoding(0), _labels("IMG labels", &_labelsLock) {}
 	LBLFile(const QString &path)
 	  : SubFile(path), _huffmanText(0), _imgIdSize(0), _poiShift(0), _shift(0),
-	  _encoding(0) {}
+	  _encoding(0), _labels("IMG labels", &_labelsLock) {}
 	LBLFile(const SubFile *gmp, quint32 offset)
 	  : SubFile(gmp, offset), _huffmanText(0), _imgIdSize(0), _poiShift(0),
-	  _shift(0), _encoding(0) {}
+	  _shift(0), _encoding(0), _labels("IMG labels", &_labelsLock) {}
 	~LBLFile();
 
 	bool load(Handle &hdl, const RGNFile *rgn, Handle &rgnHdl);
@@ -51,6 +53,8 @@ private:
 	  bool capitalize, bool convert);
 	Label labelHuffman(Handle &hdl, const SubFile *file, Handle &fileHdl,
 	  quint32 size, bool capitalize, bool convert);
+	Label decodeLabel(Handle &hdl, quint32 offset, bool poi, bool capitalize,
+	  bool convert);
 	bool loadRasterTable(Handle &hdl, quint32 offset, quint32 size,
 	  quint32 recordSize);
 
@@ -58,11 +62,17 @@ private:
 	QVector<Image> _rasters;
 	QVector<quint32> _table;
 	TextCodec _codec;
+	QMutex _codecLock;
 	Section _base, _poi, _img;
 	quint8 _imgIdSize;
 	quint8 _poiShift;
 	quint8 _shift;
 	quint8 _encoding;
+
+	/* Decoded labels by their offset and decoding flags. The labels (their
+	   texts) are implicitly shared by all the objects referencing them. */
+	QMutex _labelsLock;
+	BudgetCache<quint64, Label> _labels;
 };
 
 }
@@ -7,8 +7,17 @@
 
 using namespace IMG;
 
-#define CACHED_SUBDIVS_COUNT  2048 // ~32MB for both caches together
-#define CACHED_DEMTILES_COUNT 1024 // ~32MB
+/* The label texts are not counted, they are shared with the LBL file label
+   cache which is a part of the cache budget itself */
+static qint64 polysCost(const QList<MapData::Poly> &list)
+{
+	qint64 cost = list.size() * sizeof(MapData::Poly);
+
+	for (int i = 0; i < list.size(); i++)
+		cost += list.at(i).points.size() * sizeof(QPointF);
+
+	return cost;
+}
 
 bool MapData::polyCb(VectorTile *tile, void *context)
 {
@@ -35,18 +44,16 @@ bool MapData::elevationCb(VectorTile *tile, void *context)
 }
 
 MapData::MapData(const QString &fileName)
-  : _fileName(fileName), _typ(0), _style(0), _hasDEM(false), _valid(false)
+  : _fileName(fileName), _typ(0), _style(0), _hasDEM(false), _valid(false),
+  _polyCache("IMG polygons", &_lock), _pointCache("IMG points", &_lock),
+  _demCache("IMG DEM", &_demLock)
 {
-	_polyCache.setMaxCost(CACHED_SUBDIVS_COUNT);
-	_pointCache.setMaxCost(CACHED_SUBDIVS_COUNT);
-	_demCache.setMaxCost(CACHED_DEMTILES_COUNT);
 }
 
 MapData::~MapData()
 {
-	TileTree::Iterator it;
-	for (_tileTree.GetFirst(it); !_tileTree.IsNull(it); _tileTree.GetNext(it))
-		delete _tileTree.GetAt(it);
+	for (int i = 0; i < _tileTree.Count(); i++)
+		delete _tileTree.At(i);
 
 	delete _typ;
 	delete _style;
@@ -112,27 +119,29 @@ void MapData::load(qreal ratio)
 
 void MapData::clear()
 {
-	TileTree::Iterator it;
-	for (_tileTree.GetFirst(it); !_tileTree.IsNull(it); _tileTree.GetNext(it))
-		_tileTree.GetAt(it)->clear();
+	for (int i = 0; i < _tileTree.Count(); i++)
+		_tileTree.At(i)->clear();
 
 	delete _style;
 	_style = 0;
 
+	_lock.lock();
 	_polyCache.clear();
 	_pointCache.clear();
+	_lock.unlock();
+	_demLock.lock();
 	_demCache.clear();
+	_demLock.unlock();
 }
 
 void MapData::computeZooms()
 {
-	TileTree::Iterator it;
 	QSet<Zoom> zooms;
 
-	for (_tileTree.GetFirst(it); !_tileTree.IsNull(it); _tileTree.GetNext(it)) {
-		const QVector<Zoom> &z = _tileTree.GetAt(it)->zooms();
-		for (int i = 0; i < z.size(); i++)
-			zooms.insert(z.at(i));
+	for (int i = 0; i < _tileTree.Count(); i++) {
+		const QVector<Zoom> &z = _tileTree.At(i)->zooms();
+		for (int j = 0; j < z.size(); j++)
+			zooms.insert(z.at(j));
 	}
 
 	if (zooms.isEmpty())
@@ -152,6 +161,31 @@ void MapData::computeZooms()
 	  : qMax(0, _zooms.first().bits() - 2), 28);
 }
 
+qint64 MapData::cost(const Polys *polys)
+{
+	return sizeof(Polys) + polysCost(polys->polygons) + polysCost(polys->lines);
+}
+
+qint64 MapData::cost(const QList<Point> *points)
+{
+	qint64 cost = points->size() * sizeof(Point);
+
+	for (int i = 0; i < points->size(); i++) {
+		const Point &point = points->at(i);
+
+		for (int j = 0; j < point.lights.size(); j++)
+			cost += sizeof(Light) + point.lights.at(j).sectors().size()
+			  * sizeof(Light::Sector);
+	}
+
+	return cost;
+}
+
+qint64 MapData::cost(const Elevation *elevation)
+{
+	return sizeof(Elevation) + elevation->m.size() * sizeof(qint16);
+}
+
 const Zoom &MapData::zoom(int bits) const
 {
 	int id = 0;
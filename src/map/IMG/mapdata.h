@@ -3,15 +3,15 @@
 
 #include <QList>
 #include <QPointF>
-#include <QCache>
 #include <QMutex>
 #include <QFile>
 #include <QDebug>
 #include "common/rectc.h"
-#include "common/rtree.h"
+#include "common/packedrtree.h"
 #include "common/range.h"
 #include "common/hash.h"
 #include "map/matrix.h"
+#include "map/cachebudget.h"
 #include "label.h"
 #include "raster.h"
 #include "light.h"
@@ -96,7 +96,7 @@ public:
 	QString errorString() const {return _errorString;}
 
 protected:
-	typedef RTree<VectorTile*, double, 2> TileTree;
+	typedef PackedRTree<VectorTile*> TileTree;
 
 	void computeZooms();
 
@@ -119,9 +119,9 @@ private:
 		QList<Poly> lines;
 	};
 
-	typedef QCache<const SubDiv*, Polys> PolyCache;
-	typedef QCache<const SubDiv*, QList<Point> > PointCache;
-	typedef QCache<const DEMTile*, Elevation> ElevationCache;
+	typedef BudgetCache<const SubDiv*, Polys> PolyCache;
+	typedef BudgetCache<const SubDiv*, QList<Point> > PointCache;
+	typedef BudgetCache<const DEMTile*, Elevation> ElevationCache;
 
 	struct PolyCTX
 	{
@@ -176,10 +176,15 @@ private:
 	static bool pointCb(VectorTile *tile, void *context);
 	static bool elevationCb(VectorTile *tile, void *context);
 
+	static qint64 cost(const Polys *polys);
+	static qint64 cost(const QList<Point> *points);
+	static qint64 cost(const Elevation *elevation);
+
+	/* The locks must outlive the caches (budget eviction) */
+	QMutex _lock, _demLock;
 	PolyCache _polyCache;
 	PointCache _pointCache;
 	ElevationCache _demCache;
-	QMutex _lock, _demLock;
 
 	friend class VectorTile;
 };
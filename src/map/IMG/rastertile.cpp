@@ -1,7 +1,9 @@
 #include <QFont>
 #include <QPainter>
+#include <QVarLengthArray>
 #include <QCache>
 #include "common/util.h"
+#include "common/trace.h"
 #include "map/dem.h"
 #include "map/textpathitem.h"
 #include "map/textpointitem.h"
@@ -111,14 +113,27 @@ const QFont *RasterTile::poiFont(Style::FontSize size, int zoom,
 	}
 }
 
+void RasterTile::ll2xy(const Coordinates *c, QPointF *p, int n) const
+{
+	QVarLengthArray<PointD, 256> xy(n);
+
+	_proj.ll2xy(c, xy.data(), n);
+	_transform.proj2img(xy.constData(), p, n);
+}
+
 void RasterTile::ll2xy(QList<MapData::Poly> &polys) const
 {
+	QVarLengthArray<Coordinates, 256> c;
+
 	for (int i = 0; i < polys.size(); i++) {
 		MapData::Poly &poly = polys[i];
+
+		c.resize(poly.points.size());
 		for (int j = 0; j < poly.points.size(); j++) {
-			QPointF &p = poly.points[j];
-			p = ll2xy(Coordinates(p.x(), p.y()));
+			const QPointF &p = poly.points.at(j);
+			c[j] = Coordinates(p.x(), p.y());
 		}
+		ll2xy(c.constData(), poly.points.data(), c.size());
 	}
 }
 
@@ -639,6 +654,9 @@ void RasterTile::drawHillShading(QPainter *painter) const
 
 void RasterTile::render()
 {
+	TRACE_SCOPE("IMG::RasterTile::render");
+	TRACE_COUNT("tiles rendered", 1);
+
 	QImage img(_rect.width() * _ratio, _rect.height() * _ratio,
 	  QImage::Format_ARGB32_Premultiplied);
 	QList<MapData::Poly> polygons;
@@ -61,6 +61,7 @@ private:
 	  QList<MapData::Point> &points);
 	QPointF ll2xy(const Coordinates &c) const
 	  {return _transform.proj2img(_proj.ll2xy(c));}
+	void ll2xy(const Coordinates *c, QPointF *p, int n) const;
 	Coordinates xy2ll(const QPointF &p) const
 	  {return _proj.xy2ll(_transform.img2proj(p));}
 	void ll2xy(QList<MapData::Poly> &polys) const;
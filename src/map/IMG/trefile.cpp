@@ -214,6 +214,7 @@ bool TREFile::load(QFile *file, int idx)
 
 		tree->Insert(min, max, s);
 	}
+	tree->Pack();
 
 	if (idx != _levels.size() - 1) {
 		quint32 offset;
@@ -268,13 +269,11 @@ error:
 
 void TREFile::clear()
 {
-	SubDivTree::Iterator jt;
-
 	for (QMap<int, SubDivTree*>::iterator it = _subdivs.begin();
 	  it != _subdivs.end(); ++it) {
 		SubDivTree *tree = *it;
-		for (tree->GetFirst(jt); !tree->IsNull(jt); tree->GetNext(jt))
-			delete tree->GetAt(jt);
+		for (int i = 0; i < tree->Count(); i++)
+			delete tree->At(i);
 	}
 
 	qDeleteAll(_subdivs);
@@ -5,7 +5,7 @@
 #include <QDebug>
 #include <QRect>
 #include "common/rectc.h"
-#include "common/rtree.h"
+#include "common/packedrtree.h"
 #include "section.h"
 #include "subfile.h"
 
@@ -39,7 +39,7 @@ private:
 		quint8 bits;
 		quint16 subdivs;
 	};
-	typedef RTree<SubDiv*, double, 2> SubDivTree;
+	typedef PackedRTree<SubDiv*> SubDivTree;
 
 	bool load(QFile *file, int idx);
 	const SubDivTree *subdivs(QFile *file, const Zoom &zoom);
@@ -1,3 +1,4 @@
+#include "common/trace.h"
 #include "vectortile.h"
 
 using namespace IMG;
@@ -121,42 +122,71 @@ void VectorTile::clear()
 	_demLoaded = 0;
 }
 
-void VectorTile::polys(QFile *file, const RectC &rect, const Zoom &zoom,
-  QList<MapData::Poly> *polygons, QList<MapData::Poly> *lines,
-  MapData::PolyCache *cache, QMutex *cacheLock)
+/* Loads the tile subfiles and initializes the subdivs covering rect. This is
+   the only part requiring the tile lock, the subdivs data decoding does not
+   modify the tile. */
+bool VectorTile::initSubdivs(QFile *file, const RectC &rect, const Zoom &zoom,
+  QList<SubDiv*> &subdivs)
 {
-	SubFile::Handle *rgnHdl = 0, *lblHdl = 0, *netHdl = 0, *nodHdl = 0,
-	  *nodHdl2 = 0;
-
-	_lock.lock();
+	TRACE_LOCK(_lock);
 
 	if (_loaded < 0) {
 		_lock.unlock();
-		return;
+		return false;
 	}
 
+	SubFile::Handle rgnHdl(_rgn, file);
+
 	if (!_loaded) {
-		rgnHdl = new SubFile::Handle(_rgn, file);
-		lblHdl = new SubFile::Handle(_lbl, file);
-		netHdl = new SubFile::Handle(_net, file);
-		nodHdl = new SubFile::Handle(_nod, file);
+		SubFile::Handle lblHdl(_lbl, file);
+		SubFile::Handle netHdl(_net, file);
+		SubFile::Handle nodHdl(_nod, file);
 
-		if (!load(*rgnHdl, *lblHdl, *netHdl, *nodHdl)) {
+		if (!load(rgnHdl, lblHdl, netHdl, nodHdl)) {
 			_lock.unlock();
-			delete rgnHdl; delete lblHdl; delete netHdl; delete nodHdl;
-			return;
+			return false;
 		}
 	}
 
-	QList<SubDiv*> subdivs = _tre->subdivs(file, rect, zoom);
+	subdivs = _tre->subdivs(file, rect, zoom);
+	for (int i = 0; i < subdivs.size(); i++) {
+		SubDiv *subdiv = subdivs.at(i);
+		if (!subdiv->initialized())
+			_rgn->subdivInit(rgnHdl, subdiv);
+	}
+
+	_lock.unlock();
+
+	return true;
+}
+
+void VectorTile::polys(QFile *file, const RectC &rect, const Zoom &zoom,
+  QList<MapData::Poly> *polygons, QList<MapData::Poly> *lines,
+  MapData::PolyCache *cache, QMutex *cacheLock)
+{
+	SubFile::Handle *rgnHdl = 0, *lblHdl = 0, *netHdl = 0, *nodHdl = 0,
+	  *nodHdl2 = 0;
+	QList<SubDiv*> subdivs;
+
+	if (!initSubdivs(file, rect, zoom, subdivs))
+		return;
 
 	cacheLock->lock();
 
 	for (int i = 0; i < subdivs.size(); i++) {
 		SubDiv *subdiv = subdivs.at(i);
+		if (!subdiv->initialized())
+			continue;
+
+		/* Never decode a subdiv that is already being decoded by another
+		   worker, wait for its data instead */
+		MapData::Polys *polys;
+		while (!(polys = cache->object(subdiv))
+		  && _polysLoading.contains(subdiv))
+			_subdivLoaded.wait(cacheLock);
 
-		MapData::Polys *polys = cache->object(subdiv);
 		if (!polys) {
+			_polysLoading.insert(subdiv);
 			cacheLock->unlock();
 
 			quint32 shift = _tre->shift(subdiv->bits());
@@ -167,11 +197,6 @@ void VectorTile::polys(QFile *file, const RectC &rect, const Zoom &zoom,
 				netHdl = new SubFile::Handle(_net, file);
 			}
 
-			if (!subdiv->initialized() && !_rgn->subdivInit(*rgnHdl, subdiv)) {
-				cacheLock->lock();
-				continue;
-			}
-
 			polys = new MapData::Polys();
 
 			_rgn->polyObjects(*rgnHdl, subdiv, RGNFile::Polygon, _lbl, *lblHdl,
@@ -197,7 +222,9 @@ void VectorTile::polys(QFile *file, const RectC &rect, const Zoom &zoom,
 				copyPolys(rect, &polys->lines, lines);
 
 			cacheLock->lock();
-			cache->insert(subdiv, polys);
+			cache->insert(subdiv, polys, MapData::cost(polys));
+			_polysLoading.remove(subdiv);
+			_subdivLoaded.wakeAll();
 		} else {
 			copyPolys(rect, &polys->polygons, polygons);
 			if (lines)
@@ -206,7 +233,8 @@ void VectorTile::polys(QFile *file, const RectC &rect, const Zoom &zoom,
 	}
 
 	cacheLock->unlock();
-	_lock.unlock();
+
+	CacheBudget::enforce();
 
 	delete rgnHdl; delete lblHdl; delete netHdl; delete nodHdl; delete nodHdl2;
 }
@@ -215,36 +243,25 @@ void VectorTile::points(QFile *file, const RectC &rect, const Zoom &zoom,
   QList<MapData::Point> *points, MapData::PointCache *cache, QMutex *cacheLock)
 {
 	SubFile::Handle *rgnHdl = 0, *lblHdl = 0;
+	QList<SubDiv*> subdivs;
 
-	_lock.lock();
-
-	if (_loaded < 0) {
-		_lock.unlock();
+	if (!initSubdivs(file, rect, zoom, subdivs))
 		return;
-	}
-
-	if (!_loaded) {
-		rgnHdl = new SubFile::Handle(_rgn, file);
-		lblHdl = new SubFile::Handle(_lbl, file);
-		SubFile::Handle nodHdl(_nod, file);
-		SubFile::Handle netHdl(_net, file);
-
-		if (!load(*rgnHdl, *lblHdl, netHdl, nodHdl)) {
-			_lock.unlock();
-			delete rgnHdl; delete lblHdl;
-			return;
-		}
-	}
-
-	QList<SubDiv*> subdivs = _tre->subdivs(file, rect, zoom);
 
 	cacheLock->lock();
 
 	for (int i = 0; i < subdivs.size(); i++) {
 		SubDiv *subdiv = subdivs.at(i);
+		if (!subdiv->initialized())
+			continue;
+
+		QList<MapData::Point> *pl;
+		while (!(pl = cache->object(subdiv))
+		  && _pointsLoading.contains(subdiv))
+			_subdivLoaded.wait(cacheLock);
 
-		QList<MapData::Point> *pl = cache->object(subdiv);
 		if (!pl) {
+			_pointsLoading.insert(subdiv);
 			cacheLock->unlock();
 
 			if (!rgnHdl) {
@@ -252,11 +269,6 @@ void VectorTile::points(QFile *file, const RectC &rect, const Zoom &zoom,
 				lblHdl = new SubFile::Handle(_lbl, file);
 			}
 
-			if (!subdiv->initialized() && !_rgn->subdivInit(*rgnHdl, subdiv)) {
-				cacheLock->lock();
-				continue;
-			}
-
 			pl = new QList<MapData::Point>;
 
 			_rgn->pointObjects(*rgnHdl, subdiv, RGNFile::Point, _lbl, *lblHdl,
@@ -268,13 +280,16 @@ void VectorTile::points(QFile *file, const RectC &rect, const Zoom &zoom,
 			copyPoints(rect, pl, points);
 
 			cacheLock->lock();
-			cache->insert(subdiv, pl);
+			cache->insert(subdiv, pl, MapData::cost(pl));
+			_pointsLoading.remove(subdiv);
+			_subdivLoaded.wakeAll();
 		} else
 			copyPoints(rect, pl, points);
 	}
 
 	cacheLock->unlock();
-	_lock.unlock();
+
+	CacheBudget::enforce();
 
 	delete rgnHdl; delete lblHdl;
 }
@@ -325,7 +340,7 @@ void VectorTile::elevations(QFile *file, const RectC &rect, const Zoom &zoom,
 				elevations->append(*el);
 
 			cacheLock->lock();
-			cache->insert(tile, el);
+			cache->insert(tile, el, MapData::cost(el));
 		} else {
 			if (!el->m.isNull())
 				elevations->append(*el);
@@ -335,6 +350,8 @@ void VectorTile::elevations(QFile *file, const RectC &rect, const Zoom &zoom,
 	cacheLock->unlock();
 	_demLock.unlock();
 
+	CacheBudget::enforce();
+
 	delete hdl;
 }
 
@@ -1,6 +1,8 @@
 #ifndef IMG_VECTORTILE_H
 #define IMG_VECTORTILE_H
 
+#include <QSet>
+#include <QWaitCondition>
 #include "trefile.h"
 #include "rgnfile.h"
 #include "lblfile.h"
@@ -95,6 +97,8 @@ private:
 	bool load(SubFile::Handle &rgnHdl, SubFile::Handle &lblHdl,
 	  SubFile::Handle &netHdl, SubFile::Handle &nodHdl);
 	bool loadDem(SubFile::Handle &demHdl);
+	bool initSubdivs(QFile *file, const RectC &rect, const Zoom &zoom,
+	  QList<SubDiv*> &subdivs);
 
 	TREFile *_tre;
 	RGNFile *_rgn;
@@ -106,6 +110,10 @@ private:
 
 	int _loaded, _demLoaded;
 	QMutex _lock, _demLock;
+
+	/* Subdivs being decoded, protected by the MapData cache lock */
+	QSet<const SubDiv*> _polysLoading, _pointsLoading;
+	QWaitCondition _subdivLoaded;
 };
 
 }
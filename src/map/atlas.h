@@ -27,6 +27,7 @@ public:
 	int zoomOut();
 
 	QPointF ll2xy(const Coordinates &c);
+	bool ll2xyIsReentrant() const {return false;}
 	Coordinates xy2ll(const QPointF &p);
 
 	void draw(QPainter *painter, const QRectF &rect, Flags flags);
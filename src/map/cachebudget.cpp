@@ -0,0 +1,108 @@
+#include <QMap>
+#include "cachebudget.h"
+
+/* The caches are trimmed below the limit so that the eviction does not run
+   on every insert once the budget has been reached */
+#define TRIM_RATIO 0.9
+
+struct Registry
+{
+	QList<CacheBudget::Client*> clients;
+	QMutex lock;
+};
+
+/* Function-local static as the caches may be static objects themselves */
+static Registry &registry()
+{
+	static Registry r;
+	return r;
+}
+
+QAtomicInteger<qint64> CacheBudget::_limit(512 * 1024 * 1024);
+QAtomicInteger<qint64> CacheBudget::_size(0);
+
+void CacheBudget::setLimit(qint64 bytes)
+{
+	_limit.storeRelaxed(bytes);
+	enforce();
+}
+
+void CacheBudget::add(Client *client)
+{
+	Registry &r = registry();
+
+	r.lock.lock();
+	r.clients.append(client);
+	r.lock.unlock();
+}
+
+void CacheBudget::remove(Client *client, qint64 size)
+{
+	Registry &r = registry();
+
+	r.lock.lock();
+	r.clients.removeOne(client);
+	_size.fetchAndAddRelaxed(-size);
+	r.lock.unlock();
+}
+
+void CacheBudget::enforce()
+{
+	if (_size.loadRelaxed() <= _limit.loadRelaxed())
+		return;
+
+	Registry &r = registry();
+	/* Another thread is already evicting */
+	if (!r.lock.tryLock())
+		return;
+
+	qint64 size = _size.loadRelaxed();
+	qint64 target = (qint64)(_limit.loadRelaxed() * TRIM_RATIO);
+
+	if (size > target) {
+		double ratio = (double)target / (double)size;
+
+		for (int i = 0; i < r.clients.size(); i++) {
+			Client *c = r.clients.at(i);
+
+			c->_lock->lock();
+			c->trim((qint64)(c->size() * ratio));
+			c->_lock->unlock();
+		}
+	}
+
+	r.lock.unlock();
+}
+
+/* The stats of caches with the same name (the same cache of different maps)
+   are summed up */
+QList<CacheBudget::Stats> CacheBudget::stats()
+{
+	Registry &r = registry();
+	QMap<QString, Stats> map;
+
+	r.lock.lock();
+	for (int i = 0; i < r.clients.size(); i++) {
+		Client *c = r.clients.at(i);
+		QMap<QString, Stats>::iterator it(map.find(c->name()));
+		if (it == map.end()) {
+			Stats s;
+			s.name = c->name();
+			s.size = 0;
+			s.count = 0;
+			s.hits = 0;
+			s.misses = 0;
+			it = map.insert(c->name(), s);
+		}
+
+		c->_lock->lock();
+		it->size += c->size();
+		it->count += c->count();
+		c->_lock->unlock();
+		it->hits += c->_hits.loadRelaxed();
+		it->misses += c->_misses.loadRelaxed();
+	}
+	r.lock.unlock();
+
+	return map.values();
+}
@@ -0,0 +1,133 @@
+#ifndef CACHEBUDGET_H
+#define CACHEBUDGET_H
+
+#include <climits>
+#include <QString>
+#include <QList>
+#include <QCache>
+#include <QMutex>
+#include <QAtomicInteger>
+
+/* Global memory budget shared by all the map data caches. The caches report
+   the byte size of their entries and once the total size exceeds the limit,
+   the least recently used entries of all the caches are evicted in proportion
+   to the cache sizes. */
+class CacheBudget
+{
+public:
+	class Client
+	{
+	public:
+		Client(const QString &name, QMutex *lock)
+		  : _name(name), _lock(lock), _hits(0), _misses(0) {}
+		virtual ~Client() {}
+
+		const QString &name() const {return _name;}
+
+	protected:
+		/* All the functions are called with the cache lock held */
+		virtual qint64 size() const = 0;
+		virtual int count() const = 0;
+		virtual void trim(qint64 size) = 0;
+
+		void hit() {_hits.fetchAndAddRelaxed(1);}
+		void miss() {_misses.fetchAndAddRelaxed(1);}
+
+	private:
+		QString _name;
+		QMutex *_lock;
+		QAtomicInteger<qint64> _hits, _misses;
+
+		friend class CacheBudget;
+	};
+
+	struct Stats
+	{
+		QString name;
+		qint64 size;
+		int count;
+		qint64 hits;
+		qint64 misses;
+	};
+
+	static void setLimit(qint64 bytes);
+	static qint64 limit() {return _limit.loadRelaxed();}
+	static qint64 size() {return _size.loadRelaxed();}
+
+	/* Must be called after inserting into a cache once the cache lock has
+	   been released, the eviction locks all the caches in turn. */
+	static void enforce();
+
+	static QList<Stats> stats();
+
+	static void add(Client *client);
+	static void remove(Client *client, qint64 size);
+	static void resize(qint64 delta) {_size.fetchAndAddRelaxed(delta);}
+
+private:
+	static QAtomicInteger<qint64> _limit;
+	static QAtomicInteger<qint64> _size;
+};
+
+/* QCache wrapper with the entry costs in bytes taking part in the global cache
+   budget. The cache is guarded by the lock passed to the constructor and all
+   the member functions must be called with the lock held. Qt5 QCache costs
+   are ints, so a single cache can not grow over 2GB. */
+template <class Key, class T>
+class BudgetCache : public CacheBudget::Client
+{
+public:
+	BudgetCache(const QString &name, QMutex *lock) : Client(name, lock)
+	{
+		_cache.setMaxCost(INT_MAX);
+		CacheBudget::add(this);
+	}
+	~BudgetCache() {CacheBudget::remove(this, _cache.totalCost());}
+
+	T *object(const Key &key)
+	{
+		T *obj = _cache.object(key);
+		if (obj)
+			hit();
+		else
+			miss();
+		return obj;
+	}
+
+	bool insert(const Key &key, T *object, qint64 cost)
+	{
+		qint64 before = _cache.totalCost();
+		bool ret = _cache.insert(key, object, (int)qMin(cost, (qint64)INT_MAX));
+		CacheBudget::resize(_cache.totalCost() - before);
+		return ret;
+	}
+
+	void clear()
+	{
+		CacheBudget::resize(-_cache.totalCost());
+		_cache.clear();
+	}
+
+	/* Per-cache limit, the global budget applies as well */
+	void setMaxCost(qint64 cost)
+	{
+		qint64 before = _cache.totalCost();
+		_cache.setMaxCost((int)qMin(cost, (qint64)INT_MAX));
+		CacheBudget::resize(_cache.totalCost() - before);
+	}
+
+protected:
+	qint64 size() const {return _cache.totalCost();}
+	int count() const {return _cache.count();}
+	void trim(qint64 size)
+	{
+		int maxCost = _cache.maxCost();
+		setMaxCost(size);
+		_cache.setMaxCost(maxCost);
+	}
+
+private:
+	QCache<Key, T> _cache;
+};
+
+#endif // CACHEBUDGET_H
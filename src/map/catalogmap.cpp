@@ -0,0 +1,18 @@
+#include "catalogmap.h"
+
+Map *CatalogMap::map()
+{
+	if (!_map) {
+		_map = _parser(path(), _proj, 0);
+		_map->setParent(this);
+
+		if (!_map->isValid())
+			qWarning("%s: %s", qUtf8Printable(path()),
+			  qUtf8Printable(_map->errorString()));
+
+		connect(_map, &Map::tilesLoaded, this, &Map::tilesLoaded);
+		connect(_map, &Map::mapLoaded, this, &Map::mapLoaded);
+	}
+
+	return _map;
+}
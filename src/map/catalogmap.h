@@ -0,0 +1,72 @@
+#ifndef CATALOGMAP_H
+#define CATALOGMAP_H
+
+#include "projection.h"
+#include "map.h"
+
+/* Placeholder for a map whose metadata has been found in the map catalog.
+   The real map is only created when the map is used for the first time. */
+class CatalogMap : public Map
+{
+	Q_OBJECT
+
+public:
+	typedef Map*(*ParserCb)(const QString &, const Projection &, bool *);
+
+	CatalogMap(const QString &path, const QString &name, const RectC &bounds,
+	  ParserCb parser, const Projection &proj, QObject *parent = 0)
+	  : Map(path, parent), _name(name), _bounds(bounds), _parser(parser),
+	  _proj(proj), _map(0) {}
+
+	QString name() const {return _name;}
+
+	bool isValid() const {return _map ? _map->isValid() : true;}
+	bool isReady() const {return _map ? _map->isReady() : true;}
+	QString errorString() const
+	  {return _map ? _map->errorString() : QString();}
+
+	void load(const Projection &in, const Projection &out, qreal deviceRatio,
+	  bool hidpi) {map()->load(in, out, deviceRatio, hidpi);}
+	void unload() {if (_map) _map->unload();}
+
+	RectC llBounds() {return _map ? _map->llBounds() : _bounds;}
+	QRectF bounds() {return map()->bounds();}
+	qreal resolution(const QRectF &rect) {return map()->resolution(rect);}
+
+	int zoom() const {return _map ? _map->zoom() : 0;}
+	void setZoom(int zoom) {map()->setZoom(zoom);}
+	int zoomFit(const QSize &size, const RectC &rect)
+	  {return map()->zoomFit(size, rect);}
+	int zoomIn() {return map()->zoomIn();}
+	int zoomOut() {return map()->zoomOut();}
+
+	QPointF ll2xy(const Coordinates &c) {return map()->ll2xy(c);}
+	Coordinates xy2ll(const QPointF &p) {return map()->xy2ll(p);}
+	bool ll2xyIsReentrant() const
+	  {return _map ? _map->ll2xyIsReentrant() : false;}
+
+	void draw(QPainter *painter, const QRectF &rect, Flags flags)
+	  {map()->draw(painter, rect, flags);}
+	bool prefetch(const QRectF &rect, Flags flags)
+	  {return _map ? _map->prefetch(rect, flags) : true;}
+
+	double elevation(const Coordinates &c) {return map()->elevation(c);}
+
+	void clearCache() {map()->clearCache();}
+
+	bool canSeed() const {return _map ? _map->canSeed() : false;}
+	Range seedZooms() const {return _map ? _map->seedZooms() : Range();}
+	TileSeeder *seeder(const QList<RectC> &area, const Range &zooms)
+	  {return map()->seeder(area, zooms);}
+
+private:
+	Map *map();
+
+	QString _name;
+	RectC _bounds;
+	ParserCb _parser;
+	Projection _proj;
+	Map *_map;
+};
+
+#endif // CATALOGMAP_H
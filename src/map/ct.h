@@ -13,6 +13,26 @@ public:
 
 	virtual PointD ll2xy(const Coordinates &c) const = 0;
 	virtual Coordinates xy2ll(const PointD &p) const = 0;
+
+	/* Array versions of the transformations. Costs a single virtual call per
+	   array instead of per point. */
+	void ll2xy(const Coordinates *c, PointD *p, int n) const
+	  {ll2xyArray(c, p, n);}
+	void xy2ll(const PointD *p, Coordinates *c, int n) const
+	  {xy2llArray(p, c, n);}
+
+protected:
+	/* Projections with a specialized loop reimplement these */
+	virtual void ll2xyArray(const Coordinates *c, PointD *p, int n) const
+	{
+		for (int i = 0; i < n; i++)
+			p[i] = ll2xy(c[i]);
+	}
+	virtual void xy2llArray(const PointD *p, Coordinates *c, int n) const
+	{
+		for (int i = 0; i < n; i++)
+			c[i] = xy2ll(p[i]);
+	}
 };
 
 #endif // CT_H
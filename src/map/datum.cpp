@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "common/wgs84.h"
 #include "datum.h"
 
@@ -116,6 +117,44 @@ Coordinates Datum::fromWGS84(const Coordinates &c) const
 	}
 }
 
+void Datum::toWGS84(const Coordinates *in, Coordinates *out, int n) const
+{
+	switch (_transformation) {
+		case Helmert:
+			for (int i = 0; i < n; i++)
+				out[i] = Geocentric::toGeodetic(helmert(
+				  Geocentric::fromGeodetic(in[i], ellipsoid())),
+				  WGS84().ellipsoid());
+			break;
+		case Molodensky:
+			for (int i = 0; i < n; i++)
+				out[i] = molodensky(in[i], *this, WGS84());
+			break;
+		default:
+			if (in != out)
+				std::copy(in, in + n, out);
+	}
+}
+
+void Datum::fromWGS84(const Coordinates *in, Coordinates *out, int n) const
+{
+	switch (_transformation) {
+		case Helmert:
+			for (int i = 0; i < n; i++)
+				out[i] = Geocentric::toGeodetic(helmertr(
+				  Geocentric::fromGeodetic(in[i], WGS84().ellipsoid())),
+				  ellipsoid());
+			break;
+		case Molodensky:
+			for (int i = 0; i < n; i++)
+				out[i] = molodensky(in[i], WGS84(), *this);
+			break;
+		default:
+			if (in != out)
+				std::copy(in, in + n, out);
+	}
+}
+
 #ifndef QT_NO_DEBUG
 QDebug operator<<(QDebug dbg, const Datum &datum)
 {
@@ -34,6 +34,9 @@ public:
 
 	Coordinates toWGS84(const Coordinates &c) const;
 	Coordinates fromWGS84(const Coordinates &c) const;
+	/* Array versions, in and out may be the same array */
+	void toWGS84(const Coordinates *in, Coordinates *out, int n) const;
+	void fromWGS84(const Coordinates *in, Coordinates *out, int n) const;
 
 	static const Datum &WGS84();
 
@@ -80,12 +80,12 @@ QString DEM::Tile::fileName() const
 
 QMutex DEM::_lock;
 QString DEM::_dir;
-DEM::TileCache DEM::_data;
+DEM::TileCache DEM::_data("DEM", &DEM::_lock);
 
 void DEM::setCacheSize(int size)
 {
 	_lock.lock();
-	_data.setMaxCost(size);
+	_data.setMaxCost((qint64)size * 1024);
 	_lock.unlock();
 }
 
@@ -148,7 +148,7 @@ double DEM::elevationLockFree(const Coordinates &c)
 	if (!e) {
 		e = loadTile(tile);
 		ele = height(c, e);
-		_data.insert(tile, e, e->data().size() / 1024);
+		_data.insert(tile, e, sizeof(Entry) + e->data().size());
 	} else
 		ele = height(c, e);
 
@@ -164,6 +164,8 @@ double DEM::elevation(const Coordinates &c)
 	double ele = elevationLockFree(c);
 	_lock.unlock();
 
+	CacheBudget::enforce();
+
 	return ele;
 }
 
@@ -179,6 +181,8 @@ MatrixD DEM::elevation(const MatrixC &m)
 		ret.at(i) = elevationLockFree(m.at(i));
 	_lock.unlock();
 
+	CacheBudget::enforce();
+
 	return ret;
 }
 
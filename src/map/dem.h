@@ -2,12 +2,12 @@
 #define DEM_H
 
 #include <QString>
-#include <QCache>
 #include <QByteArray>
 #include <QMutex>
 #include "common/hash.h"
 #include "data/area.h"
 #include "matrix.h"
+#include "cachebudget.h"
 
 class DEM
 {
@@ -55,15 +55,15 @@ private:
 		QByteArray _data;
 	};
 
-	typedef QCache<DEM::Tile, Entry> TileCache;
+	typedef BudgetCache<DEM::Tile, Entry> TileCache;
 
 	static double height(const Coordinates &c, const Entry *e);
 	static Entry *loadTile(const Tile &tile);
 	static double elevationLockFree(const Coordinates &c);
 
 	static QString _dir;
-	static TileCache _data;
 	static QMutex _lock;
+	static TileCache _data;
 };
 
 inline HASH_T qHash(const DEM::Tile &tile)
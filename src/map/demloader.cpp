@@ -1,19 +1,30 @@
 #include <QtMath>
 #include <QFileInfo>
+#include <QSet>
 #include "common/rectc.h"
 #include "demloader.h"
 
 
-static QList<DEM::Tile> tiles(const RectC &rect)
+static QList<DEM::Tile> tiles(const QList<RectC> &area)
 {
 	QList<DEM::Tile> list;
-
-	if (rect.isNull())
-		return list;
-
-	for (int i = qFloor(rect.top()); i >= qFloor(rect.bottom()); i--)
-		for (int j = qFloor(rect.left()); j <= qFloor(rect.right()); j++)
-			list.append(DEM::Tile(j, i));
+	QSet<DEM::Tile> set;
+
+	for (int k = 0; k < area.size(); k++) {
+		const RectC &rect = area.at(k);
+		if (rect.isNull())
+			continue;
+
+		for (int i = qFloor(rect.top()); i >= qFloor(rect.bottom()); i--) {
+			for (int j = qFloor(rect.left()); j <= qFloor(rect.right()); j++) {
+				DEM::Tile t(j, i);
+				if (!set.contains(t)) {
+					set.insert(t);
+					list.append(t);
+				}
+			}
+		}
+	}
 
 	return list;
 }
@@ -32,9 +43,9 @@ DEMLoader::DEMLoader(const QString &dir, QObject *parent)
 	connect(_downloader, &Downloader::finished, this, &DEMLoader::finished);
 }
 
-int DEMLoader::numTiles(const RectC &rect) const
+int DEMLoader::numTiles(const QList<RectC> &area) const
 {
-	QList<DEM::Tile> tl(tiles(rect));
+	QList<DEM::Tile> tl(tiles(area));
 	int cnt = 0;
 
 	for (int i = 0; i < tl.size(); i++) {
@@ -49,9 +60,9 @@ int DEMLoader::numTiles(const RectC &rect) const
 	return cnt;
 }
 
-bool DEMLoader::loadTiles(const RectC &rect)
+bool DEMLoader::loadTiles(const QList<RectC> &area)
 {
-	QList<DEM::Tile> tl(tiles(rect));
+	QList<DEM::Tile> tl(tiles(area));
 	QList<Download> dl;
 
 	/* Create the user DEM dir only when a download is requested as it will
@@ -82,9 +93,9 @@ bool DEMLoader::loadTiles(const RectC &rect)
 	return _downloader->get(dl, _headers);
 }
 
-bool DEMLoader::checkTiles(const RectC &rect) const
+bool DEMLoader::checkTiles(const QList<RectC> &area) const
 {
-	QList<DEM::Tile> tl(tiles(rect));
+	QList<DEM::Tile> tl(tiles(area));
 
 	for (int i = 0; i < tl.size(); i++) {
 		const DEM::Tile &t = tl.at(i);
@@ -3,11 +3,10 @@
 
 #include <QObject>
 #include <QDir>
+#include "common/rectc.h"
 #include "downloader.h"
 #include "dem.h"
 
-class RectC;
-
 #define DEM_DOWNLOAD_WARNING 4
 #define DEM_DOWNLOAD_LIMIT   1024
 
@@ -21,9 +20,15 @@ public:
 	void setUrl(const QString &url) {_url = url;}
 	void setAuthorization(const Authorization &authorization);
 
-	int numTiles(const RectC &rect) const;
-	bool loadTiles(const RectC &rect);
-	bool checkTiles(const RectC &rect) const;
+	int numTiles(const QList<RectC> &area) const;
+	bool loadTiles(const QList<RectC> &area);
+	bool checkTiles(const QList<RectC> &area) const;
+	int numTiles(const RectC &rect) const
+	  {return numTiles(QList<RectC>() << rect);}
+	bool loadTiles(const RectC &rect)
+	  {return loadTiles(QList<RectC>() << rect);}
+	bool checkTiles(const RectC &rect) const
+	  {return checkTiles(QList<RectC>() << rect);}
 
 	const QString &url() const {return _url;}
 
@@ -1,8 +1,12 @@
 #include <QFile>
+#include <QBuffer>
 #include <QNetworkRequest>
 #include <QDir>
 #include <QTimerEvent>
+#include <QDateTime>
 #include "common/config.h"
+#include "common/util.h"
+#include "common/trace.h"
 #include "downloader.h"
 
 
@@ -28,6 +32,18 @@
 #define MAX_REDIRECT_LEVEL 5
 #define RETRIES 3
 #define TMP_SUFFIX ".download"
+#define MAX_HOST_CONNECTIONS 6
+#define MAX_BACKGROUND_HOST_CONNECTIONS 4
+
+/* Download latency histogram buckets upper bounds (ms) */
+static const int LATENCY_BUCKETS[] = {100, 250, 500, 1000, 2500, 5000};
+#ifdef ENABLE_TRACE
+/* The same histogram as trace counters (trace summary) */
+static const char *LATENCY_COUNTERS[] = {"download latency <= 100 ms",
+  "download latency <= 250 ms", "download latency <= 500 ms",
+  "download latency <= 1000 ms", "download latency <= 2500 ms",
+  "download latency <= 5000 ms", "download latency > 5000 ms"};
+#endif // ENABLE_TRACE
 
 // QNetworkReply::errorString() returns bullshit, use our own reporting
 static const char *errorString(QNetworkReply::NetworkError error)
@@ -124,11 +140,73 @@ Authorization::Authorization(const QString &username, const QString &password)
 QNetworkAccessManager *Downloader::_manager = 0;
 int Downloader::_timeout = 30;
 bool Downloader::_http2 = true;
+QList<Downloader::Request> Downloader::_queue;
+QHash<QString, int> Downloader::_hostConnections;
+QVector<unsigned> Downloader::_latencies(ARRAY_SIZE(LATENCY_BUCKETS) + 1);
+quint64 Downloader::_generation = 0;
 
-bool Downloader::doDownload(const Download &dl, const QList<HTTPHeader> &headers)
+Downloader::~Downloader()
+{
+	cancel();
+
+	for (QHash<QUrl, QIODevice*>::const_iterator it
+	  = _currentDownloads.constBegin(); it != _currentDownloads.constEnd();
+	  ++it) {
+		QNetworkReply *reply = static_cast<QNetworkReply*>(it.value()->parent());
+		QFile *file = qobject_cast<QFile*>(it.value());
+		QString host(it.key().host());
+
+		reply->disconnect(this);
+		if (--_hostConnections[host] <= 0)
+			_hostConnections.remove(host);
+		TRACE_COUNT("downloads running", -1);
+		if (file)
+			file->remove();
+		reply->abort();
+		reply->deleteLater();
+	}
+
+	schedule();
+}
+
+/* Starts the queued downloads in the queue order as long as the per-host
+   connections limit allows it. */
+void Downloader::schedule()
+{
+	int i = 0;
+
+	while (i < _queue.size()) {
+		const Request &next = _queue.at(i);
+		int limit = next.owner->_background
+		  ? MAX_BACKGROUND_HOST_CONNECTIONS : MAX_HOST_CONNECTIONS;
+		if (_hostConnections.value(next.dl.url().host()) >= limit) {
+			i++;
+			continue;
+		}
+
+		Request r(_queue.takeAt(i));
+		TRACE_COUNT("download queue", -1);
+		if (!r.owner->doDownload(r.dl, r.headers)
+		  && r.owner->_currentDownloads.isEmpty() && !r.owner->queued())
+			emit r.owner->finished();
+	}
+}
+
+int Downloader::queued() const
+{
+	int cnt = 0;
+
+	for (int i = 0; i < _queue.size(); i++)
+		if (_queue.at(i).owner == this)
+			cnt++;
+
+	return cnt;
+}
+
+bool Downloader::enqueue(const Download &dl, const QList<HTTPHeader> &headers,
+  quint64 generation)
 {
 	const QUrl &url = dl.url();
-	bool userAgent = false;
 
 	if (!url.isValid() || !(url.scheme() == QLatin1String("http")
 	  || url.scheme() == QLatin1String("https"))) {
@@ -141,6 +219,31 @@ bool Downloader::doDownload(const Download &dl, const QList<HTTPHeader> &headers
 	if (_currentDownloads.contains(url))
 		return false;
 
+	// Coalesce repeated requests, the latest request priority applies
+	for (int i = 0; i < _queue.size(); i++) {
+		Request &r = _queue[i];
+		if (r.owner == this && r.dl.url() == url) {
+			r.dl = dl;
+			r.headers = headers;
+			r.generation = generation;
+			return true;
+		}
+	}
+
+	_queue.append(Request(this, dl, headers, generation));
+	TRACE_COUNT("download queue", 1);
+
+	return true;
+}
+
+bool Downloader::doDownload(const Download &dl, const QList<HTTPHeader> &headers)
+{
+	const QUrl &url = dl.url();
+	bool userAgent = false;
+
+	if (_currentDownloads.contains(url))
+		return false;
+
 	QNetworkRequest request(url);
 	request.setMaximumRedirectsAllowed(MAX_REDIRECT_LEVEL);
 	request.setAttribute(QNetworkRequest::RedirectPolicyAttribute,
@@ -157,19 +260,29 @@ bool Downloader::doDownload(const Download &dl, const QList<HTTPHeader> &headers
 	if (!userAgent)
 		request.setRawHeader("User-Agent", USER_AGENT);
 
-	QFile *file = new QFile(tmpName(dl.file()));
-	if (!file->open(QIODevice::WriteOnly)) {
-		qWarning("%s: %s", qUtf8Printable(file->fileName()),
-		  qUtf8Printable(file->errorString()));
-		delete file;
-		_errorDownloads.insert(url, RETRIES);
-		return false;
+	QIODevice *dev;
+	if (dl.file().isEmpty()) {
+		dev = new QBuffer();
+		dev->open(QIODevice::WriteOnly);
+	} else {
+		QFile *file = new QFile(tmpName(dl.file()));
+		if (!file->open(QIODevice::WriteOnly)) {
+			qWarning("%s: %s", qUtf8Printable(file->fileName()),
+			  qUtf8Printable(file->errorString()));
+			delete file;
+			_errorDownloads.insert(url, RETRIES);
+			return false;
+		}
+		dev = file;
 	}
 
 	Q_ASSERT(_manager);
 	QNetworkReply *reply = _manager->get(request);
-	file->setParent(reply);
-	_currentDownloads.insert(url, file);
+	dev->setParent(reply);
+	_currentDownloads.insert(url, dev);
+	_startTimes.insert(url, QDateTime::currentMSecsSinceEpoch());
+	_hostConnections[url.host()]++;
+	TRACE_COUNT("downloads running", 1);
 
 	if (reply->isRunning()) {
 		connect(reply, &QIODevice::readyRead, this, &Downloader::emitReadReady);
@@ -208,9 +321,9 @@ void Downloader::insertError(const QUrl &url, QNetworkReply::NetworkError error)
 
 void Downloader::readData(QNetworkReply *reply)
 {
-	QFile *file = _currentDownloads.value(reply->request().url());
-	Q_ASSERT(file);
-	file->write(reply->readAll());
+	QIODevice *dev = _currentDownloads.value(reply->request().url());
+	Q_ASSERT(dev);
+	dev->write(reply->readAll());
 }
 
 void Downloader::downloadFinished(QNetworkReply *reply)
@@ -218,34 +331,97 @@ void Downloader::downloadFinished(QNetworkReply *reply)
 	QUrl url(reply->request().url());
 	QNetworkReply::NetworkError error = reply->error();
 
-	QFile *file = _currentDownloads.value(reply->request().url());
+	QIODevice *dev = _currentDownloads.value(reply->request().url());
+	QFile *file = qobject_cast<QFile*>(dev);
+	QByteArray data;
 	if (error) {
 		insertError(url, error);
 		qWarning("%s: %s", url.toEncoded().constData(), errorString(error));
-		file->remove();
-	} else {
+		if (file)
+			file->remove();
+	} else if (file) {
 		file->close();
 		file->rename(origName(file->fileName()));
-	}
+	} else
+		data = static_cast<QBuffer*>(dev)->data();
+
+	qint64 latency = QDateTime::currentMSecsSinceEpoch()
+	  - _startTimes.take(url);
+	int bucket = 0;
+	while (bucket < (int)ARRAY_SIZE(LATENCY_BUCKETS)
+	  && latency > LATENCY_BUCKETS[bucket])
+		bucket++;
+	_latencies[bucket]++;
+	TRACE_COUNT(LATENCY_COUNTERS[bucket], 1);
+
+	if (--_hostConnections[url.host()] <= 0)
+		_hostConnections.remove(url.host());
+	TRACE_COUNT("downloads running", -1);
 
 	_currentDownloads.remove(url);
 	reply->deleteLater();
 
-	if (_currentDownloads.isEmpty())
+	if (!error && !file)
+		emit downloaded(url, data);
+
+	schedule();
+
+	if (_currentDownloads.isEmpty() && !queued())
 		emit finished();
 }
 
+/* The downloads are not started immediately but put into a queue shared by
+   all the downloaders and started in the order given by the get() call
+   recency and the downloads priority with a per-host connections limit. */
 bool Downloader::get(const QList<Download> &list,
   const QList<HTTPHeader> &headers)
 {
+	quint64 generation = ++_generation;
 	bool finishEmitted = false;
 
 	for (int i = 0; i < list.count(); i++)
-		finishEmitted |= doDownload(list.at(i), headers);
+		finishEmitted |= enqueue(list.at(i), headers, generation);
+
+	if (finishEmitted) {
+		std::stable_sort(_queue.begin(), _queue.end());
+		schedule();
+	}
 
 	return finishEmitted;
 }
 
+/* Drops all the queued (not yet running) downloads of the downloader */
+void Downloader::cancel()
+{
+	for (int i = 0; i < _queue.size(); )
+		if (_queue.at(i).owner == this) {
+			_queue.removeAt(i);
+			TRACE_COUNT("download queue", -1);
+		} else
+			i++;
+}
+
+int Downloader::runningDownloads()
+{
+	int cnt = 0;
+
+	for (QHash<QString, int>::const_iterator it = _hostConnections.constBegin();
+	  it != _hostConnections.constEnd(); ++it)
+		cnt += it.value();
+
+	return cnt;
+}
+
+QVector<int> Downloader::latencyBuckets()
+{
+	QVector<int> buckets;
+
+	for (size_t i = 0; i < ARRAY_SIZE(LATENCY_BUCKETS); i++)
+		buckets.append(LATENCY_BUCKETS[i]);
+
+	return buckets;
+}
+
 void Downloader::enableHTTP2(bool enable)
 {
 	Q_ASSERT(_manager);
@@ -5,24 +5,32 @@
 #include <QNetworkReply>
 #include <QUrl>
 #include <QList>
+#include <QVector>
 #include <QHash>
 #include "common/kv.h"
 
-class QFile;
+class QIODevice;
 
 typedef KV<QByteArray, QByteArray> HTTPHeader;
 
 class Download
 {
 public:
-	Download(const QUrl &url, const QString &file) : _url(url), _file(file) {}
+	Download(const QUrl &url, const QString &file, int priority = 0)
+	  : _url(url), _file(file), _priority(priority) {}
 
 	const QUrl &url() const {return _url;}
+	/* Downloads with an empty file name are kept in memory and passed to the
+	   Downloader::downloaded() signal */
 	const QString &file() const {return _file;}
+	/* Lower value means higher priority. Downloads requested by a later get()
+	   call always take precedence over the older ones. */
+	int priority() const {return _priority;}
 
 private:
 	QUrl _url;
 	QString _file;
+	int _priority;
 };
 
 class Authorization
@@ -43,10 +51,20 @@ class Downloader : public QObject
 	Q_OBJECT
 
 public:
-	Downloader(QObject *parent = 0) : QObject(parent) {}
+	Downloader(QObject *parent = 0) : QObject(parent), _background(false) {}
+	~Downloader();
 
 	bool get(const QList<Download> &list, const QList<HTTPHeader> &headers);
+	void cancel();
 	void clearErrors() {_errorDownloads.clear();}
+	/* Background downloads are only started when there are no other queued
+	   downloads and never use all the per-host connections */
+	void setBackground(bool background) {_background = background;}
+
+	static int queueDepth() {return _queue.size();}
+	static int runningDownloads();
+	static QVector<int> latencyBuckets();
+	static QVector<unsigned> latencyHistogram() {return _latencies;}
 
 	static void setNetworkManager(QNetworkAccessManager *manager)
 	  {_manager = manager;}
@@ -55,20 +73,54 @@ public:
 
 signals:
 	void finished();
+	void downloaded(const QUrl &url, const QByteArray &data);
 
 private slots:
 	void emitFinished();
 	void emitReadReady();
 
 private:
+	class Request
+	{
+	public:
+		Request(Downloader *owner, const Download &dl,
+		  const QList<HTTPHeader> &headers, quint64 generation)
+		  : owner(owner), dl(dl), headers(headers), generation(generation) {}
+
+		bool operator<(const Request &other) const
+		{
+			if (owner->_background != other.owner->_background)
+				return other.owner->_background;
+			return (generation == other.generation)
+			  ? dl.priority() < other.dl.priority()
+			  : generation > other.generation;
+		}
+
+		Downloader *owner;
+		Download dl;
+		QList<HTTPHeader> headers;
+		quint64 generation;
+	};
+
 	void insertError(const QUrl &url, QNetworkReply::NetworkError error);
+	bool enqueue(const Download &dl, const QList<HTTPHeader> &headers,
+	  quint64 generation);
 	bool doDownload(const Download &dl, const QList<HTTPHeader> &headers);
 	void downloadFinished(QNetworkReply *reply);
 	void readData(QNetworkReply *reply);
+	int queued() const;
+
+	static void schedule();
 
-	QHash<QUrl, QFile*> _currentDownloads;
+	QHash<QUrl, QIODevice*> _currentDownloads;
+	QHash<QUrl, qint64> _startTimes;
 	QHash<QUrl, int> _errorDownloads;
+	bool _background;
 
+	static QList<Request> _queue;
+	static QHash<QString, int> _hostConnections;
+	static QVector<unsigned> _latencies;
+	static quint64 _generation;
 	static QNetworkAccessManager *_manager;
 	static int _timeout;
 	static bool _http2;
@@ -1,6 +1,8 @@
 #include <QPainter>
 #include <QPixmapCache>
+#include <QtConcurrent>
 #include "common/wgs84.h"
+#include "common/trace.h"
 #include "GUI/format.h"
 #include "rectd.h"
 #include "pcs.h"
@@ -122,7 +124,7 @@ void ENCAtlas::addMap(const QDir &dir, const QByteArray &file,
 
 ENCAtlas::ENCAtlas(const QString &fileName, QObject *parent)
   : Map(fileName, parent), _projection(PCS::pcs(3857)),  _tileRatio(1.0),
-  _style(0), _zoom(0), _valid(false)
+  _style(0), _cache("ENC maps", &_cacheLock), _zoom(0), _valid(false)
 {
 	QDir dir(QFileInfo(fileName).absoluteDir());
 	ISO8211 ddf(fileName);
@@ -142,6 +144,8 @@ ENCAtlas::ENCAtlas(const QString &fileName, QObject *parent)
 		_errorString = ddf.errorString();
 		return;
 	}
+	for (auto it = _data.begin(); it != _data.end(); ++it)
+		it.value()->createIndex();
 
 	if (_data.isEmpty()) {
 		_errorString = "No usable ENC map found";
@@ -154,8 +158,6 @@ ENCAtlas::ENCAtlas(const QString &fileName, QObject *parent)
 	_zoom = zooms(_usage).min();
 	updateTransform();
 
-	_cache.setMaxCost(10);
-
 	_valid = true;
 }
 
@@ -182,9 +184,11 @@ void ENCAtlas::load(const Projection &in, const Projection &out,
 
 void ENCAtlas::unload()
 {
-	cancelJobs(true);
+	_jobs.cancel(true);
 
+	_cacheLock.lock();
 	_cache.clear();
+	_cacheLock.unlock();
 
 	delete _style;
 	_style = 0;
@@ -227,7 +231,7 @@ int ENCAtlas::zoomFit(const QSize &size, const RectC &rect)
 
 int ENCAtlas::zoomIn()
 {
-	cancelJobs(false);
+	_jobs.cancel(false);
 
 	if (_zoom + 1 <= zooms(_usage).max())
 		_zoom++;
@@ -246,7 +250,7 @@ int ENCAtlas::zoomIn()
 
 int ENCAtlas::zoomOut()
 {
-	cancelJobs(false);
+	_jobs.cancel(false);
 
 	if (_zoom - 1 >= zooms(_usage).min())
 		_zoom--;
@@ -290,55 +294,27 @@ void ENCAtlas::updateTransform()
 	  _transform.proj2img(prect.bottomRight()));
 }
 
-bool ENCAtlas::isRunning(int zoom, const QPoint &xy) const
+void ENCAtlas::runJob(RenderJob *job)
 {
-	for (int i = 0; i < _jobs.size(); i++) {
-		const QList<ENC::RasterTile> &tiles = _jobs.at(i)->tiles();
-		for (int j = 0; j < tiles.size(); j++) {
-			const ENC::RasterTile &mt = tiles.at(j);
-			if (mt.zoom() == zoom && mt.xy() == xy)
-				return true;
-		}
-	}
-
-	return false;
+	connect(job, &RenderJob::finished, this, &ENCAtlas::jobFinished);
+	_jobs.run(job);
 }
 
-void ENCAtlas::runJob(ENCJob *job)
+void ENCAtlas::jobFinished(RenderJob *job)
 {
-	_jobs.append(job);
-
-	connect(job, &ENCJob::finished, this, &ENCAtlas::jobFinished);
-	job->run();
-}
-
-void ENCAtlas::removeJob(ENCJob *job)
-{
-	_jobs.removeOne(job);
-	job->deleteLater();
-}
-
-void ENCAtlas::jobFinished(ENCJob *job)
-{
-	const QList<ENC::RasterTile> &tiles = job->tiles();
+	const QList<ENC::RasterTile> &tiles = static_cast<ENCJob*>(job)->tiles();
 
 	for (int i = 0; i < tiles.size(); i++) {
 		const ENC::RasterTile &mt = tiles.at(i);
 		if (!mt.pixmap().isNull())
-			QPixmapCache::insert(key(mt.zoom(), mt.xy()), mt.pixmap());
+			QPixmapCache::insert(mt.key(), mt.pixmap());
 	}
 
-	removeJob(job);
+	_jobs.remove(job);
 
 	emit tilesLoaded();
 }
 
-void ENCAtlas::cancelJobs(bool wait)
-{
-	for (int i = 0; i < _jobs.size(); i++)
-		_jobs.at(i)->cancel(wait);
-}
-
 QString ENCAtlas::key(int zoom, const QPoint &xy) const
 {
 	return path() + "-" + QString::number(zoom) + "_"
@@ -360,16 +336,18 @@ void ENCAtlas::draw(QPainter *painter, const QRectF &rect, Flags flags)
 	for (int i = 0; i < width; i++) {
 		for (int j = 0; j < height; j++) {
 			QPoint ttl(tl.x() + i * TILE_SIZE, tl.y() + j * TILE_SIZE);
-			if (isRunning(_zoom, ttl))
+			QString tk(key(_zoom, ttl));
+			if (_jobs.isRunning(tk))
 				continue;
 
 			QPixmap pm;
-			if (QPixmapCache::find(key(_zoom, ttl), &pm))
+			if (QPixmapCache::find(tk, &pm)) {
 				painter->drawPixmap(ttl, pm);
-			else
+				TRACE_COUNT("tiles cached", 1);
+			} else
 				tiles.append(RasterTile(_projection, _transform, _style,
 				  data, _zoom, zr, QRect(ttl, QSize(TILE_SIZE, TILE_SIZE)),
-				  _tileRatio));
+				  _tileRatio, tk));
 		}
 	}
 
@@ -382,10 +360,10 @@ void ENCAtlas::draw(QPainter *painter, const QRectF &rect, Flags flags)
 				const RasterTile &mt = tiles.at(i);
 				const QPixmap &pm = mt.pixmap();
 				painter->drawPixmap(mt.xy(), pm);
-				QPixmapCache::insert(key(mt.zoom(), mt.xy()), pm);
+				QPixmapCache::insert(mt.key(), pm);
 			}
 		} else
-			runJob(new ENCJob(tiles));
+			runJob(new ENCJob(tiles, _zoom));
 	}
 }
 
@@ -7,11 +7,11 @@
 #include "map.h"
 #include "projection.h"
 #include "transform.h"
+#include "renderjob.h"
 #include "ENC/iso8211.h"
 #include "ENC/atlasdata.h"
 #include "ENC/style.h"
 
-class ENCJob;
 class QDir;
 
 class ENCAtlas : public Map
@@ -50,7 +50,7 @@ public:
 	static Map *create(const QString &path, const Projection &proj, bool *isDir);
 
 private slots:
-	void jobFinished(ENCJob *job);
+	void jobFinished(RenderJob *job);
 
 private:
 	enum IntendedUsage {
@@ -68,10 +68,7 @@ private:
 
 	Transform transform(int zoom) const;
 	void updateTransform();
-	bool isRunning(int zoom, const QPoint &xy) const;
-	void runJob(ENCJob *job);
-	void removeJob(ENCJob *job);
-	void cancelJobs(bool wait);
+	void runJob(RenderJob *job);
 	QString key(int zoom, const QPoint &xy) const;
 	void addMap(const QDir &dir, const QByteArray &file, const RectC &bounds);
 
@@ -88,12 +85,12 @@ private:
 	qreal _tileRatio;
 	QMap<IntendedUsage, ENC::AtlasData*> _data;
 	ENC::Style *_style;
-	ENC::MapCache _cache;
 	QMutex _cacheLock;
+	ENC::MapCache _cache;
 	IntendedUsage _usage;
 	int _zoom;
 
-	QList<ENCJob*> _jobs;
+	RenderQueue _jobs;
 
 	bool _valid;
 	QString _errorString;
@@ -2,6 +2,7 @@
 #include <QPixmapCache>
 #include "common/range.h"
 #include "common/wgs84.h"
+#include "common/trace.h"
 #include "ENC/mapdata.h"
 #include "ENC/style.h"
 #include "rectd.h"
@@ -188,7 +189,7 @@ void ENCMap::load(const Projection &in, const Projection &out,
 
 void ENCMap::unload()
 {
-	cancelJobs(true);
+	_jobs.cancel(true);
 
 	delete _data;
 	_data = 0;
@@ -220,19 +221,17 @@ int ENCMap::zoomFit(const QSize &size, const RectC &rect)
 
 int ENCMap::zoomIn()
 {
-	cancelJobs(false);
-
 	_zoom = qMin(_zoom + 1, _zooms.max());
 	updateTransform();
+	_jobs.cancelStale(_zoom);
 	return _zoom;
 }
 
 int ENCMap::zoomOut()
 {
-	cancelJobs(false);
-
 	_zoom = qMax(_zoom - 1, _zooms.min());
 	updateTransform();
+	_jobs.cancelStale(_zoom);
 	return _zoom;
 }
 
@@ -240,6 +239,7 @@ void ENCMap::setZoom(int zoom)
 {
 	_zoom = zoom;
 	updateTransform();
+	_jobs.cancelStale(_zoom);
 }
 
 Transform ENCMap::transform(int zoom) const
@@ -262,55 +262,27 @@ void ENCMap::updateTransform()
 	  _transform.proj2img(prect.bottomRight()));
 }
 
-bool ENCMap::isRunning(int zoom, const QPoint &xy) const
+void ENCMap::runJob(RenderJob *job)
 {
-	for (int i = 0; i < _jobs.size(); i++) {
-		const QList<ENC::RasterTile> &tiles = _jobs.at(i)->tiles();
-		for (int j = 0; j < tiles.size(); j++) {
-			const ENC::RasterTile &mt = tiles.at(j);
-			if (mt.zoom() == zoom && mt.xy() == xy)
-				return true;
-		}
-	}
-
-	return false;
+	connect(job, &RenderJob::finished, this, &ENCMap::jobFinished);
+	_jobs.run(job);
 }
 
-void ENCMap::runJob(ENCJob *job)
+void ENCMap::jobFinished(RenderJob *job)
 {
-	_jobs.append(job);
-
-	connect(job, &ENCJob::finished, this, &ENCMap::jobFinished);
-	job->run();
-}
-
-void ENCMap::removeJob(ENCJob *job)
-{
-	_jobs.removeOne(job);
-	job->deleteLater();
-}
-
-void ENCMap::jobFinished(ENCJob *job)
-{
-	const QList<ENC::RasterTile> &tiles = job->tiles();
+	const QList<ENC::RasterTile> &tiles = static_cast<ENCJob*>(job)->tiles();
 
 	for (int i = 0; i < tiles.size(); i++) {
 		const ENC::RasterTile &mt = tiles.at(i);
 		if (!mt.pixmap().isNull())
-			QPixmapCache::insert(key(mt.zoom(), mt.xy()), mt.pixmap());
+			QPixmapCache::insert(mt.key(), mt.pixmap());
 	}
 
-	removeJob(job);
+	_jobs.remove(job);
 
 	emit tilesLoaded();
 }
 
-void ENCMap::cancelJobs(bool wait)
-{
-	for (int i = 0; i < _jobs.size(); i++)
-		_jobs.at(i)->cancel(wait);
-}
-
 QString ENCMap::key(int zoom, const QPoint &xy) const
 {
 	return path() + "-" + QString::number(zoom) + "_"
@@ -331,16 +303,18 @@ void ENCMap::draw(QPainter *painter, const QRectF &rect, Flags flags)
 	for (int i = 0; i < width; i++) {
 		for (int j = 0; j < height; j++) {
 			QPoint ttl(tl.x() + i * TILE_SIZE, tl.y() + j * TILE_SIZE);
-			if (isRunning(_zoom, ttl))
+			QString tk(key(_zoom, ttl));
+			if (_jobs.isRunning(tk))
 				continue;
 
 			QPixmap pm;
-			if (QPixmapCache::find(key(_zoom, ttl), &pm))
+			if (QPixmapCache::find(tk, &pm)) {
 				painter->drawPixmap(ttl, pm);
-			else
+				TRACE_COUNT("tiles cached", 1);
+			} else
 				tiles.append(RasterTile(_projection, _transform, _style,  _data,
 				  _zoom, _zooms, QRect(ttl, QSize(TILE_SIZE, TILE_SIZE)),
-				  _tileRatio));
+				  _tileRatio, tk));
 		}
 	}
 
@@ -353,10 +327,10 @@ void ENCMap::draw(QPainter *painter, const QRectF &rect, Flags flags)
 				const RasterTile &mt = tiles.at(i);
 				const QPixmap &pm = mt.pixmap();
 				painter->drawPixmap(mt.xy(), pm);
-				QPixmapCache::insert(key(mt.zoom(), mt.xy()), pm);
+				QPixmapCache::insert(mt.key(), pm);
 			}
 		} else
-			runJob(new ENCJob(tiles));
+			runJob(new ENCJob(tiles, _zoom));
 	}
 }
 
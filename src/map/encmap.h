@@ -7,12 +7,11 @@
 #include "map.h"
 #include "projection.h"
 #include "transform.h"
+#include "renderjob.h"
 #include "ENC/iso8211.h"
 #include "ENC/mapdata.h"
 #include "ENC/style.h"
 
-class ENCJob;
-
 class ENCMap : public Map
 {
 	Q_OBJECT
@@ -49,7 +48,7 @@ public:
 	static Map *create(const QString &path, const Projection &proj, bool *isMap);
 
 private slots:
-	void jobFinished(ENCJob *job);
+	void jobFinished(RenderJob *job);
 
 private:
 	class Rect {
@@ -88,10 +87,7 @@ private:
 
 	Transform transform(int zoom) const;
 	void updateTransform();
-	bool isRunning(int zoom, const QPoint &xy) const;
-	void runJob(ENCJob *job);
-	void removeJob(ENCJob *job);
-	void cancelJobs(bool wait);
+	void runJob(RenderJob *job);
 	QString key(int zoom, const QPoint &xy) const;
 
 	static bool bounds(const ENC::ISO8211::Record &record, Rect &rect);
@@ -110,7 +106,7 @@ private:
 	Range _zooms;
 	int _zoom;
 
-	QList<ENCJob*> _jobs;
+	RenderQueue _jobs;
 
 	bool _valid;
 	QString _errorString;
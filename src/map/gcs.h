@@ -39,6 +39,19 @@ public:
 		Coordinates ds(datum().fromWGS84(c));
 		return Coordinates(_primeMeridian.fromGreenwich(ds.lon()), ds.lat());
 	}
+	void toWGS84(const Coordinates *in, Coordinates *out, int n) const
+	{
+		for (int i = 0; i < n; i++)
+			out[i] = Coordinates(_primeMeridian.toGreenwich(in[i].lon()),
+			  in[i].lat());
+		datum().toWGS84(out, out, n);
+	}
+	void fromWGS84(const Coordinates *in, Coordinates *out, int n) const
+	{
+		datum().fromWGS84(in, out, n);
+		for (int i = 0; i < n; i++)
+			out[i].setLon(_primeMeridian.fromGreenwich(out[i].lon()));
+	}
 
 	static GCS gcs(int id);
 	static GCS gcs(int geodeticDatum, int primeMeridian, int angularUnits);
@@ -5,6 +5,7 @@
 #include "common/rectc.h"
 #include "common/range.h"
 #include "common/wgs84.h"
+#include "common/trace.h"
 #include "IMG/imgdata.h"
 #include "IMG/gmapdata.h"
 #include "IMG/rastertile.h"
@@ -12,6 +13,7 @@
 #include "osm.h"
 #include "pcs.h"
 #include "rectd.h"
+#include "prefetch.h"
 #include "imgmap.h"
 
 using namespace IMG;
@@ -98,7 +100,7 @@ void IMGMap::load(const Projection &in, const Projection &out,
 
 void IMGMap::unload()
 {
-	cancelJobs(true);
+	_jobs.cancel(true);
 
 	for (int i = 0; i < _data.size(); i++)
 		_data.at(i)->clear();
@@ -130,19 +132,17 @@ int IMGMap::zoomFit(const QSize &size, const RectC &rect)
 
 int IMGMap::zoomIn()
 {
-	cancelJobs(false);
-
 	_zoom = qMin(_zoom + 1, _data.first()->zooms().max());
 	updateTransform();
+	_jobs.cancelStale(_zoom);
 	return _zoom;
 }
 
 int IMGMap::zoomOut()
 {
-	cancelJobs(false);
-
 	_zoom = qMax(_zoom - 1, _data.first()->zooms().min());
 	updateTransform();
+	_jobs.cancelStale(_zoom);
 	return _zoom;
 }
 
@@ -150,6 +150,7 @@ void IMGMap::setZoom(int zoom)
 {
 	_zoom = zoom;
 	updateTransform();
+	_jobs.cancelStale(_zoom);
 }
 
 Transform IMGMap::transform(int zoom) const
@@ -173,53 +174,36 @@ void IMGMap::updateTransform()
 		_bounds.adjust(0.5, 0, -0.5, 0);
 }
 
-bool IMGMap::isRunning(const QString &key) const
+QString IMGMap::key(int n, int zoom, const QPoint &xy) const
 {
-	for (int i = 0; i < _jobs.size(); i++) {
-		const QList<IMG::RasterTile> &tiles = _jobs.at(i)->tiles();
-		for (int j = 0; j < tiles.size(); j++)
-			if (tiles.at(j).key() == key)
-				return true;
-	}
-
-	return false;
+	return _data.at(n)->fileName() + "-" + QString::number(zoom) + "_"
+	  + QString::number(xy.x()) + "_" + QString::number(xy.y());
 }
 
 void IMGMap::runJob(IMGMapJob *job)
 {
-	_jobs.append(job);
-
-	connect(job, &IMGMapJob::finished, this, &IMGMap::jobFinished);
-	job->run();
+	connect(job, &RenderJob::finished, this, &IMGMap::jobFinished);
+	_jobs.run(job);
 }
 
-void IMGMap::removeJob(IMGMapJob *job)
+void IMGMap::jobFinished(RenderJob *job)
 {
-	_jobs.removeOne(job);
-	job->deleteLater();
-}
-
-void IMGMap::jobFinished(IMGMapJob *job)
-{
-	const QList<IMG::RasterTile> &tiles = job->tiles();
+	const QList<IMG::RasterTile> &tiles = static_cast<IMGMapJob*>(job)->tiles();
 
 	for (int i = 0; i < tiles.size(); i++) {
 		const IMG::RasterTile &mt = tiles.at(i);
-		if (!mt.pixmap().isNull())
+		if (!mt.pixmap().isNull()) {
 			QPixmapCache::insert(mt.key(), mt.pixmap());
+			if (job->isPrefetch())
+				Prefetch::rendered(mt.key());
+		}
 	}
 
-	removeJob(job);
+	_jobs.remove(job);
 
 	emit tilesLoaded();
 }
 
-void IMGMap::cancelJobs(bool wait)
-{
-	for (int i = 0; i < _jobs.size(); i++)
-		_jobs.at(i)->cancel(wait);
-}
-
 void IMGMap::draw(QPainter *painter, const QRectF &rect, Flags flags)
 {
 	QPointF tl(floor(rect.left() / TILE_SIZE)
@@ -235,18 +219,19 @@ void IMGMap::draw(QPainter *painter, const QRectF &rect, Flags flags)
 			for (int j = 0; j < height; j++) {
 				QPixmap pm;
 				QPoint ttl(tl.x() + i * TILE_SIZE, tl.y() + j * TILE_SIZE);
-				QString key(_data.at(n)->fileName() + "-" + QString::number(_zoom)
-				  + "_" + QString::number(ttl.x()) + "_" + QString::number(ttl.y()));
+				QString tk(key(n, _zoom, ttl));
 
-				if (isRunning(key))
+				if (_jobs.isRunning(tk))
 					continue;
 
-				if (QPixmapCache::find(key, &pm))
+				if (QPixmapCache::find(tk, &pm)) {
 					painter->drawPixmap(ttl, pm);
-				else {
+					Prefetch::used(tk);
+					TRACE_COUNT("tiles cached", 1);
+				} else {
 					tiles.append(RasterTile(_projection, _transform, _data.at(n),
 					  _zoom, QRect(ttl, QSize(TILE_SIZE, TILE_SIZE)), _tileRatio,
-					  key, !n && flags & Map::HillShading, flags & Map::Rasters,
+					  tk, !n && flags & Map::HillShading, flags & Map::Rasters,
 					  flags & Map::Vectors));
 				}
 			}
@@ -254,6 +239,8 @@ void IMGMap::draw(QPainter *painter, const QRectF &rect, Flags flags)
 	}
 
 	if (!tiles.isEmpty()) {
+		_jobs.cancelPrefetch(_zoom);
+
 		if (flags & Map::Block) {
 			QFuture<void> future = QtConcurrent::map(tiles, &RasterTile::render);
 			future.waitForFinished();
@@ -265,10 +252,54 @@ void IMGMap::draw(QPainter *painter, const QRectF &rect, Flags flags)
 				QPixmapCache::insert(mt.key(), pm);
 			}
 		} else
-			runJob(new IMGMapJob(tiles));
+			runJob(new IMGMapJob(tiles, _zoom));
 	}
 }
 
+bool IMGMap::prefetch(const QRectF &rect, Flags flags)
+{
+	if (!_jobs.isEmpty())
+		return false;
+
+	QList<QPoint> ring(Prefetch::ringTiles(rect, _bounds, TILE_SIZE));
+	QList<QPoint> next;
+	Transform nt;
+	if (_zoom < _data.first()->zooms().max()) {
+		next = Prefetch::zoomTiles(rect, _bounds, TILE_SIZE);
+		nt = transform(_zoom + 1);
+	}
+
+	QList<RasterTile> tiles, nextTiles;
+	QPixmap pm;
+
+	for (int n = 0; n < _data.size(); n++) {
+		for (int i = 0; i < ring.size(); i++) {
+			QString tk(key(n, _zoom, ring.at(i)));
+			if (!QPixmapCache::find(tk, &pm))
+				tiles.append(RasterTile(_projection, _transform, _data.at(n),
+				  _zoom, QRect(ring.at(i), QSize(TILE_SIZE, TILE_SIZE)),
+				  _tileRatio, tk, !n && flags & Map::HillShading,
+				  flags & Map::Rasters, flags & Map::Vectors));
+		}
+		for (int i = 0; i < next.size(); i++) {
+			QString tk(key(n, _zoom + 1, next.at(i)));
+			if (!QPixmapCache::find(tk, &pm))
+				nextTiles.append(RasterTile(_projection, nt, _data.at(n),
+				  _zoom + 1, QRect(next.at(i), QSize(TILE_SIZE, TILE_SIZE)),
+				  _tileRatio, tk, !n && flags & Map::HillShading,
+				  flags & Map::Rasters, flags & Map::Vectors));
+		}
+	}
+
+	if (!tiles.isEmpty())
+		runJob(new IMGMapJob(tiles, _zoom, true));
+	/* A separate job, so that it survives the zoom in */
+	if (!nextTiles.isEmpty())
+		runJob(new IMGMapJob(nextTiles, _zoom + 1, true));
+
+	return true;
+}
+
 double IMGMap::elevation(const Coordinates &c)
 {
 	MapData *d = _data.first();
@@ -1,48 +1,15 @@
 #ifndef IMGMAP_H
 #define IMGMAP_H
 
-#include <QtConcurrent>
 #include "map.h"
 #include "projection.h"
 #include "transform.h"
+#include "renderjob.h"
 #include "IMG/mapdata.h"
 #include "IMG/rastertile.h"
 
 
-class IMGMapJob : public QObject
-{
-	Q_OBJECT
-
-public:
-	IMGMapJob(const QList<IMG::RasterTile> &tiles)
-	  : _tiles(tiles) {}
-
-	void run()
-	{
-		connect(&_watcher, &QFutureWatcher<void>::finished, this,
-		  &IMGMapJob::handleFinished);
-		_future = QtConcurrent::map(_tiles, &IMG::RasterTile::render);
-		_watcher.setFuture(_future);
-	}
-	void cancel(bool wait)
-	{
-		_future.cancel();
-		if (wait)
-			_future.waitForFinished();
-	}
-	const QList<IMG::RasterTile> &tiles() const {return _tiles;}
-
-signals:
-	void finished(IMGMapJob *job);
-
-private slots:
-	void handleFinished() {emit finished(this);}
-
-private:
-	QFutureWatcher<void> _watcher;
-	QFuture<void> _future;
-	QList<IMG::RasterTile> _tiles;
-};
+typedef TileJob<IMG::RasterTile, &IMG::RasterTile::render> IMGMapJob;
 
 class IMGMap : public Map
 {
@@ -69,6 +36,7 @@ public:
 	  {return _projection.xy2ll(_transform.img2proj(p));}
 
 	void draw(QPainter *painter, const QRectF &rect, Flags flags);
+	bool prefetch(const QRectF &rect, Flags flags);
 
 	void load(const Projection &in, const Projection &out, qreal devicelRatio,
 	  bool hidpi);
@@ -85,15 +53,13 @@ public:
 	  bool *isDir);
 
 private slots:
-	void jobFinished(IMGMapJob *job);
+	void jobFinished(RenderJob *job);
 
 private:
+	QString key(int n, int zoom, const QPoint &xy) const;
 	Transform transform(int zoom) const;
 	void updateTransform();
-	bool isRunning(const QString &key) const;
 	void runJob(IMGMapJob *job);
-	void removeJob(IMGMapJob *job);
-	void cancelJobs(bool wait);
 
 	QList<IMG::MapData *> _data;
 	int _zoom;
@@ -103,7 +69,7 @@ private:
 	RectC _dataBounds;
 	qreal _tileRatio;
 
-	QList<IMGMapJob*> _jobs;
+	RenderQueue _jobs;
 
 	bool _valid;
 	QString _errorString;
@@ -6,12 +6,14 @@
 #include <QRectF>
 #include <QFlags>
 #include "common/rectc.h"
+#include "common/range.h"
 #include "common/util.h"
 #include "dem.h"
 
 
 class QPainter;
 class Projection;
+class TileSeeder;
 
 class Map : public QObject
 {
@@ -56,13 +58,27 @@ public:
 
 	virtual QPointF ll2xy(const Coordinates &c) = 0;
 	virtual Coordinates xy2ll(const QPointF &p) = 0;
+	/* Maps that keep some state in ll2xy() must return false here to prevent
+	   parallel projection of the displayed data */
+	virtual bool ll2xyIsReentrant() const {return true;}
 
 	virtual void draw(QPainter *painter, const QRectF &rect, Flags flags) = 0;
+	/* Idle-time render-ahead of the tiles around rect (see Prefetch). Returns
+	   false if the map is busy and the prefetch shall be retried later. */
+	virtual bool prefetch(const QRectF &rect, Flags flags)
+	  {Q_UNUSED(rect); Q_UNUSED(flags); return true;}
 
 	virtual double elevation(const Coordinates &c) {return DEM::elevation(c);}
 
 	virtual void clearCache() {}
 
+	/* Offline area seeding, maps with downloadable tiles only. The seeder
+	   is owned by the map. */
+	virtual bool canSeed() const {return false;}
+	virtual Range seedZooms() const {return Range();}
+	virtual TileSeeder *seeder(const QList<RectC> &area, const Range &zooms)
+	  {Q_UNUSED(area); Q_UNUSED(zooms); return 0;}
+
 signals:
 	void tilesLoaded();
 	void mapLoaded();
@@ -0,0 +1,136 @@
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDataStream>
+#include <QDateTime>
+#include "mapcatalog.h"
+
+#define MAGIC   0x4D415043 // "MAPC"
+#define VERSION 2
+
+static QDataStream &operator<<(QDataStream &stream, const RectC &rect)
+{
+	stream << rect.left() << rect.top() << rect.right() << rect.bottom();
+	return stream;
+}
+
+static QDataStream &operator>>(QDataStream &stream, RectC &rect)
+{
+	double left, top, right, bottom;
+
+	stream >> left >> top >> right >> bottom;
+	rect = RectC(Coordinates(left, top), Coordinates(right, bottom));
+
+	return stream;
+}
+
+static QDataStream &operator<<(QDataStream &stream,
+  const MapCatalog::Entry &entry)
+{
+	stream << entry.size << entry.mtime << entry.parser << entry.isDir
+	  << entry.name << entry.error << entry.bounds;
+	return stream;
+}
+
+static QDataStream &operator>>(QDataStream &stream, MapCatalog::Entry &entry)
+{
+	stream >> entry.size >> entry.mtime >> entry.parser >> entry.isDir
+	  >> entry.name >> entry.error >> entry.bounds;
+
+	return stream;
+}
+
+static qint64 mtime(const QFileInfo &fi)
+{
+	return fi.lastModified().toMSecsSinceEpoch();
+}
+
+
+MapCatalog::MapCatalog(const QString &path)
+  : _path(path), _modified(false)
+{
+	if (!load())
+		_entries.clear();
+}
+
+bool MapCatalog::load()
+{
+	QFile file(_path);
+	quint32 magic, version;
+	qint32 count;
+
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	QDataStream stream(&file);
+	stream >> magic >> version >> count;
+	if (stream.status() != QDataStream::Ok || magic != MAGIC
+	  || version != VERSION || count < 0)
+		return false;
+
+	for (qint32 i = 0; i < count; i++) {
+		QString key;
+		Entry entry;
+
+		stream >> key >> entry;
+		if (stream.status() != QDataStream::Ok)
+			return false;
+		_entries.insert(key, entry);
+	}
+
+	return true;
+}
+
+bool MapCatalog::save()
+{
+	/* Only the entries used in this session are written, so entries of
+	   removed maps get dropped. */
+	if (!_modified && _used.size() == _entries.size())
+		return true;
+
+	QFileInfo fi(_path);
+	if (!QDir().mkpath(fi.absolutePath()))
+		return false;
+
+	QFile file(_path);
+	if (!file.open(QIODevice::WriteOnly)) {
+		qWarning("%s: %s", qUtf8Printable(_path),
+		  qUtf8Printable(file.errorString()));
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream << (quint32)MAGIC << (quint32)VERSION << (qint32)_used.size();
+	for (QSet<QString>::const_iterator it = _used.constBegin();
+	  it != _used.constEnd(); ++it)
+		stream << *it << _entries.value(*it);
+
+	return (stream.status() == QDataStream::Ok);
+}
+
+bool MapCatalog::find(const QFileInfo &fi, Entry &entry)
+{
+	QString key(fi.absoluteFilePath());
+	QHash<QString, Entry>::const_iterator it = _entries.constFind(key);
+
+	if (it == _entries.constEnd() || it->size != fi.size()
+	  || it->mtime != mtime(fi))
+		return false;
+
+	entry = *it;
+	_used.insert(key);
+
+	return true;
+}
+
+void MapCatalog::insert(const QFileInfo &fi, Entry &entry)
+{
+	QString key(fi.absoluteFilePath());
+
+	entry.size = fi.size();
+	entry.mtime = mtime(fi);
+
+	_entries.insert(key, entry);
+	_used.insert(key);
+	_modified = true;
+}
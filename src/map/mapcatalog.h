@@ -0,0 +1,45 @@
+#ifndef MAPCATALOG_H
+#define MAPCATALOG_H
+
+#include <QString>
+#include <QHash>
+#include <QSet>
+#include "common/rectc.h"
+
+class QFileInfo;
+
+/* Persistent cache of the map metadata required to build the maps menu. The
+   entries are keyed by the map path and are only valid as long as the file
+   size and modification time match the recorded ones. */
+class MapCatalog
+{
+public:
+	struct Entry {
+		Entry() : size(-1), mtime(-1), isDir(false) {}
+
+		qint64 size;
+		qint64 mtime;
+		/* Name of the map parser, empty for invalid maps */
+		QString parser;
+		bool isDir;
+		QString name;
+		QString error;
+		RectC bounds;
+	};
+
+	MapCatalog(const QString &path);
+
+	bool find(const QFileInfo &fi, Entry &entry);
+	void insert(const QFileInfo &fi, Entry &entry);
+	bool save();
+
+private:
+	bool load();
+
+	QString _path;
+	QHash<QString, Entry> _entries;
+	QSet<QString> _used;
+	bool _modified;
+};
+
+#endif // MAPCATALOG_H
@@ -1,6 +1,8 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QtConcurrent>
 #include "atlas.h"
 #include "ozimap.h"
 #include "jnxmap.h"
@@ -22,73 +24,102 @@
 #include "encmap.h"
 #include "encatlas.h"
 #include "invalidmap.h"
+#include "catalogmap.h"
+#include "mapcatalog.h"
 #include "maplist.h"
 
 
+/* The parsers are identified by their names in the map catalog */
+#define PARSER(cb) Parser(&cb, #cb)
+
 MapList::ParserMap MapList::parsers()
 {
 	MapList::ParserMap map;
 
-	map.insert("tar", &Atlas::createTAR);
-	map.insert("tar", &OziMap::createTAR);
-	map.insert("tba", &Atlas::createTBA);
-	map.insert("xml", &MapSource::create);
-	map.insert("xml", &IMGMap::createGMAP);
-	map.insert("img", &IMGMap::createIMG);
-	map.insert("jnx", &JNXMap::create);
-	map.insert("tif", &GeoTIFFMap::create);
-	map.insert("tiff", &GeoTIFFMap::create);
-	map.insert("mbtiles", &MBTilesMap::create);
-	map.insert("rmap", &RMap::create);
-	map.insert("rtmap", &RMap::create);
-	map.insert("map", &MapsforgeMap::create);
-	map.insert("map", &OziMap::createMAP);
-	map.insert("gmi", &OziMap::createGMI);
-	map.insert("kap", &BSBMap::create);
-	map.insert("kmz", &KMZMap::create);
-	map.insert("aqm", &AQMMap::create);
-	map.insert("sqlitedb", &SqliteMap::create);
-	map.insert("wld", &WorldFileMap::create);
-	map.insert("jgw", &WorldFileMap::create);
-	map.insert("gfw", &WorldFileMap::create);
-	map.insert("pgw", &WorldFileMap::create);
-	map.insert("tfw", &WorldFileMap::create);
-	map.insert("qct", &QCTMap::create);
-	map.insert("sqlite", &OsmdroidMap::create);
-	map.insert("gemf", &GEMFMap::create);
-	map.insert("otrk2.xml", &OruxMap::create);
-	map.insert("000", &ENCMap::create);
-	map.insert("031", &ENCAtlas::create);
+	map.insert("tar", PARSER(Atlas::createTAR));
+	map.insert("tar", PARSER(OziMap::createTAR));
+	map.insert("tba", PARSER(Atlas::createTBA));
+	map.insert("xml", PARSER(MapSource::create));
+	map.insert("xml", PARSER(IMGMap::createGMAP));
+	map.insert("img", PARSER(IMGMap::createIMG));
+	map.insert("jnx", PARSER(JNXMap::create));
+	map.insert("tif", PARSER(GeoTIFFMap::create));
+	map.insert("tiff", PARSER(GeoTIFFMap::create));
+	map.insert("mbtiles", PARSER(MBTilesMap::create));
+	map.insert("rmap", PARSER(RMap::create));
+	map.insert("rtmap", PARSER(RMap::create));
+	map.insert("map", PARSER(MapsforgeMap::create));
+	map.insert("map", PARSER(OziMap::createMAP));
+	map.insert("gmi", PARSER(OziMap::createGMI));
+	map.insert("kap", PARSER(BSBMap::create));
+	map.insert("kmz", PARSER(KMZMap::create));
+	map.insert("aqm", PARSER(AQMMap::create));
+	map.insert("sqlitedb", PARSER(SqliteMap::create));
+	map.insert("wld", PARSER(WorldFileMap::create));
+	map.insert("jgw", PARSER(WorldFileMap::create));
+	map.insert("gfw", PARSER(WorldFileMap::create));
+	map.insert("pgw", PARSER(WorldFileMap::create));
+	map.insert("tfw", PARSER(WorldFileMap::create));
+	map.insert("qct", PARSER(QCTMap::create));
+	map.insert("sqlite", PARSER(OsmdroidMap::create));
+	map.insert("gemf", PARSER(GEMFMap::create));
+	map.insert("otrk2.xml", PARSER(OruxMap::create));
+	map.insert("000", PARSER(ENCMap::create));
+	map.insert("031", PARSER(ENCAtlas::create));
 
 	return map;
 }
 
 MapList::ParserMap MapList::_parsers = MapList::parsers();
 
-Map *MapList::loadFile(const QString &path, const Projection &proj, bool *isDir)
+MapList::ParserCb MapList::parser(const QString &name)
+{
+	for (ParserMap::const_iterator it = _parsers.constBegin();
+	  it != _parsers.constEnd(); ++it)
+		if (name == it.value().name)
+			return it.value().cb;
+
+	return 0;
+}
+
+/* Maps created by these parsers depend on the input projection and can thus
+   not be restored from the map catalog. */
+bool MapList::usesProjection(ParserCb cb)
+{
+	return (cb == &Atlas::createTAR || cb == &Atlas::createTBA
+	  || cb == &OziMap::createTAR || cb == &OziMap::createMAP
+	  || cb == &OziMap::createGMI || cb == &WorldFileMap::create);
+}
+
+Map *MapList::loadFile(const QString &path, const Projection &proj, bool *isDir,
+  QString *parser)
 {
-	ParserMap::iterator it;
+	ParserMap::const_iterator it;
 	QFileInfo fi(Util::displayName(path));
 	QString suffix(fi.completeSuffix().toLower());
 	Map *map = 0;
 	QStringList errors;
 
-	if ((it = _parsers.find(suffix)) != _parsers.end()) {
-		while (it != _parsers.end() && it.key() == suffix) {
+	if ((it = _parsers.constFind(suffix)) != _parsers.constEnd()) {
+		while (it != _parsers.constEnd() && it.key() == suffix) {
 			delete map;
-			map = it.value()(path, proj, isDir);
-			if (map->isValid())
+			map = it.value().cb(path, proj, isDir);
+			if (map->isValid()) {
+				if (parser)
+					*parser = it.value().name;
 				return map;
-			else
+			} else
 				errors.append(it.key() + ": " + map->errorString());
 			++it;
 		}
 	} else {
-		for (it = _parsers.begin(); it != _parsers.end(); it++) {
-			map = it.value()(path, proj, isDir);
-			if (map->isValid())
+		for (it = _parsers.constBegin(); it != _parsers.constEnd(); it++) {
+			map = it.value().cb(path, proj, isDir);
+			if (map->isValid()) {
+				if (parser)
+					*parser = it.value().name;
 				return map;
-			else {
+			} else {
 				errors.append(it.key() + ": " + map->errorString());
 				delete map;
 				map = 0;
@@ -100,11 +131,77 @@ Map *MapList::loadFile(const QString &path, const Projection &proj, bool *isDir)
 	for (int i = 0; i < errors.size(); i++)
 		qWarning("  %s", qUtf8Printable(errors.at(i)));
 
+	if (parser)
+		*parser = QString();
+
 	return map ? map : new InvalidMap(path, "Unknown file format");
 }
 
+/* Parsers of some formats may claim the whole directory, use SQLite
+   connections or the network and thus must run on the GUI thread. The same
+   holds for files with an unknown (complete) suffix as all the parsers are
+   tried for them. */
+bool MapList::serialProbe(const QFileInfo &fi)
+{
+	QString suffix(fi.suffix().toLower());
+	QString completeSuffix(QFileInfo(Util::displayName(fi.absoluteFilePath()))
+	  .completeSuffix().toLower());
+
+	return (!_parsers.contains(completeSuffix) || suffix == "xml"
+	  || suffix == "tar" || suffix == "tba" || suffix == "031"
+	  || suffix == "mbtiles" || suffix == "sqlite" || suffix == "sqlitedb");
+}
+
+void MapList::Probe::run()
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	map = loadFile(fi.absoluteFilePath(), *proj, &isDir, &parser);
+	map->moveToThread(QApplication::instance()->thread());
+
+	time = timer.elapsed();
+}
+
+Map *MapList::catalogMap(const QFileInfo &fi, const Projection &proj,
+  MapCatalog *catalog, bool *isDir)
+{
+	MapCatalog::Entry entry;
+
+	if (!catalog->find(fi, entry))
+		return 0;
+
+	*isDir = entry.isDir;
+	if (entry.parser.isEmpty())
+		return new InvalidMap(fi.absoluteFilePath(), entry.error);
+	ParserCb cb = parser(entry.parser);
+	return cb ? new CatalogMap(fi.absoluteFilePath(), entry.name, entry.bounds,
+	  cb, proj) : 0;
+}
+
+void MapList::updateCatalog(MapCatalog *catalog, const Probe &probe)
+{
+	MapCatalog::Entry entry;
+
+	if (probe.parser.isEmpty()) {
+		entry.isDir = probe.isDir;
+		entry.error = probe.map->errorString();
+		catalog->insert(probe.fi, entry);
+	} else if (probe.map->isReady() && !usesProjection(parser(probe.parser))) {
+		entry.parser = probe.parser;
+		entry.isDir = probe.isDir;
+		entry.name = probe.map->name();
+		entry.bounds = probe.map->llBounds();
+		catalog->insert(probe.fi, entry);
+	}
+}
+
+/* Walks the directory tree and adds the maps that have to be probed on the
+   worker threads as null placeholders to the tree. All files precede the
+   subdirectories, so the placeholders order matches the probes order in
+   a (items, childs) depth-first traversal. */
 TreeNode<Map*> MapList::loadDir(const QString &path, const Projection &proj,
-  TreeNode<Map*> *parent)
+  MapCatalog *catalog, QList<Probe> &probes, TreeNode<Map*> *parent)
 {
 	QDir md(path);
 	md.setFilter(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
@@ -121,12 +218,32 @@ TreeNode<Map*> MapList::loadDir(const QString &path, const Projection &proj,
 		QString suffix = fi.suffix().toLower();
 
 		if (fi.isDir()) {
-			TreeNode<Map*> child(loadDir(fi.absoluteFilePath(), proj, &tree));
+			TreeNode<Map*> child(loadDir(fi.absoluteFilePath(), proj, catalog,
+			  probes, &tree));
 			if (!child.isEmpty())
 				tree.addChild(child);
 		} else if (filter().contains("*." + suffix)) {
 			bool isDir = false;
-			Map *map = loadFile(fi.absoluteFilePath(), proj, &isDir);
+			Map *map = catalog ? catalogMap(fi, proj, catalog, &isDir) : 0;
+
+			if (!map) {
+				Probe probe(fi, proj);
+
+				if (!serialProbe(fi)) {
+					probes.append(probe);
+					tree.addItem(0);
+					continue;
+				}
+
+				probe.run();
+				qDebug("%s: %lld ms", qUtf8Printable(probe.fi.filePath()),
+				  (long long)probe.time);
+				if (catalog)
+					updateCatalog(catalog, probe);
+				map = probe.map;
+				isDir = probe.isDir;
+			}
+
 			if (isDir) {
 				if (parent)
 					parent->addItem(map);
@@ -141,11 +258,42 @@ TreeNode<Map*> MapList::loadDir(const QString &path, const Projection &proj,
 	return tree;
 }
 
-TreeNode<Map *> MapList::loadMaps(const QString &path, const Projection &proj)
+void MapList::resolve(TreeNode<Map*> &node, const QList<Probe> &probes,
+  int &index)
 {
-	if (QFileInfo(path).isDir())
-		return loadDir(path, proj);
-	else {
+	QList<Map*> &items = node.ritems();
+	for (int i = 0; i < items.size(); i++)
+		if (!items.at(i))
+			items[i] = probes.at(index++).map;
+
+	QList<TreeNode<Map*> > &childs = node.rchilds();
+	for (int i = 0; i < childs.size(); i++)
+		resolve(childs[i], probes, index);
+}
+
+TreeNode<Map *> MapList::loadMaps(const QString &path, const Projection &proj,
+  MapCatalog *catalog)
+{
+	if (QFileInfo(path).isDir()) {
+		QList<Probe> probes;
+		TreeNode<Map*> tree(loadDir(path, proj, catalog, probes));
+
+		QtConcurrent::blockingMap(probes, &Probe::run);
+
+		for (int i = 0; i < probes.size(); i++) {
+			const Probe &probe = probes.at(i);
+			qDebug("%s: %lld ms", qUtf8Printable(probe.fi.filePath()),
+			  (long long)probe.time);
+			if (catalog)
+				updateCatalog(catalog, probe);
+		}
+
+		int index = 0;
+		resolve(tree, probes, index);
+		Q_ASSERT(index == probes.size());
+
+		return tree;
+	} else {
 		TreeNode<Map*> tree;
 		tree.addItem(loadFile(path, proj));
 		return tree;
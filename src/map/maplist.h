@@ -2,28 +2,65 @@
 #define MAPLIST_H
 
 #include <QString>
+#include <QFileInfo>
 #include "common/treenode.h"
 
 class Map;
 class Projection;
+class MapCatalog;
 
 class MapList
 {
 public:
-	static TreeNode<Map*> loadMaps(const QString &path, const Projection &proj);
+	static TreeNode<Map*> loadMaps(const QString &path, const Projection &proj,
+	  MapCatalog *catalog = 0);
 	static QString formats();
 	static QStringList filter();
 
 private:
 	typedef Map*(*ParserCb)(const QString &, const Projection &, bool *);
-	typedef QMultiMap<QString, ParserCb> ParserMap;
+
+	struct Parser
+	{
+		Parser() : cb(0), name(0) {}
+		Parser(ParserCb cb, const char *name) : cb(cb), name(name) {}
+
+		ParserCb cb;
+		const char *name;
+	};
+	typedef QMultiMap<QString, Parser> ParserMap;
+
+	class Probe
+	{
+	public:
+		Probe() : proj(0), map(0), isDir(false), time(0) {}
+		Probe(const QFileInfo &fi, const Projection &proj)
+		  : fi(fi), proj(&proj), map(0), isDir(false), time(0) {}
+
+		void run();
+
+		QFileInfo fi;
+		const Projection *proj;
+		Map *map;
+		bool isDir;
+		QString parser;
+		qint64 time;
+	};
 
 	static Map *loadFile(const QString &path, const Projection &proj,
-	  bool *isDir = 0);
+	  bool *isDir = 0, QString *parser = 0);
+	static Map *catalogMap(const QFileInfo &fi, const Projection &proj,
+	  MapCatalog *catalog, bool *isDir);
+	static void updateCatalog(MapCatalog *catalog, const Probe &probe);
 	static TreeNode<Map*> loadDir(const QString &path, const Projection &proj,
-	  TreeNode<Map*> *parent = 0);
+	  MapCatalog *catalog, QList<Probe> &probes, TreeNode<Map*> *parent = 0);
+	static void resolve(TreeNode<Map*> &node, const QList<Probe> &probes,
+	  int &index);
+	static bool serialProbe(const QFileInfo &fi);
 
 	static ParserMap parsers();
+	static ParserCb parser(const QString &name);
+	static bool usesProjection(ParserCb cb);
 	static ParserMap _parsers;
 };
 
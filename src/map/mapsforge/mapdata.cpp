@@ -3,6 +3,7 @@
 #include <QFile>
 #include <QDataStream>
 #include <QColor>
+#include "common/trace.h"
 #include "map/osm.h"
 #include "subfile.h"
 #include "mapdata.h"
@@ -264,6 +265,8 @@ bool MapData::readSubFiles(QFile &file)
 				offset = nextOffset;
 			}
 		}
+
+		_tiles.last()->Pack();
 	}
 
 	return true;
@@ -421,7 +424,9 @@ bool MapData::readHeader(QFile &file)
 	return true;
 }
 
-MapData::MapData(const QString &fileName) : _fileName(fileName), _valid(false)
+MapData::MapData(const QString &fileName) : _fileName(fileName),
+  _pathCache("Mapsforge paths", &_pathCacheLock),
+  _pointCache("Mapsforge points", &_pointCacheLock), _valid(false)
 {
 	QFile file(fileName);
 
@@ -433,9 +438,6 @@ MapData::MapData(const QString &fileName) : _fileName(fileName), _valid(false)
 	if (!readHeader(file))
 		return;
 
-	_pathCache.setMaxCost(2048);
-	_pointCache.setMaxCost(2048);
-
 	_valid = true;
 }
 
@@ -469,20 +471,22 @@ void MapData::load()
 
 void MapData::clear()
 {
+	_pathCacheLock.lock();
 	_pathCache.clear();
+	_pathCacheLock.unlock();
+	_pointCacheLock.lock();
 	_pointCache.clear();
+	_pointCacheLock.unlock();
 
 	clearTiles();
 }
 
 void MapData::clearTiles()
 {
-	TileTree::Iterator it;
-
 	for (int i = 0; i < _tiles.size(); i++) {
 		TileTree *t = _tiles.at(i);
-		for (t->GetFirst(it); !t->IsNull(it); t->GetNext(it))
-			delete t->GetAt(it);
+		for (int j = 0; j < t->Count(); j++)
+			delete t->At(j);
 	}
 
 	qDeleteAll(_tiles);
@@ -535,7 +539,7 @@ void MapData::points(QFile &file, VectorTile *tile, const RectC &rect,
 {
 	Key key(tile, zoom);
 
-	tile->lock.lock();
+	TRACE_LOCK(tile->lock);
 
 	_pointCacheLock.lock();
 	QList<Point> *tilePoints = _pointCache.object(key);
@@ -545,7 +549,7 @@ void MapData::points(QFile &file, VectorTile *tile, const RectC &rect,
 		if (readPoints(file, tile, zoom, p)) {
 			copyPoints(rect, p, list);
 			_pointCacheLock.lock();
-			_pointCache.insert(key, p);
+			_pointCache.insert(key, p, cost(p));
 			_pointCacheLock.unlock();
 		} else
 			delete p;
@@ -562,7 +566,7 @@ void MapData::points(QFile &file, VectorTile *tile, const RectC &rect,
 		if (readPaths(file, tile, zoom, p)) {
 			copyPoints(rect, p, list);
 			_pathCacheLock.lock();
-			_pathCache.insert(key, p);
+			_pathCache.insert(key, p, cost(p));
 			_pathCacheLock.unlock();
 		} else
 			delete p;
@@ -572,6 +576,8 @@ void MapData::points(QFile &file, VectorTile *tile, const RectC &rect,
 	}
 
 	tile->lock.unlock();
+
+	CacheBudget::enforce();
 }
 
 void MapData::paths(QFile &file, const RectC &searchRect,
@@ -597,7 +603,7 @@ void MapData::paths(QFile &file, VectorTile *tile, const RectC &rect, int zoom,
 {
 	Key key(tile, zoom);
 
-	tile->lock.lock();
+	TRACE_LOCK(tile->lock);
 
 	_pathCacheLock.lock();
 	QList<Path> *cached = _pathCache.object(key);
@@ -607,7 +613,7 @@ void MapData::paths(QFile &file, VectorTile *tile, const RectC &rect, int zoom,
 		if (readPaths(file, tile, zoom, p)) {
 			copyPaths(rect, p, list);
 			_pathCacheLock.lock();
-			_pathCache.insert(key, p);
+			_pathCache.insert(key, p, cost(p));
 			_pathCacheLock.unlock();
 		} else
 			delete p;
@@ -617,6 +623,44 @@ void MapData::paths(QFile &file, VectorTile *tile, const RectC &rect, int zoom,
 	}
 
 	tile->lock.unlock();
+
+	CacheBudget::enforce();
+}
+
+static qint64 tagsCost(const QVector<MapData::Tag> &tags)
+{
+	qint64 cost = tags.size() * sizeof(MapData::Tag);
+
+	for (int i = 0; i < tags.size(); i++)
+		cost += tags.at(i).value.size();
+
+	return cost;
+}
+
+qint64 MapData::cost(const QList<Point> *points)
+{
+	qint64 cost = points->size() * sizeof(Point);
+
+	for (int i = 0; i < points->size(); i++)
+		cost += tagsCost(points->at(i).tags);
+
+	return cost;
+}
+
+qint64 MapData::cost(const QList<Path> *paths)
+{
+	qint64 cost = paths->size() * sizeof(Path);
+
+	for (int i = 0; i < paths->size(); i++) {
+		const Path &path = paths->at(i);
+
+		cost += tagsCost(path.point.tags);
+		for (int j = 0; j < path.poly.size(); j++)
+			cost += sizeof(QVector<Coordinates>)
+			  + path.poly.at(j).size() * sizeof(Coordinates);
+	}
+
+	return cost;
 }
 
 bool MapData::readPaths(QFile &file, const VectorTile *tile, int zoom,
@@ -2,13 +2,13 @@
 #define MAPSFORGE_MAPDATA_H
 
 #include <QFile>
-#include <QCache>
 #include <QMutex>
 #include "common/hash.h"
 #include "common/rectc.h"
-#include "common/rtree.h"
+#include "common/packedrtree.h"
 #include "common/range.h"
 #include "common/polygon.h"
+#include "map/cachebudget.h"
 
 #define ID_NAME   1
 #define ID_HOUSE  2
@@ -142,7 +142,7 @@ private:
 		unsigned id;
 	};
 
-	typedef RTree<VectorTile *, double, 2> TileTree;
+	typedef PackedRTree<VectorTile *> TileTree;
 
 	bool readZoomInfo(SubFile &hdr);
 	bool readTagInfo(SubFile &hdr);
@@ -167,6 +167,9 @@ private:
 	static bool pathCb(VectorTile *tile, void *context);
 	static bool pointCb(VectorTile *tile, void *context);
 
+	static qint64 cost(const QList<Point> *points);
+	static qint64 cost(const QList<Path> *paths);
+
 	friend HASH_T qHash(const MapData::Key &key);
 
 	QString _fileName;
@@ -177,9 +180,10 @@ private:
 	QList<TileTree*> _tiles;
 	QHash<QByteArray, unsigned> _keys;
 
-	QCache<Key, QList<Path> > _pathCache;
-	QCache<Key, QList<Point> > _pointCache;
+	/* The locks must outlive the caches (budget eviction) */
 	QMutex _pathCacheLock, _pointCacheLock;
+	BudgetCache<Key, QList<Path> > _pathCache;
+	BudgetCache<Key, QList<Point> > _pointCache;
 
 	bool _valid;
 	QString _errorString;
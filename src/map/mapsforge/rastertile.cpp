@@ -1,6 +1,8 @@
 #include <cmath>
 #include <QPainter>
+#include <QVarLengthArray>
 #include <QCache>
+#include "common/trace.h"
 #include "map/dem.h"
 #include "map/rectd.h"
 #include "map/hillshading.h"
@@ -244,11 +246,20 @@ void RasterTile::drawTextItems(QPainter *painter,
 	}
 }
 
+void RasterTile::ll2xy(const Coordinates *c, QPointF *p, int n) const
+{
+	QVarLengthArray<PointD, 256> xy(n);
+
+	_proj.ll2xy(c, xy.data(), n);
+	_transform.proj2img(xy.constData(), p, n);
+}
+
 QPainterPath RasterTile::painterPath(const Polygon &polygon, bool curve) const
 {
 	QPainterPath path;
 
 	if (curve) {
+		QVarLengthArray<QPointF, 256> xy;
 		int size = 0;
 		for (int i = 0; i < polygon.size(); i++)
 			size += polygon.at(i).size();
@@ -257,13 +268,16 @@ QPainterPath RasterTile::painterPath(const Polygon &polygon, bool curve) const
 		for (int i = 0; i < polygon.size(); i++) {
 			const QVector<Coordinates> &subpath = polygon.at(i);
 
-			QPointF p1(ll2xy(subpath.first()));
+			xy.resize(subpath.size());
+			ll2xy(subpath.constData(), xy.data(), subpath.size());
+
+			QPointF p1(xy.at(0));
 			QPointF p2(0, 0);
 			QPointF p3(0, 0);
 
 			path.moveTo(p1);
 			for (int j = 1; j < subpath.size(); j++) {
-				p3 = ll2xy(subpath.at(j));
+				p3 = xy.at(j);
 				p2 = QPointF((p1.x() + p3.x()) / 2.0, (p1.y() + p3.y()) / 2.0);
 				path.quadTo(p1, p2);
 				p1 = p3;
@@ -275,8 +289,7 @@ QPainterPath RasterTile::painterPath(const Polygon &polygon, bool curve) const
 			const QVector<Coordinates> &subpath = polygon.at(i);
 
 			QVector<QPointF> p(subpath.size());
-			for (int j = 0; j < subpath.size(); j++)
-				p[j] = ll2xy(subpath.at(j));
+			ll2xy(subpath.constData(), p.data(), subpath.size());
 			path.addPolygon(p);
 		}
 	}
@@ -450,6 +463,9 @@ MatrixD RasterTile::elevation(int extend) const
 
 void RasterTile::render()
 {
+	TRACE_SCOPE("Mapsforge::RasterTile::render");
+	TRACE_COUNT("tiles rendered", 1);
+
 	QImage img(_rect.width() * _ratio, _rect.height() * _ratio,
 	  QImage::Format_ARGB32_Premultiplied);
 	QList<MapData::Path> paths;
@@ -25,12 +25,14 @@ class RasterTile
 public:
 	RasterTile(const Projection &proj, const Transform &transform,
 	  const Style *style, MapData *data, int zoom, const QRect &rect,
-	  qreal ratio, bool hillShading)
+	  qreal ratio, const QString &key, bool hillShading)
 		: _proj(proj), _transform(transform), _style(style), _data(data),
-		_zoom(zoom), _rect(rect), _ratio(ratio), _hillShading(hillShading) {}
+		_zoom(zoom), _rect(rect), _ratio(ratio), _key(key),
+		_hillShading(hillShading) {}
 
 	int zoom() const {return _zoom;}
 	QPoint xy() const {return _rect.topLeft();}
+	const QString &key() const {return _key;}
 	const QPixmap &pixmap() const {return _pixmap;}
 
 	void render();
@@ -219,6 +221,7 @@ private:
 	  QVector<RasterTile::RenderInstruction> &instructions) const;
 	QPointF ll2xy(const Coordinates &c) const
 	  {return _transform.proj2img(_proj.ll2xy(c));}
+	void ll2xy(const Coordinates *c, QPointF *p, int n) const;
 	Coordinates xy2ll(const QPointF &p) const
 	  {return _proj.xy2ll(_transform.img2proj(p));}
 	void processLabels(const QList<MapData::Point> &points,
@@ -239,6 +242,7 @@ private:
 	int _zoom;
 	QRect _rect;
 	qreal _ratio;
+	QString _key;
 	QPixmap _pixmap;
 	bool _hillShading;
 };
@@ -1,9 +1,12 @@
 #include <QPainter>
 #include <QPixmapCache>
+#include <QtConcurrent>
 #include "common/wgs84.h"
 #include "common/util.h"
+#include "common/trace.h"
 #include "rectd.h"
 #include "pcs.h"
+#include "prefetch.h"
 #include "mapsforgemap.h"
 
 
@@ -38,7 +41,7 @@ void MapsforgeMap::load(const Projection &in, const Projection &out,
 
 void MapsforgeMap::unload()
 {
-	cancelJobs(true);
+	_jobs.cancel(true);
 
 	_data.clear();
 	_style.clear();
@@ -68,19 +71,17 @@ int MapsforgeMap::zoomFit(const QSize &size, const RectC &rect)
 
 int MapsforgeMap::zoomIn()
 {
-	cancelJobs(false);
-
 	_zoom = qMin(_zoom + 1, _data.zooms().max());
 	updateTransform();
+	_jobs.cancelStale(_zoom);
 	return _zoom;
 }
 
 int MapsforgeMap::zoomOut()
 {
-	cancelJobs(false);
-
 	_zoom = qMax(_zoom - 1, _data.zooms().min());
 	updateTransform();
+	_jobs.cancelStale(_zoom);
 	return _zoom;
 }
 
@@ -88,6 +89,7 @@ void MapsforgeMap::setZoom(int zoom)
 {
 	_zoom = zoom;
 	updateTransform();
+	_jobs.cancelStale(_zoom);
 }
 
 Transform MapsforgeMap::transform(int zoom) const
@@ -119,55 +121,31 @@ QString MapsforgeMap::key(int zoom, const QPoint &xy) const
 	  + QString::number(xy.x()) + "_" + QString::number(xy.y());
 }
 
-bool MapsforgeMap::isRunning(int zoom, const QPoint &xy) const
-{
-	for (int i = 0; i < _jobs.size(); i++) {
-		const QList<Mapsforge::RasterTile> &tiles = _jobs.at(i)->tiles();
-		for (int j = 0; j < tiles.size(); j++) {
-			const Mapsforge::RasterTile &mt = tiles.at(j);
-			if (mt.zoom() == zoom && mt.xy() == xy)
-				return true;
-		}
-	}
-
-	return false;
-}
-
 void MapsforgeMap::runJob(MapsforgeMapJob *job)
 {
-	_jobs.append(job);
-
-	connect(job, &MapsforgeMapJob::finished, this, &MapsforgeMap::jobFinished);
-	job->run();
-}
-
-void MapsforgeMap::removeJob(MapsforgeMapJob *job)
-{
-	_jobs.removeOne(job);
-	job->deleteLater();
+	connect(job, &RenderJob::finished, this, &MapsforgeMap::jobFinished);
+	_jobs.run(job);
 }
 
-void MapsforgeMap::jobFinished(MapsforgeMapJob *job)
+void MapsforgeMap::jobFinished(RenderJob *job)
 {
-	const QList<Mapsforge::RasterTile> &tiles = job->tiles();
+	const QList<Mapsforge::RasterTile> &tiles
+	  = static_cast<MapsforgeMapJob*>(job)->tiles();
 
 	for (int i = 0; i < tiles.size(); i++) {
 		const Mapsforge::RasterTile &mt = tiles.at(i);
-		if (!mt.pixmap().isNull())
-			QPixmapCache::insert(key(mt.zoom(), mt.xy()), mt.pixmap());
+		if (!mt.pixmap().isNull()) {
+			QPixmapCache::insert(mt.key(), mt.pixmap());
+			if (job->isPrefetch())
+				Prefetch::rendered(mt.key());
+		}
 	}
 
-	removeJob(job);
+	_jobs.remove(job);
 
 	emit tilesLoaded();
 }
 
-void MapsforgeMap::cancelJobs(bool wait)
-{
-	for (int i = 0; i < _jobs.size(); i++)
-		_jobs.at(i)->cancel(wait);
-}
-
 void MapsforgeMap::draw(QPainter *painter, const QRectF &rect, Flags flags)
 {
 	int tileSize = _data.tileSize();
@@ -182,21 +160,26 @@ void MapsforgeMap::draw(QPainter *painter, const QRectF &rect, Flags flags)
 	for (int i = 0; i < width; i++) {
 		for (int j = 0; j < height; j++) {
 			QPoint ttl(tl.x() + i * tileSize, tl.y() + j * tileSize);
-			if (isRunning(_zoom, ttl))
+			QString tk(key(_zoom, ttl));
+			if (_jobs.isRunning(tk))
 				continue;
 
 			QPixmap pm;
-			if (QPixmapCache::find(key(_zoom, ttl), &pm))
+			if (QPixmapCache::find(tk, &pm)) {
 				painter->drawPixmap(ttl, pm);
-			else {
+				Prefetch::used(tk);
+				TRACE_COUNT("tiles cached", 1);
+			} else {
 				tiles.append(RasterTile(_projection, _transform, &_style, &_data,
-				  _zoom, QRect(ttl, QSize(tileSize, tileSize)), _tileRatio,
+				  _zoom, QRect(ttl, QSize(tileSize, tileSize)), _tileRatio, tk,
 				  flags & Map::HillShading));
 			}
 		}
 	}
 
 	if (!tiles.isEmpty()) {
+		_jobs.cancelPrefetch(_zoom);
+
 		if (flags & Map::Block) {
 			QFuture<void> future = QtConcurrent::map(tiles, &RasterTile::render);
 			future.waitForFinished();
@@ -205,11 +188,53 @@ void MapsforgeMap::draw(QPainter *painter, const QRectF &rect, Flags flags)
 				const RasterTile &mt = tiles.at(i);
 				const QPixmap &pm = mt.pixmap();
 				painter->drawPixmap(mt.xy(), pm);
-				QPixmapCache::insert(key(mt.zoom(), mt.xy()), pm);
+				QPixmapCache::insert(mt.key(), pm);
 			}
 		} else
-			runJob(new MapsforgeMapJob(tiles));
+			runJob(new MapsforgeMapJob(tiles, _zoom));
+	}
+}
+
+bool MapsforgeMap::prefetch(const QRectF &rect, Flags flags)
+{
+	if (!_jobs.isEmpty())
+		return false;
+
+	int tileSize = _data.tileSize();
+	QList<QPoint> ring(Prefetch::ringTiles(rect, _bounds, tileSize));
+	QList<RasterTile> tiles;
+	QPixmap pm;
+
+	for (int i = 0; i < ring.size(); i++) {
+		QString tk(key(_zoom, ring.at(i)));
+		if (!QPixmapCache::find(tk, &pm))
+			tiles.append(RasterTile(_projection, _transform, &_style, &_data,
+			  _zoom, QRect(ring.at(i), QSize(tileSize, tileSize)), _tileRatio,
+			  tk, flags & Map::HillShading));
 	}
+
+	if (!tiles.isEmpty())
+		runJob(new MapsforgeMapJob(tiles, _zoom, true));
+
+	/* A separate job, so that it survives the zoom in */
+	if (_zoom < _data.zooms().max()) {
+		QList<QPoint> next(Prefetch::zoomTiles(rect, _bounds, tileSize));
+		Transform nt(transform(_zoom + 1));
+		QList<RasterTile> nextTiles;
+
+		for (int i = 0; i < next.size(); i++) {
+			QString tk(key(_zoom + 1, next.at(i)));
+			if (!QPixmapCache::find(tk, &pm))
+				nextTiles.append(RasterTile(_projection, nt, &_style, &_data,
+				  _zoom + 1, QRect(next.at(i), QSize(tileSize, tileSize)),
+				  _tileRatio, tk, flags & Map::HillShading));
+		}
+
+		if (!nextTiles.isEmpty())
+			runJob(new MapsforgeMapJob(nextTiles, _zoom + 1, true));
+	}
+
+	return true;
 }
 
 Map *MapsforgeMap::create(const QString &path, const Projection &proj,
@@ -1,48 +1,16 @@
 #ifndef MAPSFORGEMAP_H
 #define MAPSFORGEMAP_H
 
-#include <QtConcurrent>
 #include "mapsforge/mapdata.h"
 #include "mapsforge/rastertile.h"
 #include "projection.h"
 #include "transform.h"
+#include "renderjob.h"
 #include "map.h"
 
 
-class MapsforgeMapJob : public QObject
-{
-	Q_OBJECT
-
-public:
-	MapsforgeMapJob(const QList<Mapsforge::RasterTile> &tiles)
-	  : _tiles(tiles) {}
-
-	void run()
-	{
-		connect(&_watcher, &QFutureWatcher<void>::finished, this,
-		  &MapsforgeMapJob::handleFinished);
-		_future = QtConcurrent::map(_tiles, &Mapsforge::RasterTile::render);
-		_watcher.setFuture(_future);
-	}
-	void cancel(bool wait)
-	{
-		_future.cancel();
-		if (wait)
-			_future.waitForFinished();
-	}
-	const QList<Mapsforge::RasterTile> &tiles() const {return _tiles;}
-
-signals:
-	void finished(MapsforgeMapJob *job);
-
-private slots:
-	void handleFinished() {emit finished(this);}
-
-private:
-	QFutureWatcher<void> _watcher;
-	QFuture<void> _future;
-	QList<Mapsforge::RasterTile> _tiles;
-};
+typedef TileJob<Mapsforge::RasterTile, &Mapsforge::RasterTile::render>
+  MapsforgeMapJob;
 
 class MapsforgeMap : public Map
 {
@@ -70,6 +38,7 @@ public:
 	  {return _projection.xy2ll(_transform.img2proj(p));}
 
 	void draw(QPainter *painter, const QRectF &rect, Flags flags);
+	bool prefetch(const QRectF &rect, Flags flags);
 
 	bool isValid() const {return _data.isValid();}
 	QString errorString() const {return _data.errorString();}
@@ -77,16 +46,13 @@ public:
 	static Map *create(const QString &path, const Projection &proj, bool *isMap);
 
 private slots:
-	void jobFinished(MapsforgeMapJob *job);
+	void jobFinished(RenderJob *job);
 
 private:
 	QString key(int zoom, const QPoint &xy) const;
 	Transform transform(int zoom) const;
 	void updateTransform();
-	bool isRunning(int zoom, const QPoint &xy) const;
 	void runJob(MapsforgeMapJob *job);
-	void removeJob(MapsforgeMapJob *job);
-	void cancelJobs(bool wait);
 
 	Mapsforge::MapData _data;
 	Mapsforge::Style _style;
@@ -97,7 +63,7 @@ private:
 	QRectF _bounds;
 	qreal _tileRatio;
 
-	QList<MapsforgeMapJob*> _jobs;
+	RenderQueue _jobs;
 };
 
 #endif // MAPSFORGEMAP_H
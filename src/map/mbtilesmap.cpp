@@ -253,7 +253,7 @@ void MBTilesMap::load(const Projection &in, const Projection &out,
 
 void MBTilesMap::unload()
 {
-	cancelJobs(true);
+	_jobs.cancel(true);
 	_db.close();
 }
 
@@ -290,17 +290,15 @@ qreal MBTilesMap::resolution(const QRectF &rect)
 
 int MBTilesMap::zoomIn()
 {
-	cancelJobs(false);
-
 	_zi = qMin(_zi + 1, _zooms.size() - 1);
+	_jobs.cancelStale(_zi);
 	return _zi;
 }
 
 int MBTilesMap::zoomOut()
 {
-	cancelJobs(false);
-
 	_zi = qMax(_zi - 1, 0);
+	_jobs.cancelStale(_zi);
 	return _zi;
 }
 
@@ -335,35 +333,15 @@ QByteArray MBTilesMap::tileData(int zoom, const QPoint &tile) const
 	return QByteArray();
 }
 
-bool MBTilesMap::isRunning(const QString &key) const
-{
-	for (int i = 0; i < _jobs.size(); i++) {
-		const QList<MBTile> &tiles = _jobs.at(i)->tiles();
-		for (int j = 0; j < tiles.size(); j++)
-			if (tiles.at(j).key() == key)
-				return true;
-	}
-
-	return false;
-}
-
 void MBTilesMap::runJob(MBTilesMapJob *job)
 {
-	_jobs.append(job);
-
-	connect(job, &MBTilesMapJob::finished, this, &MBTilesMap::jobFinished);
-	job->run();
-}
-
-void MBTilesMap::removeJob(MBTilesMapJob *job)
-{
-	_jobs.removeOne(job);
-	job->deleteLater();
+	connect(job, &RenderJob::finished, this, &MBTilesMap::jobFinished);
+	_jobs.run(job);
 }
 
-void MBTilesMap::jobFinished(MBTilesMapJob *job)
+void MBTilesMap::jobFinished(RenderJob *job)
 {
-	const QList<MBTile> &tiles = job->tiles();
+	const QList<MBTile> &tiles = static_cast<MBTilesMapJob*>(job)->tiles();
 
 	for (int i = 0; i < tiles.size(); i++) {
 		const MBTile &mt = tiles.at(i);
@@ -371,17 +349,11 @@ void MBTilesMap::jobFinished(MBTilesMapJob *job)
 			QPixmapCache::insert(mt.key(), mt.pixmap());
 	}
 
-	removeJob(job);
+	_jobs.remove(job);
 
 	emit tilesLoaded();
 }
 
-void MBTilesMap::cancelJobs(bool wait)
-{
-	for (int i = 0; i < _jobs.size(); i++)
-		_jobs.at(i)->cancel(wait);
-}
-
 QPointF MBTilesMap::tilePos(const QPointF &tl, const QPoint &tc,
   const QPoint &tile, unsigned overzoom) const
 {
@@ -412,12 +384,13 @@ void MBTilesMap::draw(QPainter *painter, const QRectF &rect, Flags flags)
 			QString key = path() + "-" + QString::number(zoom.z) + "_"
 			  + QString::number(t.x()) + "_" + QString::number(t.y());
 
-			if (isRunning(key))
+			if (_jobs.isRunning(key))
 				continue;
 
 			if (QPixmapCache::find(key, &pm)) {
 				QPointF tp(tilePos(tl, t, tile, overzoom));
 				drawTile(painter, pm, tp);
+				TRACE_COUNT("tiles cached", 1);
 			} else
 				tiles.append(MBTile(zoom.z, overzoom, _scaledSize, t,
 				  tileData(zoom.base, t), key));
@@ -441,7 +414,7 @@ void MBTilesMap::draw(QPainter *painter, const QRectF &rect, Flags flags)
 				drawTile(painter, pm, tp);
 			}
 		} else
-			runJob(new MBTilesMapJob(tiles));
+			runJob(new MBTilesMapJob(tiles, _zi));
 	}
 }
 
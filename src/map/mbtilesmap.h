@@ -8,7 +8,9 @@
 #include <QBuffer>
 #include <QPixmap>
 #include <QtConcurrent>
+#include "common/trace.h"
 #include "map.h"
+#include "renderjob.h"
 
 class MBTile
 {
@@ -23,6 +25,7 @@ public:
 	const QPixmap &pixmap() const {return _pixmap;}
 
 	void load() {
+		TRACE_SCOPE("MBTile::load");
 		QByteArray format(_overzoom
 		  ? QByteArray::number(_zoom) + ';' + QByteArray::number(_overzoom)
 		  : QByteArray::number(_zoom));
@@ -31,6 +34,8 @@ public:
 		if (_scaledSize)
 			reader.setScaledSize(QSize(_scaledSize, _scaledSize));
 		_pixmap = QPixmap::fromImage(reader.read());
+		TRACE_COUNT("tiles rendered", 1);
+		TRACE_COUNT("bytes decoded", _data.size());
 	}
 
 private:
@@ -43,39 +48,7 @@ private:
 	QPixmap _pixmap;
 };
 
-class MBTilesMapJob : public QObject
-{
-	Q_OBJECT
-
-public:
-	MBTilesMapJob(const QList<MBTile> &tiles) : _tiles(tiles) {}
-
-	void run()
-	{
-		connect(&_watcher, &QFutureWatcher<void>::finished, this,
-		  &MBTilesMapJob::handleFinished);
-		_future = QtConcurrent::map(_tiles, &MBTile::load);
-		_watcher.setFuture(_future);
-	}
-	void cancel(bool wait)
-	{
-		_future.cancel();
-		if (wait)
-			_future.waitForFinished();
-	}
-	const QList<MBTile> &tiles() const {return _tiles;}
-
-signals:
-	void finished(MBTilesMapJob *job);
-
-private slots:
-	void handleFinished() {emit finished(this);}
-
-private:
-	QFutureWatcher<void> _watcher;
-	QFuture<void> _future;
-	QList<MBTile> _tiles;
-};
+typedef TileJob<MBTile, &MBTile::load> MBTilesMapJob;
 
 class MBTilesMap : public Map
 {
@@ -111,7 +84,7 @@ public:
 	static Map *create(const QString &path, const Projection &proj, bool *isDir);
 
 private slots:
-	void jobFinished(MBTilesMapJob *job);
+	void jobFinished(RenderJob *job);
 
 private:
 	struct Zoom {
@@ -135,10 +108,7 @@ private:
 	qreal imageRatio() const;
 	QByteArray tileData(int zoom, const QPoint &tile) const;
 	void drawTile(QPainter *painter, QPixmap &pixmap, QPointF &tp);
-	bool isRunning(const QString &key) const;
 	void runJob(MBTilesMapJob *job);
-	void removeJob(MBTilesMapJob *job);
-	void cancelJobs(bool wait);
 	QPointF tilePos(const QPointF &tl, const QPoint &tc, const QPoint &tile,
 	  unsigned overzoom) const;
 
@@ -155,7 +125,7 @@ private:
 	bool _scalable;
 	int _scaledSize;
 
-	QList<MBTilesMapJob*> _jobs;
+	RenderQueue _jobs;
 
 	bool _valid;
 	QString _errorString;
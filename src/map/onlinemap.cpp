@@ -3,12 +3,50 @@
 #include <QPixmapCache>
 #include "common/rectc.h"
 #include "common/programpaths.h"
+#include "common/trace.h"
 #include "downloader.h"
+#include "tileseeder.h"
 #include "osm.h"
 #include "onlinemap.h"
 
 
 #define MAX_TILE_SIZE 4096
+#define MAX_LAT 85.0511
+/* Max zoom levels distance of the parent tiles used as placeholders */
+#define MAX_PLACEHOLDER_LEVELS 4
+
+class OnlineMap::Seeder : public TileSeeder
+{
+public:
+	Seeder(OnlineMap *map, const QList<RectC> &area, const Range &zooms)
+	  : TileSeeder(map->_tileLoader, area, zooms, map), _map(map) {}
+
+protected:
+	QRect tiles(const RectC &rect, int zoom) const
+	{
+		RectC r(rect & _map->_bounds);
+		if (!r.isValid())
+			return QRect();
+
+		QPoint tl(OSM::ll2tile(Coordinates(r.left(), qMin(r.top(), MAX_LAT)),
+		  zoom));
+		QPoint br(OSM::ll2tile(Coordinates(r.right(), qMax(r.bottom(),
+		  -MAX_LAT)), zoom));
+
+		int max = (1<<zoom) - 1;
+
+		return QRect(QPoint(qMax(tl.x(), 0), qMax(tl.y(), 0)),
+		  QPoint(qMin(br.x(), max), qMin(br.y(), max)));
+	}
+	TileLoader::Tile tile(const QPoint &xy, int zoom) const
+	{
+		return TileLoader::Tile(_map->tileCoordinates(xy.x(), xy.y(), zoom),
+		  zoom);
+	}
+
+private:
+	const OnlineMap *_map;
+};
 
 OnlineMap::OnlineMap(const QString &fileName, const QString &name,
   const QString &url, const Range &zooms, const RectC &bounds, qreal tileRatio,
@@ -63,17 +101,15 @@ qreal OnlineMap::resolution(const QRectF &rect)
 
 int OnlineMap::zoomIn()
 {
-	cancelJobs(false);
-
 	_zoom = qMin(_zoom + 1, _zooms.max());
+	_jobs.cancelStale(_zoom);
 	return _zoom;
 }
 
 int OnlineMap::zoomOut()
 {
-	cancelJobs(false);
-
 	_zoom = qMax(_zoom - 1, _zooms.min());
+	_jobs.cancelStale(_zoom);
 	return _zoom;
 }
 
@@ -100,7 +136,7 @@ void OnlineMap::load(const Projection &in, const Projection &out,
 
 void OnlineMap::unload()
 {
-	cancelJobs(true);
+	_jobs.cancel(true);
 }
 
 qreal OnlineMap::coordinatesRatio() const
@@ -130,35 +166,15 @@ QPointF OnlineMap::tilePos(const QPointF &tl, const QPoint &tc,
 	  tl.y() + ((tc.y() - tile.y()) << overzoom) * tileSize());
 }
 
-bool OnlineMap::isRunning(const QString &key) const
-{
-	for (int i = 0; i < _jobs.size(); i++) {
-		const QList<OnlineMapTile> &tiles = _jobs.at(i)->tiles();
-		for (int j = 0; j < tiles.size(); j++)
-			if (tiles.at(j).key() == key)
-				return true;
-	}
-
-	return false;
-}
-
 void OnlineMap::runJob(OnlineMapJob *job)
 {
-	_jobs.append(job);
-
-	connect(job, &OnlineMapJob::finished, this, &OnlineMap::jobFinished);
-	job->run();
-}
-
-void OnlineMap::removeJob(OnlineMapJob *job)
-{
-	_jobs.removeOne(job);
-	job->deleteLater();
+	connect(job, &RenderJob::finished, this, &OnlineMap::jobFinished);
+	_jobs.run(job);
 }
 
-void OnlineMap::jobFinished(OnlineMapJob *job)
+void OnlineMap::jobFinished(RenderJob *job)
 {
-	const QList<OnlineMapTile> &tiles = job->tiles();
+	const QList<OnlineMapTile> &tiles = static_cast<OnlineMapJob*>(job)->tiles();
 
 	for (int i = 0; i < tiles.size(); i++) {
 		const OnlineMapTile &mt = tiles.at(i);
@@ -166,17 +182,11 @@ void OnlineMap::jobFinished(OnlineMapJob *job)
 			QPixmapCache::insert(mt.key(), mt.pixmap());
 	}
 
-	removeJob(job);
+	_jobs.remove(job);
 
 	emit tilesLoaded();
 }
 
-void OnlineMap::cancelJobs(bool wait)
-{
-	for (int i = 0; i < _jobs.size(); i++)
-		_jobs.at(i)->cancel(wait);
-}
-
 void OnlineMap::draw(QPainter *painter, const QRectF &rect, Flags flags)
 {
 	int baseZoom = qMin(_baseZoom, _zoom);
@@ -201,6 +211,7 @@ void OnlineMap::draw(QPainter *painter, const QRectF &rect, Flags flags)
 		}
 	}
 
+	TRACE_COUNT("tiles requested", fetchTiles.size());
 	if (flags & Map::Block)
 		_tileLoader->loadTilesSync(fetchTiles);
 	else
@@ -209,22 +220,34 @@ void OnlineMap::draw(QPainter *painter, const QRectF &rect, Flags flags)
 	QList<OnlineMapTile> renderTiles;
 	for (int i = 0; i < fetchTiles.count(); i++) {
 		const TileLoader::Tile &t = fetchTiles.at(i);
-		if (t.file().isNull())
+		QPoint tc(tileCoordinates(t.xy().x(), t.xy().y(), baseZoom));
+		QPointF tp(tilePos(tl, tc, tile, overzoom));
+		QRectF tr(tp, QSizeF(tileSize() * f, tileSize() * f));
+		bool async = !(flags & Map::Block || !_scalable);
+
+		if (t.file().isNull()) {
+			if (!(flags & Map::Block))
+				drawPlaceholder(painter, tc, baseZoom, tr);
 			continue;
+		}
 
 		QString key(overzoom
 		  ? t.file() + ":" + QString::number(overzoom) : t.file());
-		if (isRunning(key))
+		if (_jobs.isRunning(key)) {
+			drawPlaceholder(painter, tc, baseZoom, tr);
 			continue;
+		}
 
 		QPixmap pm;
 		if (QPixmapCache::find(key, &pm)) {
-			QPoint tc(tileCoordinates(t.xy().x(), t.xy().y(), baseZoom));
-			QPointF tp(tilePos(tl, tc, tile, overzoom));
 			drawTile(painter, pm, tp);
-		} else
-			renderTiles.append(OnlineMapTile(t.xy(), t.file(), _zoom, overzoom,
-			  _scaledSize, key));
+			TRACE_COUNT("tiles cached", 1);
+		} else {
+			renderTiles.append(OnlineMapTile(t, _zoom, overzoom, _scaledSize,
+			  key));
+			if (async)
+				drawPlaceholder(painter, tc, baseZoom, tr);
+		}
 	}
 
 	if (!renderTiles.isEmpty()) {
@@ -246,7 +269,7 @@ void OnlineMap::draw(QPainter *painter, const QRectF &rect, Flags flags)
 				drawTile(painter, pm, tp);
 			}
 		} else
-			runJob(new OnlineMapJob(renderTiles));
+			runJob(new OnlineMapJob(renderTiles, _zoom));
 	}
 }
 
@@ -256,6 +279,71 @@ void OnlineMap::drawTile(QPainter *painter, QPixmap &pixmap, QPointF &tp)
 	painter->drawPixmap(tp, pixmap);
 }
 
+QString OnlineMap::tileKey(const QPoint &tc, int zoom, unsigned overzoom) const
+{
+	QPoint xy(tileCoordinates(tc.x(), tc.y(), zoom));
+	QString file(_tileLoader->tileKey(TileLoader::Tile(xy, zoom)));
+
+	return overzoom ? file + ":" + QString::number(overzoom) : file;
+}
+
+/* Draws the cached tiles of (display) zoom level zoom in place of the base
+   zoom tile tc. Tiles of lower zoom levels are single parent tiles cropped
+   to the tile area, tiles of higher zoom levels are its children. */
+bool OnlineMap::drawPlaceholder(QPainter *painter, const QPoint &tc,
+  int baseZoom, int zoom, const QRectF &rect) const
+{
+	int pz = qMin(zoom, _baseZoom);
+	unsigned overzoom = zoom - pz;
+	QPixmap pm;
+
+	if (pz <= baseZoom) {
+		int s = baseZoom - pz;
+		QPoint pc(tc.x() >> s, tc.y() >> s);
+		if (!QPixmapCache::find(tileKey(pc, pz, overzoom), &pm))
+			return false;
+
+		qreal n = 1<<s;
+		QSizeF ps(pm.width() / n, pm.height() / n);
+		painter->drawPixmap(rect, pm, QRectF(QPointF((tc.x() - (pc.x() << s))
+		  * ps.width(), (tc.y() - (pc.y() << s)) * ps.height()), ps));
+
+		return true;
+	} else {
+		int s = pz - baseZoom;
+		int n = 1<<s;
+		QSizeF cs(rect.width() / n, rect.height() / n);
+		bool found = false;
+
+		for (int i = 0; i < n; i++) {
+			for (int j = 0; j < n; j++) {
+				QPoint cc((tc.x() << s) + i, (tc.y() << s) + j);
+				if (QPixmapCache::find(tileKey(cc, pz, overzoom), &pm)) {
+					painter->drawPixmap(QRectF(rect.topLeft() + QPointF(i
+					  * cs.width(), j * cs.height()), cs), pm, pm.rect());
+					found = true;
+				}
+			}
+		}
+
+		return found;
+	}
+}
+
+/* Tiles that are not yet available are replaced with scaled cached tiles of
+   the nearest lower zoom levels or the next higher zoom level. */
+void OnlineMap::drawPlaceholder(QPainter *painter, const QPoint &tc,
+  int baseZoom, const QRectF &rect) const
+{
+	for (int z = _zoom - 1; z >= qMax(_zooms.min(),
+	  _zoom - MAX_PLACEHOLDER_LEVELS); z--)
+		if (drawPlaceholder(painter, tc, baseZoom, z, rect))
+			return;
+
+	if (_zoom < _zooms.max())
+		drawPlaceholder(painter, tc, baseZoom, _zoom + 1, rect);
+}
+
 QPointF OnlineMap::ll2xy(const Coordinates &c)
 {
 	qreal scale = OSM::zoom2scale(_zoom, _tileSize);
@@ -270,6 +358,11 @@ Coordinates OnlineMap::xy2ll(const QPointF &p)
 	  * coordinatesRatio());
 }
 
+TileSeeder *OnlineMap::seeder(const QList<RectC> &area, const Range &zooms)
+{
+	return new Seeder(this, area, zooms);
+}
+
 void OnlineMap::clearCache()
 {
 	_tileLoader->clearCache();
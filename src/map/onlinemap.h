@@ -2,29 +2,47 @@
 #define ONLINEMAP_H
 
 #include <QImageReader>
+#include <QBuffer>
 #include <QPixmap>
 #include <QtConcurrent>
 #include "common/range.h"
 #include "common/rectc.h"
+#include "common/trace.h"
 #include "map.h"
+#include "renderjob.h"
 #include "tileloader.h"
 
 class OnlineMapTile
 {
 public:
-	OnlineMapTile(const QPoint &xy, const QString &file, int zoom, int overzoom,
-	  int scaledSize, const QString &key) : _zoom(zoom), _overzoom(overzoom),
-	  _scaledSize(scaledSize), _xy(xy), _file(file), _key(key) {}
+	OnlineMapTile(const TileLoader::Tile &tile, int zoom, int overzoom,
+	  int scaledSize, const QString &key)
+	  : _zoom(zoom), _overzoom(overzoom), _scaledSize(scaledSize),
+	  _xy(tile.xy()), _file(tile.file()), _store(tile.store()),
+	  _storeZoom(tile.zoom().toString()), _key(key) {}
 
 	void load()
 	{
+		TRACE_SCOPE("OnlineMapTile::load");
 		QByteArray format(_overzoom
 		  ? QByteArray::number(_zoom) + ';' + QByteArray::number(_overzoom)
 		  : QByteArray::number(_zoom));
-		QImageReader reader(_file, format);
+		QByteArray data;
+		QBuffer buffer(&data);
+		QImageReader reader;
+		if (_store.isNull())
+			reader.setFileName(_file);
+		else {
+			data = TileStore::read(_store, _storeZoom, _xy);
+			reader.setDevice(&buffer);
+		}
+		reader.setFormat(format);
 		if (_scaledSize)
 			reader.setScaledSize(QSize(_scaledSize, _scaledSize));
 		_pixmap = QPixmap::fromImage(reader.read());
+		TRACE_COUNT("tiles rendered", 1);
+		TRACE_COUNT("bytes decoded", reader.device()
+		  ? reader.device()->size() : 0);
 	}
 
 	const QPoint &xy() const {return _xy;}
@@ -37,43 +55,13 @@ private:
 	int _scaledSize;
 	QPoint _xy;
 	QString _file;
+	QString _store;
+	QString _storeZoom;
 	QString _key;
 	QPixmap _pixmap;
 };
 
-class OnlineMapJob : public QObject
-{
-	Q_OBJECT
-
-public:
-	OnlineMapJob(const QList<OnlineMapTile> &tiles) : _tiles(tiles) {}
-
-	void run()
-	{
-		connect(&_watcher, &QFutureWatcher<void>::finished, this,
-		  &OnlineMapJob::handleFinished);
-		_future = QtConcurrent::map(_tiles, &OnlineMapTile::load);
-		_watcher.setFuture(_future);
-	}
-	void cancel(bool wait)
-	{
-		_future.cancel();
-		if (wait)
-			_future.waitForFinished();
-	}
-	const QList<OnlineMapTile> &tiles() const {return _tiles;}
-
-signals:
-	void finished(OnlineMapJob *job);
-
-private slots:
-	void handleFinished() {emit finished(this);}
-
-private:
-	QFutureWatcher<void> _watcher;
-	QFuture<void> _future;
-	QList<OnlineMapTile> _tiles;
-};
+typedef TileJob<OnlineMapTile, &OnlineMapTile::load> OnlineMapJob;
 
 class OnlineMap : public Map
 {
@@ -107,10 +95,16 @@ public:
 	void unload();
 	void clearCache();
 
+	bool canSeed() const {return true;}
+	Range seedZooms() const {return _zooms;}
+	TileSeeder *seeder(const QList<RectC> &area, const Range &zooms);
+
 private slots:
-	void jobFinished(OnlineMapJob *job);
+	void jobFinished(RenderJob *job);
 
 private:
+	class Seeder;
+
 	int limitZoom(int zoom) const;
 	qreal tileSize() const;
 	qreal coordinatesRatio() const;
@@ -119,10 +113,12 @@ private:
 	QPointF tilePos(const QPointF &tl, const QPoint &tc, const QPoint &tile,
 	  unsigned overzoom) const;
 	void drawTile(QPainter *painter, QPixmap &pixmap, QPointF &tp);
-	bool isRunning(const QString &key) const;
+	QString tileKey(const QPoint &tc, int zoom, unsigned overzoom) const;
+	bool drawPlaceholder(QPainter *painter, const QPoint &tc, int baseZoom,
+	  int zoom, const QRectF &rect) const;
+	void drawPlaceholder(QPainter *painter, const QPoint &tc, int baseZoom,
+	  const QRectF &rect) const;
 	void runJob(OnlineMapJob *job);
-	void removeJob(OnlineMapJob *job);
-	void cancelJobs(bool wait);
 
 	TileLoader *_tileLoader;
 	QString _name;
@@ -136,7 +132,7 @@ private:
 	int _scaledSize;
 	bool _invertY;
 
-	QList<OnlineMapJob*> _jobs;
+	RenderQueue _jobs;
 };
 
 #endif // ONLINEMAP_H
@@ -0,0 +1,78 @@
+#include <cmath>
+#include "prefetch.h"
+
+/* The prefetched tiles are tracked only to count their usage, the set is
+   reset when it grows too big as most of the tiles are long gone from the
+   pixmap cache then anyway */
+#define MAX_KEYS 4096
+
+int Prefetch::_ring = 1;
+QSet<QString> Prefetch::_keys;
+qint64 Prefetch::_rendered = 0;
+qint64 Prefetch::_used = 0;
+
+static QRect tileRange(const QRectF &rect, int tileSize)
+{
+	return QRect(QPoint((int)floor(rect.left() / tileSize),
+	  (int)floor(rect.top() / tileSize)), QPoint((int)ceil(rect.right()
+	  / tileSize) - 1, (int)ceil(rect.bottom() / tileSize) - 1));
+}
+
+QList<QPoint> Prefetch::ringTiles(const QRectF &rect, const QRectF &bounds,
+  int tileSize)
+{
+	QList<QPoint> list;
+	QRectF vr(rect & bounds);
+
+	if (!_ring || vr.isEmpty())
+		return list;
+
+	QRect inner(tileRange(vr, tileSize));
+	QRect outer(tileRange(vr.adjusted(-_ring * tileSize, -_ring * tileSize,
+	  _ring * tileSize, _ring * tileSize) & bounds, tileSize));
+
+	for (int i = outer.left(); i <= outer.right(); i++)
+		for (int j = outer.top(); j <= outer.bottom(); j++)
+			if (!inner.contains(i, j))
+				list.append(QPoint(i * tileSize, j * tileSize));
+
+	return list;
+}
+
+QList<QPoint> Prefetch::zoomTiles(const QRectF &rect, const QRectF &bounds,
+  int tileSize)
+{
+	QList<QPoint> list;
+
+	if (!_ring)
+		return list;
+
+	QRectF zr(QPointF(0, 0), rect.size());
+	zr.moveCenter(rect.center() * 2);
+	QRectF zb(bounds.topLeft() * 2, bounds.size() * 2);
+	QRectF vr(zr & zb);
+	if (vr.isEmpty())
+		return list;
+
+	QRect range(tileRange(vr, tileSize));
+	for (int i = range.left(); i <= range.right(); i++)
+		for (int j = range.top(); j <= range.bottom(); j++)
+			list.append(QPoint(i * tileSize, j * tileSize));
+
+	return list;
+}
+
+void Prefetch::rendered(const QString &key)
+{
+	if (_keys.size() >= MAX_KEYS)
+		_keys.clear();
+
+	_keys.insert(key);
+	_rendered++;
+}
+
+void Prefetch::used(const QString &key)
+{
+	if (_keys.remove(key))
+		_used++;
+}
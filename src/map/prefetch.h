@@ -0,0 +1,41 @@
+#ifndef PREFETCH_H
+#define PREFETCH_H
+
+#include <QSet>
+#include <QList>
+#include <QString>
+#include <QRectF>
+#include <QPoint>
+
+/* Idle-time render-ahead of vector map tiles. When the map view is idle, the
+   maps render the tiles in a ring around the viewport and the tiles of the
+   next zoom level into the pixmap cache. All the functions must be called
+   from the GUI thread. */
+class Prefetch
+{
+public:
+	static void setRing(int ring) {_ring = ring;}
+	static int ring() {return _ring;}
+
+	/* Top-left corners of the tiles in the ring around rect, the tiles
+	   covering rect itself are not included */
+	static QList<QPoint> ringTiles(const QRectF &rect, const QRectF &bounds,
+	  int tileSize);
+	/* Top-left corners of the tiles covering rect at the next zoom level
+	   (rect and bounds are given in the current zoom level coordinates) */
+	static QList<QPoint> zoomTiles(const QRectF &rect, const QRectF &bounds,
+	  int tileSize);
+
+	static void rendered(const QString &key);
+	static void used(const QString &key);
+
+	static qint64 renderedCount() {return _rendered;}
+	static qint64 usedCount() {return _used;}
+
+private:
+	static int _ring;
+	static QSet<QString> _keys;
+	static qint64 _rendered, _used;
+};
+
+#endif // PREFETCH_H
@@ -63,28 +63,33 @@ LambertConic1::LambertConic1(const Ellipsoid &ellipsoid, double latitudeOrigin,
 
 
 	lat_orig = deg2rad(latitudeOrigin);
-	_longitudeOrigin = deg2rad(longitudeOrigin);
-	if (_longitudeOrigin > M_PI)
-		_longitudeOrigin -= 2 * M_PI;
+	_k.longitudeOrigin = deg2rad(longitudeOrigin);
+	if (_k.longitudeOrigin > M_PI)
+		_k.longitudeOrigin -= 2 * M_PI;
 
-	_falseEasting = falseEasting;
-	_falseNorthing = falseNorthing;
+	_k.falseEasting = falseEasting;
+	_k.falseNorthing = falseNorthing;
 
-	_e = sqrt(ellipsoid.es());
-	_e_over_2 = _e / 2.0;
+	_k.e = sqrt(ellipsoid.es());
+	_k.e_over_2 = _k.e / 2.0;
 
-	_n = sin(lat_orig);
+	_k.n = sin(lat_orig);
 
-	e_sin = _e * sin(lat_orig);
+	e_sin = _k.e * sin(lat_orig);
 	m0 = LAMBERT_m(cos(lat_orig), e_sin);
-	_t0 = LAMBERT1_t(lat_orig, e_sin, _e_over_2);
+	_k.t0 = LAMBERT1_t(lat_orig, e_sin, _k.e_over_2);
 
-	_rho0 = ellipsoid.radius() * scale * m0 / _n;
+	_k.rho0 = ellipsoid.radius() * scale * m0 / _k.n;
 
-	_rho_olat = _rho0;
+	_k.rho_olat = _k.rho0;
+
+	_k.one_over_n = 1.0 / _k.n;
+	_k.one_over_t0 = 1.0 / _k.t0;
+	_k.one_over_rho0 = 1.0 / _k.rho0;
 }
 
-PointD LambertConic1::ll2xy(const Coordinates &c) const
+inline PointD LambertConic1::forward(const Constants &k,
+  const Coordinates &c)
 {
 	double t;
 	double rho;
@@ -94,25 +99,26 @@ PointD LambertConic1::ll2xy(const Coordinates &c) const
 
 
 	if (fabs(fabs(lat) - M_PI_2) > 1.0e-10) {
-		t = LAMBERT1_t(lat, _e * sin(lat), _e_over_2);
-		rho = _rho0 * pow(t / _t0, _n);
+		t = LAMBERT1_t(lat, k.e * sin(lat), k.e_over_2);
+		rho = k.rho0 * pow(t * k.one_over_t0, k.n);
 	} else
 		rho = 0.0;
 
-	dlam = deg2rad(c.lon()) - _longitudeOrigin;
+	dlam = deg2rad(c.lon()) - k.longitudeOrigin;
 
 	if (dlam > M_PI)
 		dlam -= 2 * M_PI;
 	if (dlam < -M_PI)
 		dlam += 2 * M_PI;
 
-	theta = _n * dlam;
+	theta = k.n * dlam;
 
-	return PointD(rho * sin(theta) + _falseEasting, _rho_olat - rho
-	  * cos(theta) + _falseNorthing);
+	return PointD(rho * sin(theta) + k.falseEasting, k.rho_olat - rho
+	  * cos(theta) + k.falseNorthing);
 }
 
-Coordinates LambertConic1::xy2ll(const PointD &p) const
+inline Coordinates LambertConic1::inverse(const Constants &k,
+  const PointD &p)
 {
 	double dx;
 	double dy;
@@ -128,26 +134,26 @@ Coordinates LambertConic1::xy2ll(const PointD &p) const
 	double lat, lon;
 
 
-	dy = p.y() - _falseNorthing;
-	dx = p.x() - _falseEasting;
-	rho_olat_minus_dy = _rho_olat - dy;
+	dy = p.y() - k.falseNorthing;
+	dx = p.x() - k.falseEasting;
+	rho_olat_minus_dy = k.rho_olat - dy;
 	rho = sqrt(dx * dx + (rho_olat_minus_dy) * (rho_olat_minus_dy));
 
-	if (_n < 0.0) {
+	if (k.n < 0.0) {
 		rho *= -1.0;
 		dx *= -1.0;
 		rho_olat_minus_dy *= -1.0;
 	}
 
 	if (rho != 0.0) {
-		theta = atan2(dx, rho_olat_minus_dy) / _n;
-		t = _t0 * pow(rho / _rho0, 1 / _n);
+		theta = atan2(dx, rho_olat_minus_dy) * k.one_over_n;
+		t = k.t0 * pow(rho * k.one_over_rho0, k.one_over_n);
 		PHI = M_PI_2 - 2.0 * atan(t);
 		while (fabs(PHI - tempPHI) > tolerance && count) {
 			tempPHI = PHI;
-			es_sin = _e * sin(PHI);
+			es_sin = k.e * sin(PHI);
 			PHI = M_PI_2 - 2.0 * atan(t * pow((1.0 - es_sin) / (1.0 + es_sin),
-			  _e_over_2));
+			  k.e_over_2));
 			count--;
 		}
 
@@ -155,7 +161,7 @@ Coordinates LambertConic1::xy2ll(const PointD &p) const
 			return Coordinates();
 
 		lat = PHI;
-		lon = theta + _longitudeOrigin;
+		lon = theta + k.longitudeOrigin;
 
 		if (fabs(lat) < 2.0e-7)
 			lat = 0.0;
@@ -184,23 +190,50 @@ Coordinates LambertConic1::xy2ll(const PointD &p) const
 		else if (lon < -M_PI)
 			lon = -M_PI;
 	} else {
-		if (_n > 0.0)
+		if (k.n > 0.0)
 			lat = M_PI_2;
 		else
 			lat = -M_PI_2;
-		lon = _longitudeOrigin;
+		lon = k.longitudeOrigin;
 	}
 
 	return Coordinates(rad2deg(lon), rad2deg(lat));
 }
 
+PointD LambertConic1::ll2xy(const Coordinates &c) const
+{
+	return forward(_k, c);
+}
+
+Coordinates LambertConic1::xy2ll(const PointD &p) const
+{
+	return inverse(_k, p);
+}
+
+/* See TransverseMercator::ll2xyArray() */
+void LambertConic1::ll2xyArray(const Coordinates *c, PointD *p, int n) const
+{
+	const Constants k(_k);
+
+	for (int i = 0; i < n; i++)
+		p[i] = forward(k, c[i]);
+}
+
+void LambertConic1::xy2llArray(const PointD *p, Coordinates *c, int n) const
+{
+	const Constants k(_k);
+
+	for (int i = 0; i < n; i++)
+		c[i] = inverse(k, p[i]);
+}
+
 bool LambertConic1::operator==(const CT &ct) const
 {
 	const LambertConic1 *other = dynamic_cast<const LambertConic1*>(&ct);
-	return (other != 0 && _longitudeOrigin == other->_longitudeOrigin
-	  && _falseEasting == other->_falseEasting
-	  && _falseNorthing == other->_falseNorthing && _e == other->_e
-	  && _n == other->_n && _rho0 == other->_rho0);
+	return (other != 0 && _k.longitudeOrigin == other->_k.longitudeOrigin
+	  && _k.falseEasting == other->_k.falseEasting
+	  && _k.falseNorthing == other->_k.falseNorthing && _k.e == other->_k.e
+	  && _k.n == other->_k.n && _k.rho0 == other->_k.rho0);
 }
 
 
@@ -19,17 +19,32 @@ public:
 	virtual PointD ll2xy(const Coordinates &c) const;
 	virtual Coordinates xy2ll(const PointD &p) const;
 
+protected:
+	virtual void ll2xyArray(const Coordinates *c, PointD *p, int n) const;
+	virtual void xy2llArray(const PointD *p, Coordinates *c, int n) const;
+
 private:
-	double _longitudeOrigin;
-	double _falseEasting;
-	double _falseNorthing;
-
-	double _e;
-	double _e_over_2;
-	double _n;
-	double _t0;
-	double _rho0;
-	double _rho_olat;
+	struct Constants {
+		double longitudeOrigin;
+		double falseEasting;
+		double falseNorthing;
+
+		double e;
+		double e_over_2;
+		double n;
+		double t0;
+		double rho0;
+		double rho_olat;
+
+		double one_over_n;
+		double one_over_t0;
+		double one_over_rho0;
+	};
+
+	static PointD forward(const Constants &k, const Coordinates &c);
+	static Coordinates inverse(const Constants &k, const PointD &p);
+
+	Constants _k;
 };
 
 class LambertConic2 : public CT
@@ -45,6 +60,12 @@ public:
 	virtual PointD ll2xy(const Coordinates &c) const;
 	virtual Coordinates xy2ll(const PointD &p) const;
 
+protected:
+	virtual void ll2xyArray(const Coordinates *c, PointD *p, int n) const
+	  {static_cast<const CT&>(_lc1).ll2xy(c, p, n);}
+	virtual void xy2llArray(const PointD *p, Coordinates *c, int n) const
+	  {static_cast<const CT&>(_lc1).xy2ll(p, c, n);}
+
 private:
 	LambertConic1 _lc1;
 };
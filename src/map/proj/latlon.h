@@ -21,6 +21,18 @@ public:
 	virtual Coordinates xy2ll(const PointD &p) const
 	  {return Coordinates(_au.toDegrees(p.x()), _au.toDegrees(p.y()));}
 
+protected:
+	virtual void ll2xyArray(const Coordinates *c, PointD *p, int n) const
+	{
+		for (int i = 0; i < n; i++)
+			p[i] = LatLon::ll2xy(c[i]);
+	}
+	virtual void xy2llArray(const PointD *p, Coordinates *c, int n) const
+	{
+		for (int i = 0; i < n; i++)
+			c[i] = LatLon::xy2ll(p[i]);
+	}
+
 private:
 	AngularUnits _au;
 };
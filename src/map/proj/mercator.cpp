@@ -53,29 +53,33 @@ Mercator::Mercator(const Ellipsoid &ellipsoid, double latitudeOrigin,
 	double es4;
 	double sin_olat;
 
-	_latitudeOrigin = deg2rad(latitudeOrigin);
-	_longitudeOrigin = deg2rad(longitudeOrigin);
-	if (_longitudeOrigin > M_PI)
-		_longitudeOrigin -= 2 * M_PI;
-	_falseNorthing = falseNorthing;
-	_falseEasting = falseEasting;
-
-	_a = ellipsoid.radius();
-	_e = sqrt(es);
-
-	sin_olat = sin(_latitudeOrigin);
-	_scaleFactor = 1.0 / (sqrt(1.e0 - es * sin_olat * sin_olat)
-	  / cos(_latitudeOrigin));
+	_k.latitudeOrigin = deg2rad(latitudeOrigin);
+	_k.longitudeOrigin = deg2rad(longitudeOrigin);
+	if (_k.longitudeOrigin > M_PI)
+		_k.longitudeOrigin -= 2 * M_PI;
+	_k.falseNorthing = falseNorthing;
+	_k.falseEasting = falseEasting;
+
+	_k.a = ellipsoid.radius();
+	_k.e = sqrt(es);
+
+	sin_olat = sin(_k.latitudeOrigin);
+	_k.scaleFactor = 1.0 / (sqrt(1.e0 - es * sin_olat * sin_olat)
+	  / cos(_k.latitudeOrigin));
 	es2 = es * es;
 	es3 = es2 * es;
 	es4 = es3 * es;
-	_ab = es / 2.e0 + 5.e0 * es2 / 24.e0 + es3 / 12.e0 + 13.e0 * es4 / 360.e0;
-	_bb = 7.e0 * es2 / 48.e0 + 29.e0 * es3 / 240.e0 + 811.e0 * es4 / 11520.e0;
-	_cb = 7.e0 * es3 / 120.e0 + 81.e0 * es4 / 1120.e0;
-	_db = 4279.e0 * es4 / 161280.e0;
+	_k.ab = es / 2.e0 + 5.e0 * es2 / 24.e0 + es3 / 12.e0 + 13.e0 * es4 / 360.e0;
+	_k.bb = 7.e0 * es2 / 48.e0 + 29.e0 * es3 / 240.e0 + 811.e0 * es4 / 11520.e0;
+	_k.cb = 7.e0 * es3 / 120.e0 + 81.e0 * es4 / 1120.e0;
+	_k.db = 4279.e0 * es4 / 161280.e0;
+
+	_k.e_over_2 = _k.e / 2.e0;
+	_k.ka = _k.scaleFactor * _k.a;
+	_k.one_over_ka = 1.e0 / _k.ka;
 }
 
-PointD Mercator::ll2xy(const Coordinates &c) const
+inline PointD Mercator::forward(const Constants &k, const Coordinates &c)
 {
 	double lon = deg2rad(c.lon());
 	double lat = deg2rad(c.lat());
@@ -87,33 +91,33 @@ PointD Mercator::ll2xy(const Coordinates &c) const
 
 	if (lon > M_PI)
 		lon -= 2 * M_PI;
-	e_x_sinlat = _e * sin(lat);
+	e_x_sinlat = k.e * sin(lat);
 	tan_temp = tan(M_PI_4 + lat / 2.e0);
-	pow_temp = pow((1.e0 - e_x_sinlat) / (1.e0 + e_x_sinlat), _e / 2.e0);
+	pow_temp = pow((1.e0 - e_x_sinlat) / (1.e0 + e_x_sinlat), k.e_over_2);
 	ctanz2 = tan_temp * pow_temp;
-	delta_lon = lon - _longitudeOrigin;
+	delta_lon = lon - k.longitudeOrigin;
 	if (delta_lon > M_PI)
 	  delta_lon -= 2 * M_PI;
 	if (delta_lon < -M_PI)
 	  delta_lon += 2 * M_PI;
 
-	return PointD(_scaleFactor * _a * delta_lon + _falseEasting,
-	  _scaleFactor * _a * log(ctanz2) + _falseNorthing);
+	return PointD(k.ka * delta_lon + k.falseEasting,
+	  k.ka * log(ctanz2) + k.falseNorthing);
 }
 
-Coordinates Mercator::xy2ll(const PointD &p) const
+inline Coordinates Mercator::inverse(const Constants &k, const PointD &p)
 {
 	double dx;
 	double dy;
 	double xphi;
 	double lat, lon;
 
-	dy = p.y() - _falseNorthing;
-	dx = p.x() - _falseEasting;
-	lon = _longitudeOrigin + dx / (_scaleFactor * _a);
-	xphi = M_PI_2 - 2.e0 * atan(1.e0 / exp(dy / (_scaleFactor * _a)));
-	lat = xphi + _ab * sin(2.e0 * xphi) + _bb * sin(4.e0 * xphi)
-	  + _cb * sin(6.e0 * xphi) + _db * sin(8.e0 * xphi);
+	dy = p.y() - k.falseNorthing;
+	dx = p.x() - k.falseEasting;
+	lon = k.longitudeOrigin + dx * k.one_over_ka;
+	xphi = M_PI_2 - 2.e0 * atan(exp(-dy * k.one_over_ka));
+	lat = xphi + k.ab * sin(2.e0 * xphi) + k.bb * sin(4.e0 * xphi)
+	  + k.cb * sin(6.e0 * xphi) + k.db * sin(8.e0 * xphi);
 	if (lon > M_PI)
 		lon -= 2 * M_PI;
 	if (lon < -M_PI)
@@ -122,12 +126,39 @@ Coordinates Mercator::xy2ll(const PointD &p) const
 	return Coordinates(rad2deg(lon), rad2deg(lat));
 }
 
+PointD Mercator::ll2xy(const Coordinates &c) const
+{
+	return forward(_k, c);
+}
+
+Coordinates Mercator::xy2ll(const PointD &p) const
+{
+	return inverse(_k, p);
+}
+
+/* See TransverseMercator::ll2xyArray() */
+void Mercator::ll2xyArray(const Coordinates *c, PointD *p, int n) const
+{
+	const Constants k(_k);
+
+	for (int i = 0; i < n; i++)
+		p[i] = forward(k, c[i]);
+}
+
+void Mercator::xy2llArray(const PointD *p, Coordinates *c, int n) const
+{
+	const Constants k(_k);
+
+	for (int i = 0; i < n; i++)
+		c[i] = inverse(k, p[i]);
+}
+
 bool Mercator::operator==(const CT &ct) const
 {
 	const Mercator *other = dynamic_cast<const Mercator*>(&ct);
-	return (other != 0 && _a == other->_a && _e == other->_e
-	  && _latitudeOrigin == other->_latitudeOrigin
-	  && _longitudeOrigin == other->_longitudeOrigin
-	  && _falseNorthing == other->_falseNorthing
-	  && _falseEasting == other->_falseEasting);
+	return (other != 0 && _k.a == other->_k.a && _k.e == other->_k.e
+	  && _k.latitudeOrigin == other->_k.latitudeOrigin
+	  && _k.longitudeOrigin == other->_k.longitudeOrigin
+	  && _k.falseNorthing == other->_k.falseNorthing
+	  && _k.falseEasting == other->_k.falseEasting);
 }
@@ -17,14 +17,28 @@ public:
 	virtual PointD ll2xy(const Coordinates &c) const;
 	virtual Coordinates xy2ll(const PointD &p) const;
 
+protected:
+	virtual void ll2xyArray(const Coordinates *c, PointD *p, int n) const;
+	virtual void xy2llArray(const PointD *p, Coordinates *c, int n) const;
+
 private:
-	double _a, _e;
-	double _latitudeOrigin;
-	double _longitudeOrigin;
-	double _falseNorthing;
-	double _falseEasting;
-	double _scaleFactor;
-	double _ab, _bb, _cb, _db;
+	struct Constants {
+		double a, e;
+		double latitudeOrigin;
+		double longitudeOrigin;
+		double falseNorthing;
+		double falseEasting;
+		double scaleFactor;
+		double ab, bb, cb, db;
+
+		double e_over_2;
+		double ka, one_over_ka;
+	};
+
+	static PointD forward(const Constants &k, const Coordinates &c);
+	static Coordinates inverse(const Constants &k, const PointD &p);
+
+	Constants _k;
 };
 
 #endif // MERCATOR_H
@@ -46,15 +46,15 @@ Defense.
 #include "transversemercator.h"
 
 
-#define SPHSN(lat) \
-	((double)(_a / sqrt(1.e0 - _es * pow(sin(lat), 2))))
-#define SPHTMD(lat) \
-	((double)(_ap * lat - _bp * sin(2.e0 * lat) + _cp * sin(4.e0 * lat) \
-	  - _dp * sin(6.e0 * lat) + _ep * sin(8.e0 * lat)))
-#define DENOM(lat) \
-	((double)(sqrt(1.e0 - _es * pow(sin(lat),2))))
-#define SPHSR(lat) \
-	((double)(_a * (1.e0 - _es) / pow(DENOM(lat), 3)))
+#define SPHSN(k, lat) \
+	((double)(k.a / sqrt(1.e0 - k.es * pow(sin(lat), 2))))
+#define SPHTMD(k, lat) \
+	((double)(k.ap * lat - k.bp * sin(2.e0 * lat) + k.cp * sin(4.e0 * lat) \
+	  - k.dp * sin(6.e0 * lat) + k.ep * sin(8.e0 * lat)))
+#define DENOM(k, lat) \
+	((double)(sqrt(1.e0 - k.es * pow(sin(lat),2))))
+#define SPHSR(k, lat) \
+	((double)(k.a * (1.e0 - k.es) / pow(DENOM(k, lat), 3)))
 
 
 TransverseMercator::TransverseMercator(const Ellipsoid &ellipsoid,
@@ -65,46 +65,58 @@ TransverseMercator::TransverseMercator(const Ellipsoid &ellipsoid,
 	double b;
 
 
-	_a = ellipsoid.radius();
-	_longitudeOrigin = deg2rad(longitudeOrigin);
-	_latitudeOrigin = deg2rad(latitudeOrigin);
-	_scale = scale;
-	_falseEasting = falseEasting;
-	_falseNorthing = falseNorthing;
+	_k.a = ellipsoid.radius();
+	_k.longitudeOrigin = deg2rad(longitudeOrigin);
+	_k.latitudeOrigin = deg2rad(latitudeOrigin);
+	_k.scale = scale;
+	_k.falseEasting = falseEasting;
+	_k.falseNorthing = falseNorthing;
 
-	_es = ellipsoid.es();
-	_ebs = (1 / (1 - _es)) - 1;
+	_k.es = ellipsoid.es();
+	_k.ebs = (1 / (1 - _k.es)) - 1;
 	b = ellipsoid.b();
 
-	tn = (_a - b) / (_a + b);
+	tn = (_k.a - b) / (_k.a + b);
 	tn2 = tn * tn;
 	tn3 = tn2 * tn;
 	tn4 = tn3 * tn;
 	tn5 = tn4 * tn;
 
-	_ap = _a * (1.e0 - tn + 5.e0 * (tn2 - tn3) / 4.e0 + 81.e0
+	_k.ap = _k.a * (1.e0 - tn + 5.e0 * (tn2 - tn3) / 4.e0 + 81.e0
 	  * (tn4 - tn5) / 64.e0);
-	_bp = 3.e0 * _a * (tn - tn2 + 7.e0 * (tn3 - tn4) / 8.e0 + 55.e0
+	_k.bp = 3.e0 * _k.a * (tn - tn2 + 7.e0 * (tn3 - tn4) / 8.e0 + 55.e0
 	  * tn5 / 64.e0 ) / 2.e0;
-	_cp = 15.e0 * _a * (tn2 - tn3 + 3.e0 * (tn4 - tn5 ) / 4.e0) / 16.0;
-	_dp = 35.e0 * _a * (tn3 - tn4 + 11.e0 * tn5 / 16.e0) / 48.e0;
-	_ep = 315.e0 * _a * (tn4 - tn5) / 512.e0;
+	_k.cp = 15.e0 * _k.a * (tn2 - tn3 + 3.e0 * (tn4 - tn5 ) / 4.e0) / 16.0;
+	_k.dp = 35.e0 * _k.a * (tn3 - tn4 + 11.e0 * tn5 / 16.e0) / 48.e0;
+	_k.ep = 315.e0 * _k.a * (tn4 - tn5) / 512.e0;
+
+	_k.tmdo = SPHTMD(_k, _k.latitudeOrigin);
+
+	_k.invScale = 1.e0 / scale;
+	_k.scale2 = scale * scale;
+	_k.scale3 = _k.scale2 * scale;
+	_k.scale4 = _k.scale3 * scale;
+	_k.scale5 = _k.scale4 * scale;
+	_k.scale6 = _k.scale5 * scale;
+	_k.scale7 = _k.scale6 * scale;
+	_k.scale8 = _k.scale7 * scale;
 }
 
-PointD TransverseMercator::ll2xy(const Coordinates &c) const
+inline PointD TransverseMercator::forward(const Constants &k,
+  const Coordinates &c)
 {
 	double rl;
 	double cl, c2, c3, c5, c7;
-	double dlam;
+	double dlam, dlam2;
 	double eta, eta2, eta3, eta4;
 	double sl, sn;
 	double t, tan2, tan3, tan4, tan5, tan6;
 	double t1, t2, t3, t4, t5, t6, t7, t8, t9;
-	double tmd, tmdo;
+	double tmd;
 	double x, y;
 
 
-	dlam = deg2rad(c.lon()) - _longitudeOrigin;
+	dlam = deg2rad(c.lon()) - k.longitudeOrigin;
 
 	if (dlam > M_PI)
 		dlam -= 2 * M_PI;
@@ -112,6 +124,7 @@ PointD TransverseMercator::ll2xy(const Coordinates &c) const
 		dlam += 2 * M_PI;
 	if (fabs(dlam) < 2.e-10)
 		dlam = 0.0;
+	dlam2 = dlam * dlam;
 
 	rl = deg2rad(c.lat());
 	sl = sin(rl);
@@ -126,111 +139,114 @@ PointD TransverseMercator::ll2xy(const Coordinates &c) const
 	tan4 = tan3 * t;
 	tan5 = tan4 * t;
 	tan6 = tan5 * t;
-	eta = _ebs * c2;
+	eta = k.ebs * c2;
 	eta2 = eta * eta;
 	eta3 = eta2 * eta;
 	eta4 = eta3 * eta;
 
-	sn = SPHSN(rl);
-	tmd = SPHTMD(rl);
-	tmdo = SPHTMD (_latitudeOrigin);
+	sn = SPHSN(k, rl);
+	tmd = SPHTMD(k, rl);
 
 
-	t1 = (tmd - tmdo) * _scale;
-	t2 = sn * sl * cl * _scale / 2.e0;
-	t3 = sn * sl * c3 * _scale * (5.e0 - tan2 + 9.e0 * eta + 4.e0 * eta2)
-	  / 24.e0;
-	t4 = sn * sl * c5 * _scale * (61.e0 - 58.e0 * tan2 + tan4 + 270.e0 * eta
+	t1 = (tmd - k.tmdo) * k.scale;
+	t2 = sn * sl * cl * k.scale * (1.e0 / 2.e0);
+	t3 = sn * sl * c3 * k.scale * (5.e0 - tan2 + 9.e0 * eta + 4.e0 * eta2)
+	  * (1.e0 / 24.e0);
+	t4 = sn * sl * c5 * k.scale * (61.e0 - 58.e0 * tan2 + tan4 + 270.e0 * eta
 	  - 330.e0 * tan2 * eta + 445.e0 * eta2 + 324.e0 * eta3 - 680.e0 * tan2
 	  * eta2 + 88.e0 * eta4 - 600.e0 * tan2 * eta3 - 192.e0 * tan2 * eta4)
-	  / 720.e0;
-	t5 = sn * sl * c7 * _scale * (1385.e0 - 3111.e0 * tan2 + 543.e0 * tan4
-	  - tan6) / 40320.e0;
+	  * (1.e0 / 720.e0);
+	t5 = sn * sl * c7 * k.scale * (1385.e0 - 3111.e0 * tan2 + 543.e0 * tan4
+	  - tan6) * (1.e0 / 40320.e0);
 
-	y = _falseNorthing + t1 + pow(dlam, 2.e0) * t2 + pow(dlam, 4.e0) * t3
-	  + pow(dlam, 6.e0) * t4 + pow(dlam, 8.e0) * t5;
+	y = k.falseNorthing + t1 + dlam2 * (t2 + dlam2 * (t3 + dlam2 * (t4
+	  + dlam2 * t5)));
 
 
-	t6 = sn * cl * _scale;
-	t7 = sn * c3 * _scale * (1.e0 - tan2 + eta) /6.e0;
-	t8 = sn * c5 * _scale * (5.e0 - 18.e0 * tan2 + tan4 + 14.e0 * eta - 58.e0
+	t6 = sn * cl * k.scale;
+	t7 = sn * c3 * k.scale * (1.e0 - tan2 + eta) * (1.e0 / 6.e0);
+	t8 = sn * c5 * k.scale * (5.e0 - 18.e0 * tan2 + tan4 + 14.e0 * eta - 58.e0
 	  * tan2 * eta + 13.e0 * eta2 + 4.e0 * eta3 - 64.e0 * tan2 * eta2 - 24.e0
-	  * tan2 * eta3) / 120.e0;
-	t9 = sn * c7 * _scale * (61.e0 - 479.e0 * tan2 + 179.e0 * tan4 - tan6)
-	  / 5040.e0;
+	  * tan2 * eta3) * (1.e0 / 120.e0);
+	t9 = sn * c7 * k.scale * (61.e0 - 479.e0 * tan2 + 179.e0 * tan4 - tan6)
+	  * (1.e0 / 5040.e0);
 
-	x = _falseEasting + dlam * t6 + pow(dlam, 3.e0) * t7 + pow(dlam, 5.e0)
-	  * t8 + pow(dlam, 7.e0) * t9;
+	x = k.falseEasting + dlam * (t6 + dlam2 * (t7 + dlam2 * (t8 + dlam2
+	  * t9)));
 
 	return PointD(x, y);
 }
 
-Coordinates TransverseMercator::xy2ll(const PointD &p) const
+inline Coordinates TransverseMercator::inverse(const Constants &k,
+  const PointD &p)
 {
 	double cl;
-	double de;
+	double de, de2;
 	double dlam;
 	double eta, eta2, eta3, eta4;
 	double ftphi;
-	double sn;
+	double sn, sn3, sn5, sn7;
 	double sr;
-	double t, tan2, tan4;
+	double t, tan2, tan4, tan6;
 	double t10, t11, t12, t13, t14, t15, t16, t17;
-	double tmd, tmdo;
+	double tmd;
 	double lat, lon;
 
 
-	tmdo = SPHTMD(_latitudeOrigin);
-	tmd = tmdo + (p.y() - _falseNorthing) / _scale;
+	tmd = k.tmdo + (p.y() - k.falseNorthing) * k.invScale;
 
-	sr = SPHSR(0.e0);
+	sr = SPHSR(k, 0.e0);
 	ftphi = tmd / sr;
 
 	for (int i = 0; i < 5 ; i++) {
-		t10 = SPHTMD(ftphi);
-		sr = SPHSR(ftphi);
+		t10 = SPHTMD(k, ftphi);
+		sr = SPHSR(k, ftphi);
 		ftphi = ftphi + (tmd - t10) / sr;
 	}
 
-	sr = SPHSR(ftphi);
-	sn = SPHSN(ftphi);
+	sr = SPHSR(k, ftphi);
+	sn = SPHSN(k, ftphi);
+	sn3 = sn * sn * sn;
+	sn5 = sn3 * sn * sn;
+	sn7 = sn5 * sn * sn;
 
 	cl = cos(ftphi);
 
 	t = tan(ftphi);
 	tan2 = t * t;
 	tan4 = tan2 * tan2;
-	eta = _ebs * pow(cl, 2);
+	tan6 = tan4 * tan2;
+	eta = k.ebs * cl * cl;
 	eta2 = eta * eta;
 	eta3 = eta2 * eta;
 	eta4 = eta3 * eta;
-	de = p.x() - _falseEasting;
+	de = p.x() - k.falseEasting;
 	if (fabs(de) < 0.0001)
 		de = 0.0;
+	de2 = de * de;
 
-	t10 = t / (2.e0 * sr * sn * pow(_scale, 2));
-	t11 = t * (5.e0  + 3.e0 * tan2 + eta - 4.e0 * pow(eta, 2) - 9.e0 * tan2
-	  * eta) / (24.e0 * sr * pow(sn, 3) * pow(_scale, 4));
+	t10 = t / (2.e0 * sr * sn * k.scale2);
+	t11 = t * (5.e0  + 3.e0 * tan2 + eta - 4.e0 * eta2 - 9.e0 * tan2
+	  * eta) / (24.e0 * sr * sn3 * k.scale4);
 	t12 = t * (61.e0 + 90.e0 * tan2 + 46.e0 * eta + 45.E0 * tan4 - 252.e0 * tan2
 	  * eta - 3.e0 * eta2 + 100.e0 * eta3 - 66.e0 * tan2 * eta2 - 90.e0 * tan4
 	  * eta + 88.e0 * eta4 + 225.e0 * tan4 * eta2 + 84.e0 * tan2 * eta3 - 192.e0
-	  * tan2 * eta4) / (720.e0 * sr * pow(sn, 5) * pow(_scale, 6));
-	t13 = t * (1385.e0 + 3633.e0 * tan2 + 4095.e0 * tan4 + 1575.e0 * pow(t,6))
-	  / (40320.e0 * sr * pow(sn, 7) * pow(_scale, 8));
-	lat = ftphi - pow(de, 2) * t10 + pow(de, 4) * t11 - pow(de, 6) * t12
-	  + pow(de, 8) * t13;
-
-	t14 = 1.e0 / (sn * cl * _scale);
-	t15 = (1.e0 + 2.e0 * tan2 + eta) / (6.e0 * pow(sn, 3) * cl * pow(_scale, 3));
+	  * tan2 * eta4) / (720.e0 * sr * sn5 * k.scale6);
+	t13 = t * (1385.e0 + 3633.e0 * tan2 + 4095.e0 * tan4 + 1575.e0 * tan6)
+	  / (40320.e0 * sr * sn7 * k.scale8);
+	lat = ftphi - de2 * (t10 - de2 * (t11 - de2 * (t12 - de2 * t13)));
+
+	t14 = 1.e0 / (sn * cl * k.scale);
+	t15 = (1.e0 + 2.e0 * tan2 + eta) / (6.e0 * sn3 * cl * k.scale3);
 	t16 = (5.e0 + 6.e0 * eta + 28.e0 * tan2 - 3.e0 * eta2 + 8.e0 * tan2 * eta
 	  + 24.e0 * tan4 - 4.e0 * eta3 + 4.e0 * tan2 * eta2 + 24.e0 * tan2 * eta3)
-	  / (120.e0 * pow(sn, 5) * cl * pow(_scale, 5));
-	t17 = (61.e0 +  662.e0 * tan2 + 1320.e0 * tan4 + 720.e0 * pow(t,6))
-	  / (5040.e0 * pow(sn, 7) * cl * pow(_scale, 7));
+	  / (120.e0 * sn5 * cl * k.scale5);
+	t17 = (61.e0 +  662.e0 * tan2 + 1320.e0 * tan4 + 720.e0 * tan6)
+	  / (5040.e0 * sn7 * cl * k.scale7);
 
-	dlam = de * t14 - pow(de, 3) * t15 + pow(de, 5) * t16 - pow(de, 7) * t17;
+	dlam = de * (t14 - de2 * (t15 - de2 * (t16 - de2 * t17)));
 
-	lon = _longitudeOrigin + dlam;
+	lon = k.longitudeOrigin + dlam;
 	while (lat > deg2rad(90.0)) {
 		lat = M_PI - lat;
 		lon += M_PI;
@@ -253,13 +269,45 @@ Coordinates TransverseMercator::xy2ll(const PointD &p) const
 	return Coordinates(rad2deg(lon), rad2deg(lat));
 }
 
+PointD TransverseMercator::ll2xy(const Coordinates &c) const
+{
+	return forward(_k, c);
+}
+
+Coordinates TransverseMercator::xy2ll(const PointD &p) const
+{
+	return inverse(_k, p);
+}
+
+/* The constants are copied to the stack once per batch so that the compiler
+   can keep them in registers - the output stores could otherwise alias them
+   and force a reload for every point. */
+void TransverseMercator::ll2xyArray(const Coordinates *c, PointD *p,
+  int n) const
+{
+	const Constants k(_k);
+
+	for (int i = 0; i < n; i++)
+		p[i] = forward(k, c[i]);
+}
+
+void TransverseMercator::xy2llArray(const PointD *p, Coordinates *c,
+  int n) const
+{
+	const Constants k(_k);
+
+	for (int i = 0; i < n; i++)
+		c[i] = inverse(k, p[i]);
+}
+
 bool TransverseMercator::operator==(const CT &ct) const
 {
 	const TransverseMercator *other
 	  = dynamic_cast<const TransverseMercator*>(&ct);
-	return (other != 0 && _longitudeOrigin == other->_longitudeOrigin
-	  && _latitudeOrigin == other->_latitudeOrigin && _scale == other->_scale
-	  && _falseEasting == other->_falseEasting
-	  && _falseNorthing == other->_falseNorthing && _a == other->_a
-	  && _es == other->_es);
+	return (other != 0 && _k.longitudeOrigin == other->_k.longitudeOrigin
+	  && _k.latitudeOrigin == other->_k.latitudeOrigin
+	  && _k.scale == other->_k.scale
+	  && _k.falseEasting == other->_k.falseEasting
+	  && _k.falseNorthing == other->_k.falseNorthing && _k.a == other->_k.a
+	  && _k.es == other->_k.es);
 }
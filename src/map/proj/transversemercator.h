@@ -18,16 +18,32 @@ public:
 	virtual PointD ll2xy(const Coordinates &c) const;
 	virtual Coordinates xy2ll(const PointD &p) const;
 
+protected:
+	virtual void ll2xyArray(const Coordinates *c, PointD *p, int n) const;
+	virtual void xy2llArray(const PointD *p, Coordinates *c, int n) const;
+
 private:
-	double _longitudeOrigin;
-	double _latitudeOrigin;
-	double _scale;
-	double _falseEasting;
-	double _falseNorthing;
-	double _a;
-	double _es;
-	double _ebs;
-	double _ap, _bp, _cp, _dp, _ep;
+	struct Constants {
+		double longitudeOrigin;
+		double latitudeOrigin;
+		double scale;
+		double falseEasting;
+		double falseNorthing;
+		double a;
+		double es;
+		double ebs;
+		double ap, bp, cp, dp, ep;
+		double tmdo;
+
+		/* Scale factors of the series terms */
+		double invScale;
+		double scale2, scale3, scale4, scale5, scale6, scale7, scale8;
+	};
+
+	static PointD forward(const Constants &k, const Coordinates &c);
+	static Coordinates inverse(const Constants &k, const PointD &p);
+
+	Constants _k;
 };
 
 #endif // TRANSVERSEMERCATOR_H
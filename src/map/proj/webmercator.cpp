@@ -3,16 +3,45 @@
 #include "common/wgs84.h"
 #include "webmercator.h"
 
+/* The degrees to radians conversions are folded into the constants, the
+   compiler can not do that itself without -ffast-math. */
+#define LON2X (M_PI / 180.0 * WGS84_RADIUS)
+#define LAT2ARG (M_PI / 360.0)
+#define X2LON (180.0 / (M_PI * WGS84_RADIUS))
+#define Y2ARG (1.0 / WGS84_RADIUS)
+
+static inline PointD forward(const Coordinates &c)
+{
+	return PointD(c.lon() * LON2X,
+	  log(tan(M_PI_4 + c.lat() * LAT2ARG)) * WGS84_RADIUS);
+}
+
+static inline Coordinates inverse(const PointD &p)
+{
+	return Coordinates(p.x() * X2LON,
+	  rad2deg(2.0 * atan(exp(p.y() * Y2ARG)) - M_PI_2));
+}
+
 PointD WebMercator::ll2xy(const Coordinates &c) const
 {
-	return PointD(deg2rad(c.lon()) * WGS84_RADIUS,
-	  log(tan(M_PI_4 + deg2rad(c.lat())/2.0)) * WGS84_RADIUS);
+	return forward(c);
 }
 
 Coordinates WebMercator::xy2ll(const PointD &p) const
 {
-	return Coordinates(rad2deg(p.x() / WGS84_RADIUS),
-	  rad2deg(2.0 * atan(exp(p.y() / WGS84_RADIUS)) - M_PI_2));
+	return inverse(p);
+}
+
+void WebMercator::ll2xyArray(const Coordinates *c, PointD *p, int n) const
+{
+	for (int i = 0; i < n; i++)
+		p[i] = forward(c[i]);
+}
+
+void WebMercator::xy2llArray(const PointD *p, Coordinates *c, int n) const
+{
+	for (int i = 0; i < n; i++)
+		c[i] = inverse(p[i]);
 }
 
 bool WebMercator::operator==(const CT &ct) const
@@ -11,6 +11,10 @@ public:
 
 	virtual PointD ll2xy(const Coordinates &c) const;
 	virtual Coordinates xy2ll(const PointD &p) const;
+
+protected:
+	virtual void ll2xyArray(const Coordinates *c, PointD *p, int n) const;
+	virtual void xy2llArray(const PointD *p, Coordinates *c, int n) const;
 };
 
 #endif // WEBMERCATOR_H
@@ -12,6 +12,7 @@
 #include "pcs.h"
 #include "projection.h"
 
+#define CHUNK_SIZE 256
 
 Projection::Projection(const PCS &pcs)
 	: _gcs(pcs.gcs()), _ct(0), _units(pcs.conversion().units()),
@@ -130,3 +131,30 @@ bool Projection::operator==(const Projection &p) const
 	return (*_ct == *p._ct && _gcs == p._gcs && _units == p._units
 	  && _cs == p._cs);
 }
+
+void Projection::ll2xy(const Coordinates *c, PointD *p, int n) const
+{
+	Q_ASSERT(isValid());
+	Coordinates ll[CHUNK_SIZE];
+
+	for (int i = 0; i < n; i += CHUNK_SIZE) {
+		int size = qMin(n - i, (int)CHUNK_SIZE);
+		_gcs.fromWGS84(c + i, ll, size);
+		_ct->ll2xy(ll, p + i, size);
+	}
+	_units.fromMeters(p, n);
+}
+
+void Projection::xy2ll(const PointD *p, Coordinates *c, int n) const
+{
+	Q_ASSERT(isValid());
+	PointD xy[CHUNK_SIZE];
+
+	for (int i = 0; i < n; i += CHUNK_SIZE) {
+		int size = qMin(n - i, (int)CHUNK_SIZE);
+		for (int j = 0; j < size; j++)
+			xy[j] = _units.toMeters(p[i + j]);
+		_ct->xy2ll(xy, c + i, size);
+	}
+	_gcs.toWGS84(c, c, n);
+}
@@ -50,6 +50,11 @@ public:
 		return _gcs.toWGS84(_ct->xy2ll(_units.toMeters(p)));
 	}
 
+	/* Array versions of ll2xy()/xy2ll() with a single CT call per (chunk of
+	   the) array */
+	void ll2xy(const Coordinates *c, PointD *p, int n) const;
+	void xy2ll(const PointD *p, Coordinates *c, int n) const;
+
 	const LinearUnits &units() const {return _units;}
 	const CoordinateSystem &coordinateSystem() const {return _cs;}
 
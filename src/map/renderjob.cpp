@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QPair>
+#include "common/trace.h"
+#include "renderjob.h"
+
+#define PREFETCH_PRIORITY -65536
+
+class RenderJob::Task : public QRunnable
+{
+public:
+	Task(RenderJob *job, int index) : _job(job), _index(index)
+	  {setAutoDelete(false);}
+
+	void run() {_job->runTask(_index);}
+
+private:
+	RenderJob *_job;
+	int _index;
+};
+
+RenderJob::RenderJob(int zoom, bool prefetch)
+  : _zoom(zoom), _prefetch(prefetch), _canceled(0), _pending(0)
+{
+}
+
+RenderJob::~RenderJob()
+{
+	Q_ASSERT(!_pending);
+	qDeleteAll(_tasks);
+}
+
+QThreadPool *RenderJob::pool()
+{
+	static QThreadPool pool;
+	return &pool;
+}
+
+void RenderJob::run()
+{
+	int size = count();
+	QPointF center;
+	QVector<QPair<qreal, int> > order(size);
+
+	/* The job tiles cover the requested area, so their centroid is the
+	   center of the view they were requested for */
+	for (int i = 0; i < size; i++)
+		center += pos(i);
+	if (size)
+		center /= size;
+	for (int i = 0; i < size; i++) {
+		QPointF d(pos(i) - center);
+		order[i] = QPair<qreal, int>(d.x() * d.x() + d.y() * d.y(), i);
+	}
+	std::sort(order.begin(), order.end());
+
+	_pending = size;
+	if (!size) {
+		QMetaObject::invokeMethod(this, "handleFinished", Qt::QueuedConnection);
+		return;
+	}
+
+	_tasks.reserve(size);
+	for (int i = 0; i < size; i++)
+		_tasks.append(new Task(this, order.at(i).second));
+	for (int i = 0; i < size; i++)
+		pool()->start(_tasks.at(i), _prefetch ? PREFETCH_PRIORITY - i : -i);
+}
+
+void RenderJob::cancel(bool wait)
+{
+	_canceled.storeRelaxed(1);
+
+	for (int i = 0; i < _tasks.size(); i++)
+		if (pool()->tryTake(_tasks.at(i)))
+			taskDone();
+
+	if (wait) {
+		_lock.lock();
+		while (_pending)
+			_done.wait(&_lock);
+		_lock.unlock();
+	}
+}
+
+void RenderJob::runTask(int index)
+{
+	if (!_canceled.loadRelaxed())
+		render(index);
+	taskDone();
+}
+
+void RenderJob::taskDone()
+{
+	_lock.lock();
+	bool last = !--_pending;
+	if (last)
+		_done.wakeAll();
+	_lock.unlock();
+
+	/* Always queued, the job may be cancelled from the map's job loop */
+	if (last)
+		QMetaObject::invokeMethod(this, "handleFinished", Qt::QueuedConnection);
+}
+
+
+void RenderQueue::run(RenderJob *job)
+{
+	_jobs.append(job);
+	for (int i = 0; i < job->count(); i++)
+		_keys.insert(job->key(i));
+	TRACE_COUNT("render jobs", 1);
+
+	job->run();
+}
+
+void RenderQueue::remove(RenderJob *job)
+{
+	_jobs.removeOne(job);
+	for (int i = 0; i < job->count(); i++)
+		_keys.remove(job->key(i));
+	TRACE_COUNT("render jobs", -1);
+
+	job->deleteLater();
+}
+
+void RenderQueue::cancel(bool wait)
+{
+	for (int i = 0; i < _jobs.size(); i++)
+		_jobs.at(i)->cancel(wait);
+}
+
+void RenderQueue::cancelStale(int zoom)
+{
+	for (int i = 0; i < _jobs.size(); i++)
+		if (_jobs.at(i)->zoom() != zoom)
+			_jobs.at(i)->cancel(false);
+}
+
+void RenderQueue::cancelPrefetch(int zoom)
+{
+	for (int i = 0; i < _jobs.size(); i++)
+		if (_jobs.at(i)->isPrefetch() && _jobs.at(i)->zoom() != zoom)
+			_jobs.at(i)->cancel(false);
+}
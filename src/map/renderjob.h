@@ -0,0 +1,115 @@
+#ifndef RENDERJOB_H
+#define RENDERJOB_H
+
+#include <QObject>
+#include <QList>
+#include <QVector>
+#include <QSet>
+#include <QString>
+#include <QPointF>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+
+class QThreadPool;
+
+/* Asynchronous tile rendering job. The tiles are rendered in a worker pool
+   shared by all the maps and separate from the Qt global pool (used for the
+   synchronous rendering and by the renderers themselves). Tiles closer to
+   the center of the job area are rendered first, prefetch jobs only run
+   when there is nothing else to render. */
+class RenderJob : public QObject
+{
+	Q_OBJECT
+
+public:
+	RenderJob(int zoom, bool prefetch);
+	~RenderJob();
+
+	int zoom() const {return _zoom;}
+	bool isPrefetch() const {return _prefetch;}
+
+	void run();
+	/* Tiles not yet rendered are dropped, their pixmaps stay null. The
+	   finished() signal is emitted in any case. */
+	void cancel(bool wait);
+
+	virtual int count() const = 0;
+	virtual QString key(int index) const = 0;
+
+	static QThreadPool *pool();
+
+signals:
+	void finished(RenderJob *job);
+
+protected:
+	virtual QPointF pos(int index) const = 0;
+	virtual void render(int index) = 0;
+
+private slots:
+	void handleFinished() {emit finished(this);}
+
+private:
+	class Task;
+
+	void runTask(int index);
+	void taskDone();
+
+	int _zoom;
+	bool _prefetch;
+	QVector<Task*> _tasks;
+	QAtomicInt _canceled;
+	int _pending;
+	QMutex _lock;
+	QWaitCondition _done;
+};
+
+template <class T, void (T::*RENDER)()>
+class TileJob : public RenderJob
+{
+public:
+	TileJob(const QList<T> &tiles, int zoom, bool prefetch = false)
+	  : RenderJob(zoom, prefetch), _tiles(tiles)
+	{
+		/* The tiles are rendered in parallel, the list must not be shared */
+		_tiles.detach();
+	}
+
+	const QList<T> &tiles() const {return _tiles;}
+
+	int count() const {return _tiles.size();}
+	QString key(int index) const {return _tiles.at(index).key();}
+
+protected:
+	QPointF pos(int index) const {return _tiles.at(index).xy();}
+	void render(int index) {(_tiles[index].*RENDER)();}
+
+private:
+	QList<T> _tiles;
+};
+
+/* The render jobs of a map with a hashed registry of the tiles in flight */
+class RenderQueue
+{
+public:
+	bool isEmpty() const {return _jobs.isEmpty();}
+	bool isRunning(const QString &key) const {return _keys.contains(key);}
+
+	void run(RenderJob *job);
+	/* Must be called from the job's finished() handler */
+	void remove(RenderJob *job);
+
+	void cancel(bool wait);
+	/* Cancels the jobs of all zoom levels except of zoom */
+	void cancelStale(int zoom);
+	/* Cancels the prefetch jobs of all zoom levels except of zoom. The tiles
+	   of the current zoom level are queued behind the visible ones anyway
+	   and after a zoom in they are the visible ones. */
+	void cancelPrefetch(int zoom);
+
+private:
+	QList<RenderJob*> _jobs;
+	QSet<QString> _keys;
+};
+
+#endif // RENDERJOB_H
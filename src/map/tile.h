@@ -4,22 +4,34 @@
 #include <QVariant>
 #include <QPixmap>
 #include <QPoint>
+#include "tilestore.h"
 
+/* Tiles with a store are loaded from the tile store, the file is only the
+   tile identification in that case */
 class FileTile
 {
 public:
-	FileTile(const QPoint &xy, const QString &file)
-	  : _xy(xy), _file(file) {}
+	FileTile(const QPoint &xy, const QString &file,
+	  const QString &store = QString(), const QString &zoom = QString())
+	  : _xy(xy), _file(file), _store(store), _zoom(zoom) {}
 
 	const QPoint &xy() const {return _xy;}
 	const QString &file() const {return _file;}
 	const QPixmap &pixmap() const {return _pixmap;}
 
-	void load() {_pixmap.load(_file);}
+	void load()
+	{
+		if (_store.isNull())
+			_pixmap.load(_file);
+		else
+			_pixmap.loadFromData(TileStore::read(_store, _zoom, _xy));
+	}
 
 private:
 	QPoint _xy;
 	QString _file;
+	QString _store;
+	QString _zoom;
 	QPixmap _pixmap;
 };
 
@@ -53,33 +53,119 @@ static QString quadKey(const QPoint &xy, int zoom)
 }
 
 TileLoader::TileLoader(const QString &dir, QObject *parent)
-  : QObject(parent), _urlType(XYZ), _dir(dir)
+  : QObject(parent), _urlType(XYZ), _dir(dir), _store(dir)
 {
 	if (!QDir().mkpath(_dir))
 		qWarning("%s: %s", qUtf8Printable(_dir),
 		  "Error creating tiles directory");
 
 	_downloader = new Downloader(this);
-	connect(_downloader, &Downloader::finished, this, &TileLoader::finished);
+	connect(_downloader, &Downloader::finished, this,
+	  &TileLoader::downloadsFinished);
+	connect(_downloader, &Downloader::downloaded, this,
+	  &TileLoader::storeTile);
 }
 
+void TileLoader::storeTile(const QUrl &url, const QByteArray &data)
+{
+	Tile t(_pending.take(url));
+	if (!t.zoom().isNull())
+		_store.insert(t.zoom().toString(), t.xy(), data);
+}
+
+void TileLoader::downloadsFinished()
+{
+	/* Nothing is running or queued at this point, the remaining pending
+	   tiles are the failed downloads */
+	_pending.clear();
+	emit finished();
+}
+
+/* Batch existence check of all the tiles in the list (one zoom level) */
+QSet<QPoint> TileLoader::storedTiles(const QVector<Tile> &list)
+{
+	if (list.isEmpty() || !_store.open())
+		return QSet<QPoint>();
+
+	QPoint tl(list.first().xy()), br(list.first().xy());
+	for (int i = 1; i < list.size(); i++) {
+		const QPoint &xy = list.at(i).xy();
+		tl = QPoint(qMin(tl.x(), xy.x()), qMin(tl.y(), xy.y()));
+		br = QPoint(qMax(br.x(), xy.x()), qMax(br.y(), xy.y()));
+	}
+
+	return _store.find(list.first().zoom().toString(), QRect(tl, br));
+}
+
+/* Falls back to the one-file-per-tile layout if the tile store is not
+   available */
+bool TileLoader::findTile(Tile &tile, const QSet<QPoint> &stored)
+{
+	QString file(tileFile(tile));
+
+	if (_store.open()) {
+		if (!stored.contains(tile.xy()))
+			return false;
+		tile.setFile(file, _dir);
+	} else {
+		if (!QFileInfo::exists(file))
+			return false;
+		tile.setFile(file);
+	}
+
+	return true;
+}
+
+Download TileLoader::download(const Tile &tile, const QUrl &url,
+  const QPointF &center)
+{
+	if (_store.open()) {
+		_pending.insert(url, tile);
+		return Download(url, QString(), priority(tile, center));
+	} else
+		return Download(url, tileFile(tile), priority(tile, center));
+}
+
+
+QPointF TileLoader::center(const QVector<Tile> &list)
+{
+	QPointF c;
+
+	for (int i = 0; i < list.size(); i++)
+		c += list.at(i).xy();
+
+	return list.isEmpty() ? c : c / list.size();
+}
+
+/* Tiles closer to the center of the requested area (the viewport) are
+   downloaded first */
+int TileLoader::priority(const Tile &tile, const QPointF &center)
+{
+	QPointF d(tile.xy() - center);
+	return qRound(d.x() * d.x() + d.y() * d.y());
+}
 
 void TileLoader::loadTilesAsync(QVector<Tile> &list)
 {
 	QList<Download> dl;
+	QPointF c(center(list));
+	QSet<QPoint> stored(storedTiles(list));
+
+	/* Queued downloads of a different zoom level are not needed any more */
+	if (!list.isEmpty() && list.first().zoom() != _zoom) {
+		_downloader->cancel();
+		_zoom = list.first().zoom();
+	}
 
 	for (int i = 0; i < list.size(); i++) {
 		Tile &t = list[i];
-		QString file(tileFile(t));
 
-		if (QFileInfo::exists(file))
-			t.setFile(file);
-		else {
+		if (!findTile(t, stored)) {
 			QUrl url(tileUrl(t));
 			if (url.isLocalFile())
 				t.setFile(url.toLocalFile());
 			else
-				dl.append(Download(url, file));
+				dl.append(download(t, url, c));
 		}
 	}
 
@@ -91,19 +177,18 @@ void TileLoader::loadTilesSync(QVector<Tile> &list)
 {
 	QList<Download> dl;
 	QList<Tile *> tl;
+	QPointF c(center(list));
+	QSet<QPoint> stored(storedTiles(list));
 
 	for (int i = 0; i < list.size(); i++) {
 		Tile &t = list[i];
-		QString file(tileFile(t));
 
-		if (QFileInfo::exists(file))
-			t.setFile(file);
-		else {
+		if (!findTile(t, stored)) {
 			QUrl url(tileUrl(t));
 			if (url.isLocalFile())
 				t.setFile(url.toLocalFile());
 			else {
-				dl.append(Download(url, file));
+				dl.append(download(t, url, c));
 				tl.append(&t);
 			}
 		}
@@ -115,22 +200,60 @@ void TileLoader::loadTilesSync(QVector<Tile> &list)
 		if (_downloader->get(dl, _headers))
 			wait.exec();
 
-		for (int i = 0; i < tl.size(); i++) {
-			Tile *t = tl[i];
-			QString file(tileFile(*t));
-			if (QFileInfo::exists(file))
-				t->setFile(file);
+		stored = storedTiles(list);
+		for (int i = 0; i < tl.size(); i++)
+			findTile(*tl[i], stored);
+	}
+}
+
+/* Starts the downloads of the missing tiles. Returns false if there is
+   nothing to download, finished() is emitted when all the downloads are done
+   otherwise. Tiles that are (or were before) available have the file set. */
+bool TileLoader::seedTiles(QVector<Tile> &list)
+{
+	QList<Download> dl;
+	QPointF c(center(list));
+	QSet<QPoint> stored(storedTiles(list));
+
+	for (int i = 0; i < list.size(); i++) {
+		Tile &t = list[i];
+
+		if (!findTile(t, stored)) {
+			QUrl url(tileUrl(t));
+			if (url.isLocalFile())
+				t.setFile(url.toLocalFile());
+			else
+				dl.append(download(t, url, c));
 		}
 	}
+
+	return dl.isEmpty() ? false : _downloader->get(dl, _headers);
+}
+
+/* Creates a loader of the same tiles with background priority downloads */
+TileLoader *TileLoader::seedLoader(QObject *parent) const
+{
+	TileLoader *loader = new TileLoader(_dir, parent);
+
+	loader->_url = _url;
+	loader->_urlType = _urlType;
+	loader->_headers = _headers;
+	loader->_downloader->setBackground(true);
+
+	return loader;
 }
 
 void TileLoader::clearCache()
 {
-	QDir dir = QDir(_dir);
-	QStringList list = dir.entryList();
+	if (_store.open())
+		_store.clear();
+	else {
+		QDir dir = QDir(_dir);
+		QStringList list = dir.entryList();
 
-	for (int i = 0; i < list.count(); i++)
-		dir.remove(list.at(i));
+		for (int i = 0; i < list.count(); i++)
+			dir.remove(list.at(i));
+	}
 
 	_downloader->clearErrors();
 }
@@ -3,7 +3,9 @@
 
 #include <QObject>
 #include <QString>
+#include <QHash>
 #include "downloader.h"
+#include "tilestore.h"
 #include "rectd.h"
 
 class TileLoader : public QObject
@@ -21,27 +23,32 @@ public:
 	{
 	public:
 		Tile() {}
-		Tile(const QPoint &xy, int zoom)
-		  : _xy(xy), _zoom(zoom) {}
-		Tile(const QPoint &xy, const QString &zoom)
-		  : _xy(xy), _zoom(zoom) {}
+		Tile(const QPoint &xy, int zoom) : _xy(xy), _zoom(zoom) {}
+		Tile(const QPoint &xy, const QString &zoom) : _xy(xy), _zoom(zoom) {}
 		Tile(const QPoint &xy, int zoom, const RectD &bbox)
 		  : _xy(xy), _zoom(zoom), _bbox(bbox) {}
 
 		const QVariant &zoom() const {return _zoom;}
 		const QPoint &xy() const {return _xy;}
 		const RectD &bbox() const {return _bbox;}
+		/* The file is the tile identification (cache key) even if the tile
+		   data is kept in the tile store. */
 		const QString &file() const {return _file;}
+		/* The tile store directory if the tile data is kept in the tile
+		   store, use TileStore::read() to get the data in the render job. */
+		const QString &store() const {return _store;}
 
 	private:
 		friend class TileLoader;
 
-		void setFile(const QString &file) {_file = file;}
+		void setFile(const QString &file, const QString &store = QString())
+		  {_file = file; _store = store;}
 
 		QPoint _xy;
 		QVariant _zoom;
 		RectD _bbox;
 		QString _file;
+		QString _store;
 	};
 
 
@@ -52,20 +59,37 @@ public:
 
 	void loadTilesAsync(QVector<Tile> &list);
 	void loadTilesSync(QVector<Tile> &list);
+	bool seedTiles(QVector<Tile> &list);
 	void clearCache();
 
+	TileLoader *seedLoader(QObject *parent = 0) const;
+	/* The tile identification without checking the tile availability */
+	QString tileKey(const Tile &tile) const {return tileFile(tile);}
+
 signals:
 	void finished();
 
+private slots:
+	void storeTile(const QUrl &url, const QByteArray &data);
+	void downloadsFinished();
+
 private:
 	QUrl tileUrl(const Tile &tile) const;
 	QString tileFile(const Tile &tile) const;
+	QSet<QPoint> storedTiles(const QVector<Tile> &list);
+	bool findTile(Tile &tile, const QSet<QPoint> &stored);
+	Download download(const Tile &tile, const QUrl &url, const QPointF &center);
+	static QPointF center(const QVector<Tile> &list);
+	static int priority(const Tile &tile, const QPointF &center);
 
 	Downloader *_downloader;
+	QVariant _zoom;
 	QString _url;
 	UrlType _urlType;
 	QString _dir;
 	QList<HTTPHeader> _headers;
+	TileStore _store;
+	QHash<QUrl, Tile> _pending;
 };
 
 #endif // TILELOADER_H
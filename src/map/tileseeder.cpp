@@ -0,0 +1,141 @@
+#include "tileseeder.h"
+
+#define BATCH_SIZE 64
+
+static qint64 size(const QRect &rect)
+{
+	return rect.isEmpty() ? 0 : (qint64)rect.width() * (qint64)rect.height();
+}
+
+TileSeeder::TileSeeder(const TileLoader *loader, const QList<RectC> &area,
+  const Range &zooms, QObject *parent) : QObject(parent), _area(area),
+  _zooms(zooms), _zoom(zooms.min()), _rect(0), _next(0), _count(-1), _done(0),
+  _failed(0), _running(false)
+{
+	_loader = loader->seedLoader(this);
+	connect(_loader, &TileLoader::finished, this, &TileSeeder::batchLoaded);
+}
+
+/* The tiles count estimate. Tiles covered by more than one area rect are
+   counted multiple times. */
+qint64 TileSeeder::count()
+{
+	if (_count < 0) {
+		_count = 0;
+		for (int z = _zooms.min(); z <= _zooms.max(); z++)
+			for (int i = 0; i < _area.size(); i++)
+				_count += size(tiles(_area.at(i), z));
+	}
+
+	return _count;
+}
+
+void TileSeeder::start()
+{
+	if (_running)
+		return;
+
+	_zoom = _zooms.min();
+	_rect = 0;
+	_next = 0;
+	_range = _area.isEmpty() ? QRect() : tiles(_area.first(), _zoom);
+	_seen.clear();
+	_done = 0;
+	_failed = 0;
+	_running = true;
+
+	loadBatches();
+}
+
+void TileSeeder::cancel()
+{
+	if (!_running)
+		return;
+
+	_running = false;
+	_batch.clear();
+	/* Deleting the loader aborts the running downloads */
+	_loader->disconnect(this);
+	_loader->deleteLater();
+	_loader = _loader->seedLoader(this);
+	connect(_loader, &TileLoader::finished, this, &TileSeeder::batchLoaded);
+}
+
+/* Fills the next batch of tiles. All the batch tiles are of the same zoom
+   level as required by the TileLoader batch existence check. */
+bool TileSeeder::nextBatch()
+{
+	_batch.clear();
+
+	while (_zoom <= _zooms.max()) {
+		while (_rect < _area.size()) {
+			while (_next < size(_range)) {
+				QPoint xy(_range.left() + (int)(_next % _range.width()),
+				  _range.top() + (int)(_next / _range.width()));
+				_next++;
+
+				/* Overlapping area rects */
+				if (_area.size() > 1) {
+					if (_seen.contains(xy)) {
+						_done++;
+						continue;
+					}
+					_seen.insert(xy);
+				}
+
+				_batch.append(tile(xy, _zoom));
+				if (_batch.size() >= BATCH_SIZE)
+					return true;
+			}
+
+			if (++_rect < _area.size())
+				_range = tiles(_area.at(_rect), _zoom);
+			_next = 0;
+		}
+
+		if (!_batch.isEmpty())
+			return true;
+
+		_seen.clear();
+		_rect = 0;
+		if (++_zoom <= _zooms.max() && !_area.isEmpty())
+			_range = tiles(_area.first(), _zoom);
+	}
+
+	return !_batch.isEmpty();
+}
+
+void TileSeeder::finishBatch()
+{
+	for (int i = 0; i < _batch.size(); i++)
+		if (_batch.at(i).file().isNull())
+			_failed++;
+	_done += _batch.size();
+
+	emit progress(_done, qMax(_done, count()));
+}
+
+void TileSeeder::loadBatches()
+{
+	while (_running && nextBatch()) {
+		if (_loader->seedTiles(_batch))
+			return;
+		finishBatch();
+	}
+
+	if (_running) {
+		_running = false;
+		emit finished();
+	}
+}
+
+/* Failed downloads are retried by seedTiles() as long as the downloader
+   allows it, the batch is done when there is nothing more to download. */
+void TileSeeder::batchLoaded()
+{
+	if (!_running || _loader->seedTiles(_batch))
+		return;
+
+	finishBatch();
+	loadBatches();
+}
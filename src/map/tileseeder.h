@@ -0,0 +1,70 @@
+#ifndef TILESEEDER_H
+#define TILESEEDER_H
+
+#include <QObject>
+#include <QList>
+#include <QVector>
+#include <QSet>
+#include <QRect>
+#include "common/range.h"
+#include "common/rectc.h"
+#include "tileloader.h"
+
+/* Offline area seeding - downloads all the tiles of an area in a zoom range
+   into the map tiles cache. The tiles are requested in batches using a
+   background priority copy of the map tile loader, so the seeding never
+   delays the tiles requested by the map view. Tiles already in the cache
+   are skipped, starting the same seeding again thus resumes an interrupted
+   one. */
+class TileSeeder : public QObject
+{
+	Q_OBJECT
+
+public:
+	TileSeeder(const TileLoader *loader, const QList<RectC> &area,
+	  const Range &zooms, QObject *parent = 0);
+
+	qint64 count();
+	qint64 done() const {return _done;}
+	qint64 failed() const {return _failed;}
+	bool isRunning() const {return _running;}
+
+	void start();
+	void cancel();
+
+signals:
+	void progress(qint64 done, qint64 total);
+	void finished();
+
+protected:
+	/* The (inclusive) range of tiles covering rect at the zoom level, an
+	   empty rect if there are no such tiles */
+	virtual QRect tiles(const RectC &rect, int zoom) const = 0;
+	virtual TileLoader::Tile tile(const QPoint &xy, int zoom) const = 0;
+
+private slots:
+	void batchLoaded();
+
+private:
+	bool nextBatch();
+	void loadBatches();
+	void finishBatch();
+
+	TileLoader *_loader;
+	QList<RectC> _area;
+	Range _zooms;
+
+	int _zoom;
+	int _rect;
+	QRect _range;
+	qint64 _next;
+	QSet<QPoint> _seen;
+	QVector<TileLoader::Tile> _batch;
+
+	qint64 _count;
+	qint64 _done;
+	qint64 _failed;
+	bool _running;
+};
+
+#endif // TILESEEDER_H
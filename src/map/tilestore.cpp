@@ -0,0 +1,390 @@
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QThread>
+#include <QtConcurrent>
+#include <QSqlQuery>
+#include <QSqlError>
+#include "tilestore.h"
+
+/* Eviction frees the cache down to this fraction of the quota so that it
+   does not run on every inserted tile */
+#define EVICT_RATIO 0.9
+/* Number of the legacy tile files imported in one transaction */
+#define MIGRATE_BATCH 256
+
+qint64 TileStore::_quota = 0;
+QHash<QString, qint64> TileStore::_sizes;
+qint64 TileStore::_total = 0;
+QList<TileStore*> TileStore::_stores;
+QHash<QString, TileStore::Migration> TileStore::_migrations;
+
+static qint64 now()
+{
+	return QDateTime::currentSecsSinceEpoch();
+}
+
+/* Parses the legacy "zoom-x-y" tile file names. The zoom may contain '-'
+   (WMTS tile matrix identifiers), the coordinates are the last two fields. */
+static bool parseName(const QString &name, QString &zoom, QPoint &xy)
+{
+	bool xOk, yOk;
+
+	int yi = name.lastIndexOf('-');
+	if (yi < 1)
+		return false;
+	int xi = name.lastIndexOf('-', yi - 1);
+	if (xi < 1)
+		return false;
+
+	zoom = name.left(xi);
+	xy = QPoint(name.mid(xi + 1, yi - xi - 1).toInt(&xOk),
+	  name.mid(yi + 1).toInt(&yOk));
+
+	return (xOk && yOk);
+}
+
+TileStore::TileStore(const QString &dir) : _dir(dir), _error(false)
+{
+	_connection = "TileStore:" + dir + ":"
+	  + QString::number((quintptr)this, 16);
+
+	if (!_sizes.contains(_dir))
+		setSize(QFileInfo(QDir(_dir).filePath(fileName())).size());
+	_stores.append(this);
+}
+
+TileStore::~TileStore()
+{
+	_stores.removeOne(this);
+
+	if (QSqlDatabase::contains(_connection)) {
+		_db.close();
+		_db = QSqlDatabase();
+		QSqlDatabase::removeDatabase(_connection);
+	}
+}
+
+bool TileStore::open()
+{
+	if (_db.isOpen())
+		return true;
+	if (_error)
+		return false;
+
+	QString path(QDir(_dir).filePath(fileName()));
+	_db = QSqlDatabase::addDatabase("QSQLITE", _connection);
+	_db.setDatabaseName(path);
+	if (!_db.open()) {
+		qWarning("%s: %s", qUtf8Printable(path),
+		  qUtf8Printable(_db.lastError().text()));
+		_error = true;
+		return false;
+	}
+
+	QSqlQuery query(_db);
+	query.exec("PRAGMA journal_mode=WAL");
+	query.exec("PRAGMA synchronous=NORMAL");
+	if (!query.exec("CREATE TABLE IF NOT EXISTS tiles (zoom TEXT NOT NULL, "
+	  "x INTEGER NOT NULL, y INTEGER NOT NULL, data BLOB NOT NULL, "
+	  "atime INTEGER NOT NULL, PRIMARY KEY (zoom, x, y))")
+	  || !query.exec("CREATE INDEX IF NOT EXISTS tiles_atime ON tiles (atime)")) {
+		qWarning("%s: %s", qUtf8Printable(path),
+		  qUtf8Printable(query.lastError().text()));
+		_db.close();
+		_error = true;
+		return false;
+	}
+
+	/* The legacy tile files are imported only once, in the background */
+	if (!_migrations.contains(_dir)) {
+		Migration &m = _migrations[_dir];
+		m.future = QtConcurrent::run(migrate, _dir);
+	}
+
+	if (query.exec("SELECT total(length(data)) FROM tiles") && query.next())
+		setSize(query.value(0).toLongLong());
+
+	return true;
+}
+
+void TileStore::setSize(qint64 size)
+{
+	_total += size - _sizes.value(_dir);
+	_sizes.insert(_dir, size);
+}
+
+/* Imports the tiles of the previous one-file-per-tile cache layout and
+   removes the files. Runs in a worker thread using a connection of its own,
+   the tiles are imported in small transactions to not block the store. */
+void TileStore::migrate(const QString &path)
+{
+	QDir dir(path);
+	QStringList files(dir.entryList(QDir::Files));
+	QString connection("TileStore:migrate:" + path);
+	QString zoom;
+	QPoint xy;
+
+	{
+		QSqlDatabase db(QSqlDatabase::addDatabase("QSQLITE", connection));
+		db.setDatabaseName(dir.filePath(fileName()));
+		if (!db.open())
+			files.clear();
+
+		QSqlQuery query(db);
+		query.prepare("INSERT OR IGNORE INTO tiles (zoom, x, y, data, atime) "
+		  "VALUES (?, ?, ?, ?, ?)");
+
+		for (int i = 0; i < files.size(); i += MIGRATE_BATCH) {
+			QStringList imported;
+
+			db.transaction();
+			for (int j = i; j < qMin(i + MIGRATE_BATCH, (int)files.size());
+			  j++) {
+				const QString &name = files.at(j);
+				if (name.startsWith(fileName()))
+					continue;
+
+				/* Names not matching the tiles layout are leftovers like
+				   interrupted downloads, or tiles with file system escaped zoom
+				   identifiers that can not be mapped back. All of them are
+				   simply dropped. */
+				if (parseName(name, zoom, xy)) {
+					QFile file(dir.filePath(name));
+					if (!file.open(QIODevice::ReadOnly))
+						continue;
+
+					query.addBindValue(zoom);
+					query.addBindValue(xy.x());
+					query.addBindValue(xy.y());
+					query.addBindValue(file.readAll());
+					query.addBindValue(now());
+					if (!query.exec())
+						continue;
+				}
+
+				imported.append(name);
+			}
+			if (!db.commit())
+				break;
+
+			for (int j = 0; j < imported.size(); j++)
+				dir.remove(imported.at(j));
+		}
+	}
+
+	QSqlDatabase::removeDatabase(connection);
+}
+
+/* The size of the store is recomputed once the migration has finished */
+void TileStore::checkMigration()
+{
+	QHash<QString, Migration>::iterator it(_migrations.find(_dir));
+	if (it == _migrations.end() || it->done || !it->future.isFinished())
+		return;
+
+	QSqlQuery query(_db);
+	if (query.exec("SELECT total(length(data)) FROM tiles") && query.next())
+		setSize(query.value(0).toLongLong());
+	it->done = true;
+}
+
+/* Reads the tile data using a connection of its own, so that the data can be
+   loaded in the render jobs (any thread) */
+QByteArray TileStore::read(const QString &dir, const QString &zoom,
+  const QPoint &xy)
+{
+	QString connection("TileStore:read:" + dir + ":"
+	  + QString::number((quintptr)QThread::currentThreadId(), 16));
+	QByteArray data;
+
+	{
+		QSqlDatabase db(QSqlDatabase::addDatabase("QSQLITE", connection));
+		db.setDatabaseName(QDir(dir).filePath(fileName()));
+		db.setConnectOptions("QSQLITE_OPEN_READONLY");
+		if (db.open()) {
+			QSqlQuery query(db);
+			query.prepare("SELECT data FROM tiles WHERE zoom = ? AND x = ? "
+			  "AND y = ?");
+			query.addBindValue(zoom);
+			query.addBindValue(xy.x());
+			query.addBindValue(xy.y());
+			if (query.exec() && query.next())
+				data = query.value(0).toByteArray();
+		}
+	}
+
+	QSqlDatabase::removeDatabase(connection);
+
+	return data;
+}
+
+/* Access time of the least recently used tile of the store */
+bool TileStore::oldest(qint64 &atime)
+{
+	if (!_sizes.value(_dir) || !open())
+		return false;
+
+	QSqlQuery query(_db);
+	if (!query.exec("SELECT min(atime) FROM tiles") || !query.next()
+	  || query.isNull(0))
+		return false;
+	atime = query.value(0).toLongLong();
+
+	return true;
+}
+
+/* Removes the tiles not used since atime, least recently used first, until
+   the total size drops to limit. */
+bool TileStore::evictTiles(qint64 atime, qint64 limit)
+{
+	QList<qlonglong> rows;
+	qint64 size = _sizes.value(_dir);
+
+	QSqlQuery query(_db);
+	query.prepare("SELECT rowid, length(data) FROM tiles WHERE atime <= ? "
+	  "ORDER BY atime");
+	query.addBindValue(atime);
+	if (!query.exec())
+		return false;
+	for (qint64 total = _total; total > limit && query.next(); ) {
+		rows.append(query.value(0).toLongLong());
+		size -= query.value(1).toLongLong();
+		total -= query.value(1).toLongLong();
+	}
+	query.finish();
+
+	query.prepare("DELETE FROM tiles WHERE rowid = ?");
+	_db.transaction();
+	for (int i = 0; i < rows.size(); i++) {
+		query.addBindValue(rows.at(i));
+		query.exec();
+	}
+	if (!_db.commit())
+		return false;
+
+	setSize(size);
+
+	return !rows.isEmpty();
+}
+
+/* Global LRU eviction - the tiles are removed from the store holding the
+   least recently used tile until the total size of all the stores drops
+   below the eviction limit. */
+void TileStore::evict()
+{
+	qint64 limit = (qint64)(_quota * EVICT_RATIO);
+
+	while (_total > limit) {
+		TileStore *lru = 0;
+		qint64 lruTime = 0, atime;
+
+		for (int i = 0; i < _stores.size(); i++) {
+			TileStore *store = _stores.at(i);
+			if (store->oldest(atime) && (!lru || atime < lruTime)) {
+				lru = store;
+				lruTime = atime;
+			}
+		}
+
+		if (!lru || !lru->evictTiles(lruTime, limit))
+			break;
+	}
+}
+
+/* Returns the coordinates of all the stored tiles of the given zoom in the
+   (inclusive) rect with a single query and marks them as used. */
+QSet<QPoint> TileStore::find(const QString &zoom, const QRect &rect)
+{
+	QSet<QPoint> set;
+
+	if (!open())
+		return set;
+
+	QSqlQuery query(_db);
+	query.prepare("SELECT x, y FROM tiles WHERE zoom = ? AND x BETWEEN ? AND ?"
+	  " AND y BETWEEN ? AND ?");
+	query.addBindValue(zoom);
+	query.addBindValue(rect.left());
+	query.addBindValue(rect.right());
+	query.addBindValue(rect.top());
+	query.addBindValue(rect.bottom());
+	if (!query.exec())
+		return set;
+	while (query.next())
+		set.insert(QPoint(query.value(0).toInt(), query.value(1).toInt()));
+
+	/* The access time is only updated when the viewport changes, not on
+	   every repaint of the same area */
+	if (!set.isEmpty() && (zoom != _lastZoom || rect != _lastRect)) {
+		query.prepare("UPDATE tiles SET atime = ? WHERE zoom = ? AND x BETWEEN"
+		  " ? AND ? AND y BETWEEN ? AND ?");
+		query.addBindValue(now());
+		query.addBindValue(zoom);
+		query.addBindValue(rect.left());
+		query.addBindValue(rect.right());
+		query.addBindValue(rect.top());
+		query.addBindValue(rect.bottom());
+		query.exec();
+
+		_lastZoom = zoom;
+		_lastRect = rect;
+	}
+
+	return set;
+}
+
+bool TileStore::insert(const QString &zoom, const QPoint &xy,
+  const QByteArray &data)
+{
+	if (!open())
+		return false;
+
+	qint64 replaced = 0;
+
+	checkMigration();
+
+	/* A replaced tile is accounted with the size difference */
+	QSqlQuery query(_db);
+	query.prepare("SELECT length(data) FROM tiles WHERE zoom = ? AND x = ? "
+	  "AND y = ?");
+	query.addBindValue(zoom);
+	query.addBindValue(xy.x());
+	query.addBindValue(xy.y());
+	if (query.exec() && query.next())
+		replaced = query.value(0).toLongLong();
+
+	query.prepare("INSERT OR REPLACE INTO tiles (zoom, x, y, data, atime) "
+	  "VALUES (?, ?, ?, ?, ?)");
+	query.addBindValue(zoom);
+	query.addBindValue(xy.x());
+	query.addBindValue(xy.y());
+	query.addBindValue(data);
+	query.addBindValue(now());
+	if (!query.exec()) {
+		qWarning("%s: %s", qUtf8Printable(_dir),
+		  qUtf8Printable(query.lastError().text()));
+		return false;
+	}
+
+	setSize(_sizes.value(_dir) + data.size() - replaced);
+	if (_quota && _total > _quota)
+		evict();
+
+	return true;
+}
+
+void TileStore::clear()
+{
+	if (!open())
+		return;
+
+	QSqlQuery query(_db);
+	query.exec("DELETE FROM tiles");
+	query.exec("VACUUM");
+
+	setSize(0);
+	_lastZoom = QString();
+	_lastRect = QRect();
+}
@@ -0,0 +1,72 @@
+#ifndef TILESTORE_H
+#define TILESTORE_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QSet>
+#include <QHash>
+#include <QList>
+#include <QRect>
+#include <QFuture>
+#include "common/hash.h"
+
+/* Online maps tiles cache. All the tiles of a map are stored in a single
+   SQLite database in the map tiles directory instead of one file per tile.
+   The quota applies to the total size of all the stores, the least recently
+   used tiles of all the stores are evicted when it is exceeded. The database
+   connection is opened lazily as it must only be used in the thread that
+   opened it, the stores are used in the GUI thread only. The tile data are
+   read with read() that can be used in any thread. */
+class TileStore
+{
+public:
+	TileStore(const QString &dir);
+	~TileStore();
+
+	bool open();
+
+	QSet<QPoint> find(const QString &zoom, const QRect &rect);
+	bool insert(const QString &zoom, const QPoint &xy, const QByteArray &data);
+	void clear();
+
+	static QByteArray read(const QString &dir, const QString &zoom,
+	  const QPoint &xy);
+
+	static QString fileName() {return "tiles.db";}
+	static void setQuota(qint64 size) {_quota = size;}
+
+private:
+	struct Migration {
+		Migration() : done(false) {}
+
+		QFuture<void> future;
+		bool done;
+	};
+
+	void checkMigration();
+	bool oldest(qint64 &atime);
+	bool evictTiles(qint64 atime, qint64 limit);
+	void setSize(qint64 size);
+
+	static void evict();
+	static void migrate(const QString &path);
+
+	QString _dir;
+	QString _connection;
+	QSqlDatabase _db;
+	bool _error;
+
+	QString _lastZoom;
+	QRect _lastRect;
+
+	static qint64 _quota;
+	/* Sizes of the stores (databases) by directory. Multiple stores may use
+	   the same database (map + seed loader), stores that have not been opened
+	   yet are accounted with the database file size. */
+	static QHash<QString, qint64> _sizes;
+	static qint64 _total;
+	static QList<TileStore*> _stores;
+	static QHash<QString, Migration> _migrations;
+};
+
+#endif // TILESTORE_H
@@ -107,6 +107,21 @@ Transform::Transform(double matrix[16])
 		_proj2img = _img2proj.inverted();
 }
 
+/* All the transformations are affine (see the constructors), so the matrix
+   is applied directly without QTransform's per point type dispatching */
+void Transform::proj2img(const PointD *p, QPointF *img, int n) const
+{
+	Q_ASSERT(_proj2img.isAffine());
+
+	double m11 = _proj2img.m11(), m12 = _proj2img.m12();
+	double m21 = _proj2img.m21(), m22 = _proj2img.m22();
+	double dx = _proj2img.dx(), dy = _proj2img.dy();
+
+	for (int i = 0; i < n; i++)
+		img[i] = QPointF(m11 * p[i].x() + m21 * p[i].y() + dx,
+		  m12 * p[i].x() + m22 * p[i].y() + dy);
+}
+
 #ifndef QT_NO_DEBUG
 QDebug operator<<(QDebug dbg, const ReferencePoint &p)
 {
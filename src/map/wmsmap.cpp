@@ -8,12 +8,45 @@
 #include "common/programpaths.h"
 #include "tile.h"
 #include "tileloader.h"
+#include "tileseeder.h"
 #include "wmsmap.h"
 
 
 #define CAPABILITIES_FILE "capabilities.xml"
 #define EPSILON 1e-6
 
+class WMSMap::Seeder : public TileSeeder
+{
+public:
+	Seeder(WMSMap *map, const QList<RectC> &area, const Range &zooms)
+	  : TileSeeder(map->_tileLoader, area, zooms, map), _map(map) {}
+
+protected:
+	QRect tiles(const RectC &rect, int zoom) const
+	{
+		RectC r(rect & _map->_wms->bbox());
+		if (!r.isValid())
+			return QRect();
+
+		RectD pr(r, _map->_wms->projection());
+		Transform t(_map->transform(zoom));
+		QRectF ir(QRectF(t.proj2img(pr.topLeft()),
+		  t.proj2img(pr.bottomRight())).normalized());
+		int ts = _map->_tileSize;
+
+		return QRect(QPoint(qFloor(ir.left() / ts), qFloor(ir.top() / ts)),
+		  QPoint(qFloor(ir.right() / ts), qFloor(ir.bottom() / ts)));
+	}
+	TileLoader::Tile tile(const QPoint &xy, int zoom) const
+	{
+		return TileLoader::Tile(xy, zoom, _map->tileBBox(_map->transform(zoom),
+		  xy));
+	}
+
+private:
+	const WMSMap *_map;
+};
+
 double WMSMap::sd2res(double scaleDenominator) const
 {
 	return scaleDenominator * _wms->projection().units().fromMeters(1.0)
@@ -59,16 +92,33 @@ void WMSMap::computeZooms()
 		_zooms.append(sd.min() + EPSILON);
 }
 
-void WMSMap::updateTransform()
+Transform WMSMap::transform(int zoom) const
 {
-	double pixelSpan = sd2res(_zooms.at(_zoom));
+	double pixelSpan = sd2res(_zooms.at(zoom));
 	if (_wms->projection().isGeographic())
 		pixelSpan /= deg2rad(WGS84_RADIUS);
-	_transform = Transform(ReferencePoint(PointD(0, 0),
+	return Transform(ReferencePoint(PointD(0, 0),
 	  _wms->projection().ll2xy(_wms->bbox().topLeft())),
 	  PointD(pixelSpan, pixelSpan));
 }
 
+void WMSMap::updateTransform()
+{
+	_transform = transform(_zoom);
+}
+
+RectD WMSMap::tileBBox(const Transform &transform, const QPoint &xy) const
+{
+	PointD ttl(transform.img2proj(QPointF(xy.x() * _tileSize,
+	  xy.y() * _tileSize)));
+	PointD tbr(transform.img2proj(QPointF(xy.x() * _tileSize + _tileSize,
+	  xy.y() * _tileSize + _tileSize)));
+
+	return (_wms->cs().axisOrder() == CoordinateSystem::YX)
+	  ? RectD(PointD(tbr.y(), tbr.x()), PointD(ttl.y(), ttl.x()))
+	  : RectD(ttl, tbr);
+}
+
 WMSMap::WMSMap(const QString &fileName, const QString &name,
   const WMS::Setup &setup, int tileSize, QObject *parent)
   : Map(fileName, parent), _name(name), _tileLoader(0), _zoom(0),
@@ -117,6 +167,11 @@ void WMSMap::clearCache()
 	QPixmapCache::clear();
 }
 
+TileSeeder *WMSMap::seeder(const QList<RectC> &area, const Range &zooms)
+{
+	return new Seeder(this, area, zooms);
+}
+
 QRectF WMSMap::bounds()
 {
 	return QRectF(_transform.proj2img(_bounds.topLeft()) / _mapRatio,
@@ -191,15 +246,9 @@ void WMSMap::draw(QPainter *painter, const QRectF &rect, Flags flags)
 	fetchTiles.reserve((br.x() - tl.x()) * (br.y() - tl.y()));
 	for (int i = tl.x(); i < br.x(); i++) {
 		for (int j = tl.y(); j < br.y(); j++) {
-			PointD ttl(_transform.img2proj(QPointF(i * _tileSize,
-			  j * _tileSize)));
-			PointD tbr(_transform.img2proj(QPointF(i * _tileSize + _tileSize,
-			  j * _tileSize + _tileSize)));
-			RectD bbox = (_wms->cs().axisOrder() == CoordinateSystem::YX)
-			  ? RectD(PointD(tbr.y(), tbr.x()), PointD(ttl.y(), ttl.x()))
-			  : RectD(ttl, tbr);
-
-			fetchTiles.append(TileLoader::Tile(QPoint(i, j), _zoom, bbox));
+			QPoint xy(i, j);
+			fetchTiles.append(TileLoader::Tile(xy, _zoom,
+			  tileBBox(_transform, xy)));
 		}
 	}
 
@@ -219,7 +268,8 @@ void WMSMap::draw(QPainter *painter, const QRectF &rect, Flags flags)
 			QPointF tp(t.xy().x() * tileSize(), t.xy().y() * tileSize());
 			drawTile(painter, pm, tp);
 		} else
-			renderTiles.append(FileTile(t.xy(), t.file()));
+			renderTiles.append(FileTile(t.xy(), t.file(), t.store(),
+			  t.zoom().toString()));
 	}
 
 	QFuture<void> future = QtConcurrent::map(renderTiles, &FileTile::load);
@@ -41,13 +41,21 @@ public:
 	bool isValid() const {return _wms->isValid();}
 	QString errorString() const {return _wms->errorString();}
 
+	bool canSeed() const {return _wms->isReady() && _wms->isValid();}
+	Range seedZooms() const {return Range(0, _zooms.size() - 1);}
+	TileSeeder *seeder(const QList<RectC> &area, const Range &zooms);
+
 private slots:
 	void wmsReady();
 
 private:
+	class Seeder;
+
 	QString tileUrl() const;
 	double sd2res(double scaleDenominator) const;
 	void computeZooms();
+	Transform transform(int zoom) const;
+	RectD tileBBox(const Transform &transform, const QPoint &xy) const;
 	void updateTransform();
 	qreal tileSize() const;
 	void init();
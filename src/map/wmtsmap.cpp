@@ -8,12 +8,53 @@
 #include "common/programpaths.h"
 #include "transform.h"
 #include "tileloader.h"
+#include "tileseeder.h"
 #include "tile.h"
 #include "wmts.h"
 #include "wmtsmap.h"
 
 
 #define CAPABILITIES_FILE "capabilities.xml"
+/* Max zoom levels distance of the parent tiles used as placeholders */
+#define MAX_PLACEHOLDER_LEVELS 4
+
+class WMTSMap::Seeder : public TileSeeder
+{
+public:
+	Seeder(WMTSMap *map, const QList<RectC> &area, const Range &zooms)
+	  : TileSeeder(map->_tileLoader, area, zooms, map), _map(map) {}
+
+protected:
+	QRect tiles(const RectC &rect, int zoom) const
+	{
+		const WMTS::Zoom &z = _map->_wmts->zooms().at(zoom);
+		RectC r(_map->_wmts->bbox().isValid()
+		  ? rect & _map->_wmts->bbox() : rect);
+		if (!r.isValid())
+			return QRect();
+
+		RectD pr(r, _map->_wmts->projection());
+		Transform t(_map->transform(zoom));
+		QRectF ir(QRectF(t.proj2img(pr.topLeft()),
+		  t.proj2img(pr.bottomRight())).normalized());
+		QRectF tb(_map->tileBounds(zoom));
+		int w = z.tile().width(), h = z.tile().height();
+
+		QRect tr(QPoint(qFloor(ir.left() / w), qFloor(ir.top() / h)),
+		  QPoint(qFloor(ir.right() / w), qFloor(ir.bottom() / h)));
+		QRect lr(QPoint(qRound(tb.left() / w), qRound(tb.top() / h)),
+		  QSize(qRound(tb.width() / w), qRound(tb.height() / h)));
+
+		return tr & lr;
+	}
+	TileLoader::Tile tile(const QPoint &xy, int zoom) const
+	{
+		return TileLoader::Tile(xy, _map->_wmts->zooms().at(zoom).id());
+	}
+
+private:
+	const WMTSMap *_map;
+};
 
 WMTSMap::WMTSMap(const QString &fileName, const QString &name,
   const WMTS::Setup &setup, qreal tileRatio,
@@ -62,6 +103,11 @@ void WMTSMap::clearCache()
 	QPixmapCache::clear();
 }
 
+TileSeeder *WMTSMap::seeder(const QList<RectC> &area, const Range &zooms)
+{
+	return new Seeder(this, area, zooms);
+}
+
 double WMTSMap::sd2res(double scaleDenominator) const
 {
 	return scaleDenominator * 0.28e-3
@@ -207,15 +253,20 @@ void WMTSMap::draw(QPainter *painter, const QRectF &rect, Flags flags)
 	QList<FileTile> renderTiles;
 	for (int i = 0; i < fetchTiles.count(); i++) {
 		const TileLoader::Tile &t = fetchTiles.at(i);
-		if (t.file().isNull())
+		if (t.file().isNull()) {
+			if (!(flags & Map::Block))
+				drawPlaceholder(painter, QRectF(QPointF(t.xy().x() * ts.width(),
+				  t.xy().y() * ts.height()), ts));
 			continue;
+		}
 
 		QPixmap pm;
 		if (QPixmapCache::find(t.file(), &pm)) {
 			QPointF tp(t.xy().x() * ts.width(), t.xy().y() * ts.height());
 			drawTile(painter, pm, tp);
 		} else
-			renderTiles.append(FileTile(t.xy(), t.file()));
+			renderTiles.append(FileTile(t.xy(), t.file(), t.store(),
+			  t.zoom().toString()));
 	}
 
 	QFuture<void> future = QtConcurrent::map(renderTiles, &FileTile::load);
@@ -240,6 +291,74 @@ void WMTSMap::drawTile(QPainter *painter, QPixmap &pixmap, QPointF &tp)
 	painter->drawPixmap(tp, pixmap);
 }
 
+/* Draws the cached tiles of the zoom level covering rect (in the current zoom
+   level map coordinates). The tile matrices of the zoom levels are not
+   required to be aligned, so the rect is mapped to the zoom level image
+   coordinates using the projection coordinates. Returns false if some of the
+   tiles are not cached, in that case nothing is drawn unless partial is set. */
+bool WMTSMap::drawPlaceholder(QPainter *painter, const QRectF &rect,
+  int zoom, bool partial) const
+{
+	const WMTS::Zoom &z = _wmts->zooms().at(zoom);
+	Transform t(transform(zoom));
+	QRectF pr(t.proj2img(_transform.img2proj(rect.topLeft()
+	  * coordinatesRatio())), t.proj2img(_transform.img2proj(
+	  rect.bottomRight() * coordinatesRatio())));
+	if (!pr.isValid())
+		return false;
+
+	QPoint tl(qFloor(pr.left() / z.tile().width()),
+	  qFloor(pr.top() / z.tile().height()));
+	QPoint br(qCeil(pr.right() / z.tile().width()),
+	  qCeil(pr.bottom() / z.tile().height()));
+	QList<QPair<QRectF, QPixmap> > tiles;
+
+	for (int i = tl.x(); i < br.x(); i++) {
+		for (int j = tl.y(); j < br.y(); j++) {
+			QPixmap pm;
+			TileLoader::Tile tile(QPoint(i, j), z.id());
+			if (QPixmapCache::find(_tileLoader->tileKey(tile), &pm))
+				tiles.append(QPair<QRectF, QPixmap>(QRectF(QPointF(i
+				  * z.tile().width(), j * z.tile().height()), z.tile()), pm));
+			else if (!partial)
+				return false;
+		}
+	}
+
+	qreal sx = rect.width() / pr.width();
+	qreal sy = rect.height() / pr.height();
+	for (int i = 0; i < tiles.size(); i++) {
+		const QRectF &tr = tiles.at(i).first;
+		const QPixmap &pm = tiles.at(i).second;
+		QRectF ir(tr.intersected(pr));
+		qreal px = pm.width() / tr.width();
+		qreal py = pm.height() / tr.height();
+
+		QRectF source(QPointF((ir.left() - tr.left()) * px,
+		  (ir.top() - tr.top()) * py), QSizeF(ir.width() * px,
+		  ir.height() * py));
+		QRectF target(QPointF(rect.left() + (ir.left() - pr.left()) * sx,
+		  rect.top() + (ir.top() - pr.top()) * sy), QSizeF(ir.width() * sx,
+		  ir.height() * sy));
+		painter->drawPixmap(target, pm, source);
+	}
+
+	return !tiles.isEmpty();
+}
+
+/* Tiles that are not yet downloaded are replaced with scaled cached tiles of
+   the nearest lower zoom level fully covering the tile or whatever tiles of
+   the next higher zoom level are cached. */
+void WMTSMap::drawPlaceholder(QPainter *painter, const QRectF &rect) const
+{
+	for (int z = _zoom - 1; z >= qMax(0, _zoom - MAX_PLACEHOLDER_LEVELS); z--)
+		if (drawPlaceholder(painter, rect, z, false))
+			return;
+
+	if (_zoom + 1 < _wmts->zooms().size())
+		drawPlaceholder(painter, rect, _zoom + 1, true);
+}
+
 QPointF WMTSMap::ll2xy(const Coordinates &c)
 {
 	return _transform.proj2img(_wmts->projection().ll2xy(c))
@@ -41,10 +41,16 @@ public:
 	bool isValid() const {return _wmts->isValid();}
 	QString errorString() const {return _wmts->errorString();}
 
+	bool canSeed() const {return _wmts->isReady() && _wmts->isValid();}
+	Range seedZooms() const {return Range(0, _wmts->zooms().size() - 1);}
+	TileSeeder *seeder(const QList<RectC> &area, const Range &zooms);
+
 private slots:
 	void wmtsReady();
 
 private:
+	class Seeder;
+
 	double sd2res(double scaleDenominator) const;
 	Transform transform(int zoom) const;
 	QRectF tileBounds(int zoom) const;
@@ -54,6 +60,9 @@ private:
 	qreal imageRatio() const;
 	void init();
 	void drawTile(QPainter *painter, QPixmap &pixmap, QPointF &tp);
+	bool drawPlaceholder(QPainter *painter, const QRectF &rect, int zoom,
+	  bool partial) const;
+	void drawPlaceholder(QPainter *painter, const QRectF &rect) const;
 
 	QString _name;
 	WMTS *_wmts;
@@ -0,0 +1,5 @@
+TARGET = tst_corridor
+
+include(../tests.pri)
+
+SOURCES += tst_corridor.cpp
@@ -0,0 +1,181 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QRandomGenerator>
+#include "common/greatcircle.h"
+#include "data/poiindex.h"
+#include "data/corridor.h"
+#include "data/path.h"
+
+#define POIS   500000 /* A national OSM POI extract */
+#define POINTS 10000  /* Path points, ~100m apart */
+#define RADIUS 1000   /* The POI::radius() default */
+
+/* Random POIs over a Germany sized area */
+static QVector<Waypoint> pois()
+{
+	QRandomGenerator rnd(1);
+	QVector<Waypoint> v;
+	v.reserve(POIS);
+
+	for (int i = 0; i < POIS; i++) {
+		Waypoint w(Coordinates(6.0 + rnd.generateDouble() * 9.0,
+		  47.5 + rnd.generateDouble() * 7.5));
+		w.setName(QString("POI %1").arg(i));
+		v.append(w);
+	}
+
+	return v;
+}
+
+/* A ~1000km long wiggly route across the area */
+static Path path()
+{
+	GreatCircle gc(Coordinates(6.5, 47.8), Coordinates(14.5, 54.5));
+	PathSegment segment;
+	qreal distance = 0;
+
+	for (int i = 0; i < POINTS; i++) {
+		Coordinates c(gc.pointAt((double)i / (POINTS - 1)));
+		Coordinates p(c.lon() + 0.05 * sin(i * 0.01), c.lat());
+		if (i)
+			distance += p.distanceTo(segment.last().coordinates());
+		segment.append(PathPoint(p, distance));
+	}
+
+	Path path;
+	path.append(segment);
+	return path;
+}
+
+static void search(const POIIndex &index, const RectC &rect,
+  QSet<quint32> &set)
+{
+	double min[2], max[2];
+
+	min[0] = rect.left();
+	min[1] = rect.bottom();
+	max[0] = rect.right();
+	max[1] = rect.top();
+	index.search(min, max, set);
+}
+
+/* The previous POI::points(const Path&) implementation, an index search for
+   every segment (and every radius-long sample of long segments) merged in a
+   set */
+static QSet<quint32> rects(const POIIndex &index, const Path &path)
+{
+	QSet<quint32> set;
+
+	for (int i = 0; i < path.count(); i++) {
+		const PathSegment &segment = path.at(i);
+
+		for (int j = 1; j < segment.size(); j++) {
+			double ds = segment.at(j).distance() - segment.at(j-1).distance();
+			unsigned n = (unsigned)ceil(ds / RADIUS);
+
+			if (n > 1) {
+				GreatCircle gc(segment.at(j-1).coordinates(),
+				  segment.at(j).coordinates());
+				for (unsigned k = 0; k < n; k++)
+					search(index, RectC(gc.pointAt((double)k/n), RADIUS), set);
+			} else
+				search(index, RectC(segment.at(j-1).coordinates(), RADIUS),
+				  set);
+		}
+	}
+	search(index, RectC(path.last().last().coordinates(), RADIUS), set);
+
+	return set;
+}
+
+static QVector<quint32> corridor(const POIIndex &index, const Path &path)
+{
+	QVector<quint32> ids;
+	Corridor corridor(path, RADIUS);
+
+	index.search(corridor, ids);
+
+	return ids;
+}
+
+/* The POIs along a path query, the single corridor index traversal compared
+   to the per-segment rect searches it replaced */
+class tst_Corridor : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+
+	void rects();
+	void corridor();
+	void results();
+
+private:
+	QTemporaryDir _dir;
+	POIIndex _index;
+	Path _path;
+};
+
+void tst_Corridor::initTestCase()
+{
+	QVERIFY(_dir.isValid());
+
+	/* The index is bound to the source file size/mtime only */
+	QFile source(_dir.filePath("pois.gpx"));
+	QVERIFY(source.open(QIODevice::WriteOnly));
+	source.close();
+
+	QVERIFY(_index.create(_dir.filePath("pois.idx"), QFileInfo(source),
+	  pois()));
+	QCOMPARE(_index.count(), (quint32)POIS);
+
+	_path = path();
+}
+
+void tst_Corridor::rects()
+{
+	int count = 0;
+
+	QBENCHMARK {
+		count = ::rects(_index, _path).size();
+	}
+
+	QVERIFY(count > 0);
+}
+
+/* Including the corridor construction */
+void tst_Corridor::corridor()
+{
+	int count = 0;
+
+	QBENCHMARK {
+		count = ::corridor(_index, _path).size();
+	}
+
+	QVERIFY(count > 0);
+}
+
+/* The corridor is the exact area within the radius, the rects cover it
+   (plus their corners) up to the sample spacing effects on the corridor
+   border */
+void tst_Corridor::results()
+{
+	QSet<quint32> set(::rects(_index, _path));
+	QVector<quint32> ids(::corridor(_index, _path));
+	QSet<quint32> unique;
+	int missing = 0;
+
+	for (int i = 0; i < ids.size(); i++) {
+		if (!set.contains(ids.at(i)))
+			missing++;
+		unique.insert(ids.at(i));
+	}
+
+	QCOMPARE(unique.size(), ids.size());
+	QVERIFY(missing * 1000 <= ids.size());
+	QVERIFY(ids.size() > set.size() / 2);
+}
+
+QTEST_GUILESS_MAIN(tst_Corridor)
+#include "tst_corridor.moc"
@@ -0,0 +1,5 @@
+TARGET = tst_data
+
+include(../tests.pri)
+
+SOURCES += tst_data.cpp
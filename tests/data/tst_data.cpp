@@ -0,0 +1,144 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QTimeZone>
+#include "data/data.h"
+
+#define POINTS 100000
+
+static Trackpoint trackpoint(int i)
+{
+	static const QDateTime start(QDate(2020, 6, 1), QTime(8, 0),
+	  QTimeZone::utc());
+
+	/* A wiggly track heading north-east, ~10m between the points */
+	Trackpoint t(Coordinates(14.0 + i * 0.0001 + 0.0005 * sin(i * 0.01),
+	  50.0 + i * 0.00005 + 0.0005 * cos(i * 0.013)));
+	t.setElevation(300 + 50 * sin(i * 0.001));
+	t.setTimestamp(start.addSecs(i));
+
+	return t;
+}
+
+static QString timestamp(const Trackpoint &t)
+{
+	return t.timestamp().toString(Qt::ISODate);
+}
+
+static void writeGPX(QTextStream &s)
+{
+	s << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+	  << "<gpx version=\"1.1\" creator=\"tst_data\" "
+	  "xmlns=\"http://www.topografix.com/GPX/1/1\">\n<trk>\n<trkseg>\n";
+	for (int i = 0; i < POINTS; i++) {
+		Trackpoint t(trackpoint(i));
+		s << "<trkpt lat=\"" << QString::number(t.coordinates().lat(), 'f', 7)
+		  << "\" lon=\"" << QString::number(t.coordinates().lon(), 'f', 7)
+		  << "\"><ele>" << QString::number(t.elevation(), 'f', 1)
+		  << "</ele><time>" << timestamp(t) << "</time></trkpt>\n";
+	}
+	s << "</trkseg>\n</trk>\n</gpx>\n";
+}
+
+static void writeTCX(QTextStream &s)
+{
+	s << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+	  << "<TrainingCenterDatabase xmlns=\"http://www.garmin.com/xmlschemas/"
+	  "TrainingCenterDatabase/v2\">\n<Activities>\n<Activity Sport=\"Biking\">\n"
+	  << "<Id>" << timestamp(trackpoint(0)) << "</Id>\n<Lap StartTime=\""
+	  << timestamp(trackpoint(0)) << "\">\n<Track>\n";
+	for (int i = 0; i < POINTS; i++) {
+		Trackpoint t(trackpoint(i));
+		s << "<Trackpoint><Time>" << timestamp(t) << "</Time><Position>"
+		  << "<LatitudeDegrees>" << QString::number(t.coordinates().lat(), 'f', 7)
+		  << "</LatitudeDegrees><LongitudeDegrees>"
+		  << QString::number(t.coordinates().lon(), 'f', 7)
+		  << "</LongitudeDegrees></Position><AltitudeMeters>"
+		  << QString::number(t.elevation(), 'f', 1)
+		  << "</AltitudeMeters></Trackpoint>\n";
+	}
+	s << "</Track>\n</Lap>\n</Activity>\n</Activities>\n"
+	  "</TrainingCenterDatabase>\n";
+}
+
+static void writeKML(QTextStream &s)
+{
+	s << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+	  << "<kml xmlns=\"http://www.opengis.net/kml/2.2\">\n<Document>\n"
+	  "<Placemark>\n<LineString>\n<coordinates>\n";
+	for (int i = 0; i < POINTS; i++) {
+		Trackpoint t(trackpoint(i));
+		s << QString::number(t.coordinates().lon(), 'f', 7) << ","
+		  << QString::number(t.coordinates().lat(), 'f', 7) << ","
+		  << QString::number(t.elevation(), 'f', 1) << "\n";
+	}
+	s << "</coordinates>\n</LineString>\n</Placemark>\n</Document>\n</kml>\n";
+}
+
+class tst_Data : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+
+	void parse_data();
+	void parse();
+	void track();
+
+private:
+	QTemporaryDir _dir;
+};
+
+void tst_Data::initTestCase()
+{
+	QVERIFY(_dir.isValid());
+
+	struct {const char *ext; void (*write)(QTextStream &);} fixtures[] = {
+		{"gpx", writeGPX}, {"tcx", writeTCX}, {"kml", writeKML}
+	};
+
+	for (size_t i = 0; i < sizeof(fixtures) / sizeof(fixtures[0]); i++) {
+		QFile file(_dir.filePath(QString("track.") + fixtures[i].ext));
+		QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+		QTextStream s(&file);
+		fixtures[i].write(s);
+	}
+}
+
+void tst_Data::parse_data()
+{
+	QTest::addColumn<QString>("file");
+
+	QTest::newRow("GPX") << _dir.filePath("track.gpx");
+	QTest::newRow("TCX") << _dir.filePath("track.tcx");
+	QTest::newRow("KML") << _dir.filePath("track.kml");
+}
+
+/* Parsing including the Track/Route construction, i.e. the file open cost */
+void tst_Data::parse()
+{
+	QFETCH(QString, file);
+
+	QBENCHMARK {
+		Data data(file);
+		QVERIFY(data.isValid());
+		QCOMPARE(data.tracks().size(), 1);
+	}
+}
+
+void tst_Data::track()
+{
+	SegmentData segment;
+	segment.reserve(POINTS);
+	for (int i = 0; i < POINTS; i++)
+		segment.append(trackpoint(i));
+	TrackData data(segment);
+
+	QBENCHMARK {
+		Track track(data);
+		QVERIFY(track.distance() > 0);
+	}
+}
+
+QTEST_MAIN(tst_Data)
+#include "tst_data.moc"
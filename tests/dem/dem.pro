@@ -0,0 +1,5 @@
+TARGET = tst_dem
+
+include(../tests.pri)
+
+SOURCES += tst_dem.cpp
@@ -0,0 +1,104 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include "common/rectc.h"
+#include "map/dem.h"
+#include "map/hillshading.h"
+
+#define SAMPLES 1201 /* SRTM3 */
+#define SIZE    512  /* The rendered area size in pixels */
+#define EXTEND  1
+
+static bool writeTile(const QString &path, int lon, int lat)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+
+	QByteArray data(SAMPLES * SAMPLES * 2, 0);
+	qint16 *ptr = (qint16*)data.data();
+
+	/* Some synthetic hills continuous over the tile borders */
+	for (int row = 0; row < SAMPLES; row++) {
+		for (int col = 0; col < SAMPLES; col++) {
+			double x = (lon + col / (double)(SAMPLES - 1)) * 200;
+			double y = (lat + 1 - row / (double)(SAMPLES - 1)) * 200;
+			qint16 val = 500 + 300 * sin(x / 7.0) * cos(y / 11.0);
+			*ptr++ = qToBigEndian(val);
+		}
+	}
+
+	return (file.write(data) == data.size());
+}
+
+static MatrixC grid(const RectC &rect, int size)
+{
+	MatrixC m(size, size);
+	double dx = (rect.right() - rect.left()) / (size - 1);
+	double dy = (rect.top() - rect.bottom()) / (size - 1);
+
+	for (int i = 0; i < size; i++)
+		for (int j = 0; j < size; j++)
+			m.at(i, j) = Coordinates(rect.left() + j * dx, rect.top() - i * dy);
+
+	return m;
+}
+
+class tst_DEM : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+
+	void elevation();
+	void hillShading();
+
+private:
+	QTemporaryDir _dir;
+	MatrixC _grid;
+};
+
+void tst_DEM::initTestCase()
+{
+	QVERIFY(_dir.isValid());
+	QVERIFY(writeTile(_dir.filePath("N50E014.hgt"), 14, 50));
+	QVERIFY(writeTile(_dir.filePath("N50E015.hgt"), 15, 50));
+
+	DEM::setDir(_dir.path());
+	DEM::setCacheSize(64 * 1024);
+
+	/* The area spans both tiles */
+	_grid = grid(RectC(Coordinates(14.6, 50.8), Coordinates(15.4, 50.2)),
+	  SIZE + 2 * EXTEND);
+}
+
+void tst_DEM::cleanupTestCase()
+{
+	DEM::clearCache();
+	DEM::setDir(QString());
+}
+
+/* The tiles are loaded on the first run, the following runs measure the
+   cached lookup + interpolation */
+void tst_DEM::elevation()
+{
+	QBENCHMARK {
+		MatrixD m(DEM::elevation(_grid));
+		QVERIFY(!std::isnan(m.at(0)));
+	}
+}
+
+void tst_DEM::hillShading()
+{
+	MatrixD m(DEM::elevation(_grid));
+
+	QBENCHMARK {
+		QImage img(HillShading::render(m, EXTEND));
+		QCOMPARE(img.size(), QSize(SIZE, SIZE));
+	}
+}
+
+QTEST_MAIN(tst_DEM)
+#include "tst_dem.moc"
@@ -0,0 +1,5 @@
+TARGET = tst_downloader
+
+include(../tests.pri)
+
+SOURCES += tst_downloader.cpp
@@ -0,0 +1,294 @@
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QNetworkAccessManager>
+#include <QNetworkProxy>
+#include "map/downloader.h"
+
+#define HOST_CONNECTIONS 6
+#define DOWNLOADS        10
+
+/* Minimal local HTTP server. Every request is answered with its path on a
+   connection of its own, in the hold mode the responses are postponed until
+   release() so that the downloads stay running as long as needed. */
+class Server : public QObject
+{
+	Q_OBJECT
+
+public:
+	Server() : _hold(false)
+	{
+		connect(&_server, &QTcpServer::newConnection, this,
+		  &Server::newConnection);
+	}
+
+	bool listen() {return _server.listen(QHostAddress::LocalHost);}
+	QUrl url(const QString &path) const
+	{
+		return QUrl(QString("http://127.0.0.1:%1/%2").arg(_server.serverPort())
+		  .arg(path));
+	}
+
+	void setHold(bool hold) {_hold = hold;}
+	void release(int count = -1);
+	void clear() {_requests.clear();}
+
+	const QStringList &requests() const {return _requests;}
+	int pending() const {return _pending.size();}
+
+private slots:
+	void newConnection();
+	void readRequest();
+
+private:
+	void respond(QTcpSocket *socket, const QByteArray &path);
+
+	QTcpServer _server;
+	QHash<QTcpSocket*, QByteArray> _buffers;
+	QList<QPair<QTcpSocket*, QByteArray> > _pending;
+	QStringList _requests;
+	bool _hold;
+};
+
+void Server::newConnection()
+{
+	while (_server.hasPendingConnections()) {
+		QTcpSocket *socket = _server.nextPendingConnection();
+		connect(socket, &QIODevice::readyRead, this, &Server::readRequest);
+		connect(socket, &QAbstractSocket::disconnected, socket,
+		  &QObject::deleteLater);
+	}
+}
+
+void Server::readRequest()
+{
+	QTcpSocket *socket = static_cast<QTcpSocket*>(sender());
+	QByteArray &buffer = _buffers[socket];
+
+	buffer += socket->readAll();
+	if (!buffer.contains("\r\n\r\n"))
+		return;
+
+	QList<QByteArray> line(buffer.left(buffer.indexOf("\r\n")).split(' '));
+	QByteArray path(line.size() > 1 ? line.at(1).mid(1) : QByteArray());
+	_buffers.remove(socket);
+	_requests.append(QString::fromLatin1(path));
+
+	if (_hold)
+		_pending.append(qMakePair(socket, path));
+	else
+		respond(socket, path);
+}
+
+void Server::respond(QTcpSocket *socket, const QByteArray &path)
+{
+	socket->write("HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\n"
+	  "Content-Length: " + QByteArray::number(path.size())
+	  + "\r\nConnection: close\r\n\r\n" + path);
+	socket->disconnectFromHost();
+}
+
+void Server::release(int count)
+{
+	for (int i = 0; !_pending.isEmpty() && (count < 0 || i < count); i++) {
+		QPair<QTcpSocket*, QByteArray> p(_pending.takeFirst());
+		respond(p.first, p.second);
+	}
+}
+
+static unsigned latencies()
+{
+	QVector<unsigned> histogram(Downloader::latencyHistogram());
+	unsigned sum = 0;
+
+	for (int i = 0; i < histogram.size(); i++)
+		sum += histogram.at(i);
+
+	return sum;
+}
+
+/* The shared download queue scheduling: the per-host connections limit, the
+   get() recency and priority order, cancel() and the coalescing of repeated
+   requests. */
+class tst_Downloader : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+	void init();
+	void cleanup();
+
+	void hostLimit();
+	void priority();
+	void cancel();
+	void coalescing();
+
+private:
+	QList<Download> downloads(const QString &prefix, int count,
+	  bool reverse = false) const;
+	QStringList paths(const QString &prefix, int first, int count) const;
+
+	Server _server;
+	QNetworkAccessManager _manager;
+};
+
+QList<Download> tst_Downloader::downloads(const QString &prefix, int count,
+  bool reverse) const
+{
+	QList<Download> list;
+
+	for (int i = 0; i < count; i++) {
+		int priority = reverse ? count - 1 - i : i;
+		list.append(Download(_server.url(prefix + QString::number(priority)),
+		  QString(), priority));
+	}
+
+	return list;
+}
+
+QStringList tst_Downloader::paths(const QString &prefix, int first,
+  int count) const
+{
+	QStringList list;
+
+	for (int i = first; i < first + count; i++)
+		list.append(prefix + QString::number(i));
+
+	return list;
+}
+
+void tst_Downloader::initTestCase()
+{
+	QVERIFY(_server.listen());
+
+	_manager.setProxy(QNetworkProxy::NoProxy);
+	Downloader::setNetworkManager(&_manager);
+	/* Plain HTTP/1.1, one connection per running download */
+	Downloader::enableHTTP2(false);
+}
+
+void tst_Downloader::init()
+{
+	_server.clear();
+	_server.setHold(true);
+}
+
+/* Every test must leave the shared queue empty */
+void tst_Downloader::cleanup()
+{
+	_server.setHold(false);
+	_server.release();
+
+	QTRY_COMPARE(Downloader::runningDownloads(), 0);
+	QCOMPARE(Downloader::queueDepth(), 0);
+}
+
+void tst_Downloader::hostLimit()
+{
+	Downloader dl;
+	QSignalSpy finished(&dl, &Downloader::finished);
+	QSignalSpy downloaded(&dl, &Downloader::downloaded);
+	unsigned before = latencies();
+
+	QVERIFY(dl.get(downloads("h", DOWNLOADS), QList<HTTPHeader>()));
+	QTRY_COMPARE(_server.requests().size(), HOST_CONNECTIONS);
+	QCOMPARE(Downloader::runningDownloads(), HOST_CONNECTIONS);
+	QCOMPARE(Downloader::queueDepth(), DOWNLOADS - HOST_CONNECTIONS);
+
+	/* No more requests until a running download finishes */
+	QTest::qWait(100);
+	QCOMPARE(_server.requests().size(), HOST_CONNECTIONS);
+	_server.release(1);
+	QTRY_COMPARE(_server.requests().size(), HOST_CONNECTIONS + 1);
+	QCOMPARE(Downloader::runningDownloads(), HOST_CONNECTIONS);
+
+	_server.setHold(false);
+	_server.release();
+	QTRY_COMPARE(finished.count(), 1);
+	QCOMPARE(downloaded.count(), DOWNLOADS);
+	QCOMPARE(latencies(), before + DOWNLOADS);
+}
+
+void tst_Downloader::priority()
+{
+	Downloader dl;
+	QSignalSpy finished(&dl, &Downloader::finished);
+
+	/* Lower value means higher priority */
+	QVERIFY(dl.get(downloads("p", DOWNLOADS, true), QList<HTTPHeader>()));
+	QTRY_COMPARE(_server.requests().size(), HOST_CONNECTIONS);
+	QStringList started(_server.requests());
+	started.sort();
+	QCOMPARE(started, paths("p", 0, HOST_CONNECTIONS));
+
+	/* A later get() takes precedence regardless of the priority */
+	QVERIFY(dl.get(QList<Download>() << Download(_server.url("n"), QString(),
+	  DOWNLOADS), QList<HTTPHeader>()));
+	_server.release(1);
+	QTRY_COMPARE(_server.requests().size(), HOST_CONNECTIONS + 1);
+	QCOMPARE(_server.requests().last(), QString("n"));
+	_server.release(1);
+	QTRY_COMPARE(_server.requests().size(), HOST_CONNECTIONS + 2);
+	QCOMPARE(_server.requests().last(), QString("p%1").arg(HOST_CONNECTIONS));
+
+	_server.setHold(false);
+	_server.release();
+	QTRY_COMPARE(finished.count(), 1);
+	QCOMPARE(_server.requests().size(), DOWNLOADS + 1);
+}
+
+void tst_Downloader::cancel()
+{
+	Downloader dl;
+	QSignalSpy finished(&dl, &Downloader::finished);
+	QSignalSpy downloaded(&dl, &Downloader::downloaded);
+
+	QVERIFY(dl.get(downloads("c", DOWNLOADS), QList<HTTPHeader>()));
+	QTRY_COMPARE(_server.requests().size(), HOST_CONNECTIONS);
+
+	/* Only the queued downloads are dropped, the running ones finish */
+	dl.cancel();
+	QCOMPARE(Downloader::queueDepth(), 0);
+	QCOMPARE(Downloader::runningDownloads(), HOST_CONNECTIONS);
+
+	_server.setHold(false);
+	_server.release();
+	QTRY_COMPARE(finished.count(), 1);
+	QCOMPARE(downloaded.count(), HOST_CONNECTIONS);
+	QTest::qWait(100);
+	QCOMPARE(_server.requests().size(), HOST_CONNECTIONS);
+}
+
+void tst_Downloader::coalescing()
+{
+	Downloader dl;
+	QSignalSpy finished(&dl, &Downloader::finished);
+	QSignalSpy downloaded(&dl, &Downloader::downloaded);
+	QString last(QString("r%1").arg(DOWNLOADS - 1));
+
+	QVERIFY(dl.get(downloads("r", DOWNLOADS), QList<HTTPHeader>()));
+	QTRY_COMPARE(_server.requests().size(), HOST_CONNECTIONS);
+
+	/* A repeated queued download is not queued twice but gets the new
+	   request precedence, a repeated running download is ignored */
+	QVERIFY(dl.get(QList<Download>() << Download(_server.url(last), QString(),
+	  0), QList<HTTPHeader>()));
+	QCOMPARE(Downloader::queueDepth(), DOWNLOADS - HOST_CONNECTIONS);
+	QVERIFY(!dl.get(QList<Download>() << Download(_server.url("r0"), QString(),
+	  0), QList<HTTPHeader>()));
+	QCOMPARE(Downloader::queueDepth(), DOWNLOADS - HOST_CONNECTIONS);
+
+	_server.release(1);
+	QTRY_COMPARE(_server.requests().size(), HOST_CONNECTIONS + 1);
+	QCOMPARE(_server.requests().last(), last);
+
+	_server.setHold(false);
+	_server.release();
+	QTRY_COMPARE(finished.count(), 1);
+	QCOMPARE(downloaded.count(), DOWNLOADS);
+	QCOMPARE(_server.requests().count(last), 1);
+}
+
+QTEST_GUILESS_MAIN(tst_Downloader)
+#include "tst_downloader.moc"
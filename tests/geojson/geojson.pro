@@ -0,0 +1,5 @@
+TARGET = tst_geojson
+
+include(../tests.pri)
+
+SOURCES += tst_geojson.cpp
@@ -0,0 +1,155 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include "data/geojsonparser.h"
+
+#define LINES  10000
+#define POINTS 100   /* Per line */
+#define PLACES 10000
+
+enum Mode {DOM, Stream};
+Q_DECLARE_METATYPE(Mode)
+
+static bool writeCollection(const QString &path)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+		return false;
+	QTextStream s(&file);
+
+	s << "{\"type\": \"FeatureCollection\", \"features\": [\n";
+	for (int i = 0; i < LINES; i++) {
+		s << "{\"type\": \"Feature\", \"properties\": {\"name\": \"Line " << i
+		  << "\"}, \"geometry\": {\"type\": \"LineString\", \"coordinates\": [";
+		for (int j = 0; j < POINTS; j++) {
+			if (j)
+				s << ",";
+			s << "[" << QString::number(14.0 + i * 0.0001 + j * 0.00001, 'f', 6)
+			  << "," << QString::number(50.0 + j * 0.00001, 'f', 6) << ","
+			  << 300 + j << "]";
+		}
+		s << "]}},\n";
+	}
+	for (int i = 0; i < PLACES; i++) {
+		if (i)
+			s << ",\n";
+		s << "{\"type\": \"Feature\", \"properties\": {\"name\": \"Place " << i
+		  << "\", \"description\": \"A place\"}, \"geometry\": {\"type\": "
+		  "\"Point\", \"coordinates\": ["
+		  << QString::number(14.0 + i * 0.0001, 'f', 6) << ",50.5]}}";
+	}
+	s << "\n]}\n";
+	s.flush();
+
+	return (s.status() == QTextStream::Ok);
+}
+
+/* The DOM mode is just the QJsonDocument::fromJson(file->readAll()) part of
+   the previous parser, the GeoJSON to TrackData/Waypoint conversion is the
+   same in both parsers. The DOM numbers are thus a lower bound of the
+   previous parser cost. */
+static bool parse(Mode mode, const QString &path)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	if (mode == DOM) {
+		QJsonParseError error;
+		QJsonDocument doc(QJsonDocument::fromJson(file.readAll(), &error));
+		return !doc.isNull();
+	} else {
+		GeoJSONParser parser;
+		QList<TrackData> tracks;
+		QList<RouteData> routes;
+		QList<Area> areas;
+		QVector<Waypoint> waypoints;
+
+		return (parser.parse(&file, tracks, routes, areas, waypoints)
+		  && tracks.size() == LINES && waypoints.size() == PLACES);
+	}
+}
+
+/* Peak RSS (Linux only), the high water mark is reset by writing 5 to
+   /proc/self/clear_refs */
+static qint64 status(const QByteArray &key)
+{
+	QFile file("/proc/self/status");
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+		return -1;
+
+	QList<QByteArray> lines(file.readAll().split('\n'));
+	for (int i = 0; i < lines.size(); i++) {
+		if (lines.at(i).startsWith(key + ":")) {
+			QList<QByteArray> fields(lines.at(i).simplified().split(' '));
+			return (fields.size() > 1) ? fields.at(1).toLongLong() * 1024 : -1;
+		}
+	}
+
+	return -1;
+}
+
+static bool resetPeak()
+{
+	QFile file("/proc/self/clear_refs");
+	return (file.open(QIODevice::WriteOnly) && file.write("5") == 1);
+}
+
+class tst_GeoJSON : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+
+	void modes_data();
+	void parse_data() {modes_data();}
+	void parse();
+	void memory_data() {modes_data();}
+	void memory();
+
+private:
+	QTemporaryDir _dir;
+	QString _path;
+};
+
+void tst_GeoJSON::initTestCase()
+{
+	QVERIFY(_dir.isValid());
+	_path = _dir.filePath("collection.geojson");
+	QVERIFY(writeCollection(_path));
+}
+
+void tst_GeoJSON::modes_data()
+{
+	QTest::addColumn<Mode>("mode");
+
+	QTest::newRow("DOM") << DOM;
+	QTest::newRow("stream") << Stream;
+}
+
+void tst_GeoJSON::parse()
+{
+	QFETCH(Mode, mode);
+
+	QBENCHMARK {
+		QVERIFY(::parse(mode, _path));
+	}
+}
+
+void tst_GeoJSON::memory()
+{
+	QFETCH(Mode, mode);
+
+	if (!resetPeak())
+		QSKIP("peak RSS statistics not available");
+	qint64 base = status("VmRSS");
+	QVERIFY(::parse(mode, _path));
+	qint64 peak = status("VmHWM");
+	QVERIFY(base > 0 && peak > 0);
+
+	QTest::setBenchmarkResult(peak - base, QTest::BytesAllocated);
+}
+
+QTEST_MAIN(tst_GeoJSON)
+#include "tst_geojson.moc"
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <QtTest>
+#include <QRandomGenerator>
+#include "common/haversine.h"
+#include "data/trackdata.h"
+
+#define POINTS 100000
+
+static SegmentData segment()
+{
+	SegmentData sd;
+	sd.reserve(POINTS);
+
+	for (int i = 0; i < POINTS; i++)
+		sd.append(Trackpoint(Coordinates(14.0 + i * 0.0001 + 0.0005
+		  * sin(i * 0.01), 50.0 + i * 0.00005 + 0.0005 * cos(i * 0.013))));
+
+	return sd;
+}
+
+static QVector<qreal> randomValues()
+{
+	QRandomGenerator rnd(1);
+	QVector<qreal> v(POINTS);
+
+	for (int i = 0; i < v.size(); i++)
+		v[i] = rnd.generateDouble();
+
+	return v;
+}
+
+/* The Track/Route distance precomputation (Haversine) compared to the
+   per-pair Coordinates::distanceTo() calls it replaced, and the O(n) median
+   selection of the outlier elimination compared to the full sort. */
+class tst_Haversine : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+
+	void accuracy();
+	void distanceTo();
+	void haversine();
+	void medianSort();
+	void medianSelect();
+
+private:
+	SegmentData _sd;
+	QVector<qreal> _values;
+};
+
+void tst_Haversine::initTestCase()
+{
+	_sd = segment();
+	_values = randomValues();
+}
+
+void tst_Haversine::accuracy()
+{
+	QVector<double> ds(Haversine(_sd).distances());
+
+	QCOMPARE(ds.size(), _sd.size());
+	for (int i = 1; i < _sd.size(); i++)
+		QVERIFY(qAbs(ds.at(i) - _sd.at(i).coordinates().distanceTo(
+		  _sd.at(i-1).coordinates())) < 1e-6);
+}
+
+void tst_Haversine::distanceTo()
+{
+	QBENCHMARK {
+		QVector<double> ds(_sd.size());
+		ds[0] = 0;
+		for (int i = 1; i < _sd.size(); i++)
+			ds[i] = _sd.at(i).coordinates().distanceTo(
+			  _sd.at(i-1).coordinates());
+	}
+}
+
+/* Including the radians/cos(lat) arrays setup */
+void tst_Haversine::haversine()
+{
+	QBENCHMARK {
+		Haversine hs(_sd);
+		QVector<double> ds(hs.distances());
+	}
+}
+
+void tst_Haversine::medianSort()
+{
+	qreal m = 0;
+
+	QBENCHMARK {
+		QVector<qreal> v(_values);
+		std::sort(v.begin(), v.end());
+		m = v.at(v.size() / 2);
+	}
+
+	QVERIFY(m > 0);
+}
+
+void tst_Haversine::medianSelect()
+{
+	qreal m = 0;
+
+	QBENCHMARK {
+		QVector<qreal> v(_values);
+		QVector<qreal>::iterator it = v.begin() + v.size() / 2;
+		std::nth_element(v.begin(), it, v.end());
+		m = *it;
+	}
+
+	QVERIFY(m > 0);
+}
+
+QTEST_MAIN(tst_Haversine)
+#include "tst_haversine.moc"
@@ -0,0 +1,7 @@
+# The application code (without main()) as a static library the benchmarks
+# and tests link against.
+TEMPLATE = lib
+TARGET = gpxsee
+CONFIG += staticlib
+
+include(../../gpxsee.pri)
@@ -0,0 +1,5 @@
+TARGET = tst_pathitem
+
+include(../tests.pri)
+
+SOURCES += tst_pathitem.cpp
@@ -0,0 +1,187 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include <QPainterPathStroker>
+#include "data/track.h"
+#include "map/emptymap.h"
+#include "GUI/graphicsscene.h"
+#include "GUI/trackitem.h"
+
+#define TRACKS 1000
+#define POINTS 500  /* Per track, ~50m apart */
+#define HOVERS 1000
+#define WIDTH  3
+
+/* Random walk tracks spread over a ~50km area */
+static QList<Track> tracks()
+{
+	QRandomGenerator rnd(1);
+	QList<Track> list;
+
+	for (int i = 0; i < TRACKS; i++) {
+		double lon = 14.2 + rnd.generateDouble() * 0.6;
+		double lat = 49.9 + rnd.generateDouble() * 0.4;
+		double bearing = rnd.generateDouble() * 2 * M_PI;
+		SegmentData sd;
+
+		for (int j = 0; j < POINTS; j++) {
+			sd.append(Trackpoint(Coordinates(lon, lat)));
+			bearing += (rnd.generateDouble() - 0.5) * 0.5;
+			lon += 0.0007 * sin(bearing);
+			lat += 0.00045 * cos(bearing);
+		}
+
+		TrackData data;
+		data.append(sd);
+		list.append(Track(data));
+	}
+
+	return list;
+}
+
+/* The painter path the items used to stroke for the hit-testing shape */
+static QPainterPath painterPath(const Path &path, Map *map)
+{
+	QPainterPath pp;
+
+	for (int i = 0; i < path.size(); i++) {
+		const PathSegment &segment = path.at(i);
+		pp.moveTo(map->ll2xy(segment.first().coordinates()));
+		for (int j = 1; j < segment.size(); j++)
+			pp.lineTo(map->ll2xy(segment.at(j).coordinates()));
+	}
+
+	return pp;
+}
+
+static QPainterPath stroke(const QPainterPath &path)
+{
+	QPainterPathStroker s;
+	s.setWidth(WIDTH + 1);
+	return s.createStroke(path);
+}
+
+/* Hover hit-testing of the path items, the segment R-tree of the items
+   compared to the stroked shapes it replaced. Both the (re)projection cost,
+   paid on every map/zoom change, and the per mouse move cost are measured. */
+class tst_PathItem : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+
+	void strokeProject();
+	void strokeHover();
+	void indexProject();
+	void indexHover();
+	void results();
+
+private:
+	QList<Track> _tracks;
+	EmptyMap *_map;
+	GraphicsScene *_scene;
+	QList<TrackItem*> _items;
+	QList<QPainterPath> _shapes;
+	QVector<QPointF> _hovers;
+};
+
+void tst_PathItem::initTestCase()
+{
+	_tracks = tracks();
+	_map = new EmptyMap();
+	_map->zoomFit(QSize(1920, 1080), RectC(Coordinates(14.1, 50.4),
+	  Coordinates(14.9, 49.8)));
+
+	_scene = new GraphicsScene();
+	for (int i = 0; i < _tracks.size(); i++) {
+		TrackItem *item = new TrackItem(_tracks.at(i), _map);
+		item->setWidth(WIDTH);
+		_scene->addItem(item);
+		_items.append(item);
+		_shapes.append(stroke(painterPath(_tracks.at(i).path(), _map)));
+	}
+
+	QRandomGenerator rnd(2);
+	QRectF br(_scene->itemsBoundingRect());
+	for (int i = 0; i < HOVERS; i++)
+		_hovers.append(QPointF(br.left() + rnd.generateDouble() * br.width(),
+		  br.top() + rnd.generateDouble() * br.height()));
+}
+
+void tst_PathItem::cleanupTestCase()
+{
+	delete _scene;
+	delete _map;
+}
+
+void tst_PathItem::strokeProject()
+{
+	QBENCHMARK {
+		for (int i = 0; i < _tracks.size(); i++)
+			stroke(painterPath(_tracks.at(i).path(), _map));
+	}
+}
+
+/* The scene index bounding rect check followed by the shape check */
+void tst_PathItem::strokeHover()
+{
+	int hits = 0;
+
+	QBENCHMARK {
+		hits = 0;
+		for (int i = 0; i < _hovers.size(); i++)
+			for (int j = 0; j < _shapes.size(); j++)
+				if (_shapes.at(j).controlPointRect().contains(_hovers.at(i))
+				  && _shapes.at(j).contains(_hovers.at(i)))
+					hits++;
+	}
+
+	QVERIFY(hits > 0);
+}
+
+void tst_PathItem::indexProject()
+{
+	QBENCHMARK {
+		for (int i = 0; i < _items.size(); i++)
+			_items.at(i)->setMap(_map);
+	}
+}
+
+/* The same lookup the scene does on every mouse move */
+void tst_PathItem::indexHover()
+{
+	int hits = 0;
+
+	QBENCHMARK {
+		hits = 0;
+		for (int i = 0; i < _hovers.size(); i++)
+			hits += _scene->items(_hovers.at(i)).size();
+	}
+
+	QVERIFY(hits > 0);
+}
+
+/* The segment index tolerance is half the (width + 1) stroke, the results
+   may only differ for points on the stroke border */
+void tst_PathItem::results()
+{
+	int diff = 0, hits = 0;
+
+	for (int i = 0; i < _hovers.size(); i++) {
+		for (int j = 0; j < _items.size(); j++) {
+			bool index = _items.at(j)->contains(_hovers.at(i));
+			bool shape = _shapes.at(j).contains(_hovers.at(i));
+			if (index != shape)
+				diff++;
+			if (shape)
+				hits++;
+		}
+	}
+
+	QVERIFY(hits > 0);
+	QVERIFY(diff * 10 <= hits);
+}
+
+QTEST_MAIN(tst_PathItem)
+#include "tst_pathitem.moc"
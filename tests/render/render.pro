@@ -0,0 +1,5 @@
+TARGET = tst_render
+
+include(../tests.pri)
+
+SOURCES += tst_render.cpp
@@ -0,0 +1,136 @@
+#include <QtTest>
+#include <QPainter>
+#include <QPixmapCache>
+#include <QRandomGenerator>
+#include "map/textpointitem.h"
+#include "map/maplist.h"
+#include "map/map.h"
+#include "map/gcs.h"
+#include "map/pcs.h"
+
+#define LABELS    5000
+#define TILE_SIZE 1024
+
+/* Sample maps (IMG, Mapsforge, ENC, ...) are not part of the repository, the
+   map rendering benchmark renders all maps found in the GPXSEE_TEST_MAPS
+   directory and is skipped when the variable is not set. */
+#define MAPS_ENV "GPXSEE_TEST_MAPS"
+
+class tst_Render : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+
+	void textCollision();
+	void map_data();
+	void map();
+
+private:
+	QList<Map*> _maps;
+};
+
+void tst_Render::initTestCase()
+{
+	QString dir(qEnvironmentVariable(MAPS_ENV));
+	if (dir.isEmpty())
+		return;
+
+	TreeNode<Map*> node(MapList::loadMaps(dir, GCS::gcs(4326)));
+	QList<TreeNode<Map*> > stack;
+
+	stack.append(node);
+	while (!stack.isEmpty()) {
+		TreeNode<Map*> n(stack.takeFirst());
+		for (int i = 0; i < n.items().size(); i++) {
+			Map *map = n.items().at(i);
+			if (map->isValid() && map->isReady())
+				_maps.append(map);
+			else
+				delete map;
+		}
+		stack.append(n.childs());
+	}
+}
+
+void tst_Render::cleanupTestCase()
+{
+	qDeleteAll(_maps);
+}
+
+/* The greedy label placement the vector map tiles do when rendering */
+void tst_Render::textCollision()
+{
+	QRandomGenerator rnd(1);
+	QFont font;
+	font.setPixelSize(12);
+	QColor color(Qt::black);
+	QVector<QString> names(LABELS);
+	QVector<QPoint> points(LABELS);
+
+	for (int i = 0; i < LABELS; i++) {
+		names[i] = QString("Label %1").arg(i);
+		points[i] = QPoint(rnd.bounded(TILE_SIZE), rnd.bounded(TILE_SIZE));
+	}
+
+	QBENCHMARK {
+		QList<TextItem*> placed;
+
+		for (int i = 0; i < LABELS; i++) {
+			TextPointItem *item = new TextPointItem(points.at(i), &names.at(i),
+			  &font, 0, &color, 0);
+			if (item->isValid() && !item->collides(placed))
+				placed.append(item);
+			else
+				delete item;
+		}
+
+		QVERIFY(!placed.isEmpty());
+		qDeleteAll(placed);
+	}
+}
+
+void tst_Render::map_data()
+{
+	QTest::addColumn<int>("index");
+
+	for (int i = 0; i < _maps.size(); i++)
+		QTest::newRow(qPrintable(_maps.at(i)->name())) << i;
+}
+
+/* A full (uncached) render of the map center area, the tiles are rendered in
+   parallel the same way as when printing/exporting */
+void tst_Render::map()
+{
+	if (_maps.isEmpty())
+		QSKIP(MAPS_ENV " not set or no usable maps found");
+
+	QFETCH(int, index);
+	Map *map = _maps.at(index);
+
+	map->load(GCS::gcs(4326), PCS::pcs(3857), 1.0, false);
+	map->zoomFit(QSize(TILE_SIZE, TILE_SIZE), map->llBounds());
+	map->zoomIn();
+
+	QPointF center(map->ll2xy(map->llBounds().center()));
+	QRectF rect(center - QPointF(TILE_SIZE/2, TILE_SIZE/2),
+	  QSizeF(TILE_SIZE, TILE_SIZE));
+	QImage img(TILE_SIZE, TILE_SIZE, QImage::Format_ARGB32_Premultiplied);
+
+	QBENCHMARK {
+		map->clearCache();
+		QPixmapCache::clear();
+
+		img.fill(Qt::white);
+		QPainter painter(&img);
+		painter.translate(-rect.topLeft());
+		map->draw(&painter, rect, Map::Block | Map::Rasters | Map::Vectors);
+	}
+
+	map->unload();
+}
+
+QTEST_MAIN(tst_Render)
+#include "tst_render.moc"
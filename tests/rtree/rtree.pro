@@ -0,0 +1,5 @@
+TARGET = tst_rtree
+
+include(../tests.pri)
+
+SOURCES += tst_rtree.cpp
@@ -0,0 +1,231 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include "common/rtree.h"
+#include "common/packedrtree.h"
+#ifdef __GLIBC__
+#if __GLIBC_PREREQ(2, 33)
+#include <malloc.h>
+#define HEAP_STATS
+#endif // glibc >= 2.33
+#endif // __GLIBC__
+
+#define ENTRIES 200000
+#define QUERIES 10000
+#define EXTENT  1000.0
+
+typedef RTree<int, double, 2> GuttmanTree;
+typedef PackedRTree<int, double> PackedTree;
+typedef PackedRTree<int, double, float> PackedFloatTree;
+
+enum Type {Guttman, Packed, PackedFloat};
+Q_DECLARE_METATYPE(Type)
+
+struct Rect
+{
+	double min[2];
+	double max[2];
+};
+
+static QVector<Rect> rects(int count, double size, quint32 seed)
+{
+	QRandomGenerator rnd(seed);
+	QVector<Rect> v(count);
+
+	for (int i = 0; i < count; i++) {
+		Rect &r = v[i];
+		for (int j = 0; j < 2; j++) {
+			r.min[j] = rnd.generateDouble() * EXTENT;
+			r.max[j] = r.min[j] + rnd.generateDouble() * size;
+		}
+	}
+
+	return v;
+}
+
+static qint64 heapSize()
+{
+#ifdef HEAP_STATS
+	struct mallinfo2 mi = mallinfo2();
+	return mi.uordblks + mi.hblkhd;
+#else
+	return -1;
+#endif
+}
+
+static void pack(GuttmanTree &) {}
+template<class T> static void pack(T &tree) {tree.Pack();}
+
+template<class T> static T *buildTree(const QVector<Rect> &data)
+{
+	T *tree = new T();
+
+	for (int i = 0; i < data.size(); i++)
+		tree->Insert(data.at(i).min, data.at(i).max, i);
+	pack(*tree);
+
+	return tree;
+}
+
+static bool countCb(int data, void *context)
+{
+	Q_UNUSED(data);
+	(*(int*)context)++;
+	return true;
+}
+
+struct Counter
+{
+	Counter(int *count) : count(count) {}
+	bool operator()(int) const {(*count)++; return true;}
+
+	int *count;
+};
+
+static int search(const GuttmanTree *tree, const QVector<Rect> &queries)
+{
+	int count = 0;
+	for (int i = 0; i < queries.size(); i++)
+		tree->Search(queries.at(i).min, queries.at(i).max, countCb, &count);
+	return count;
+}
+
+template<class T> static int search(const T *tree, const QVector<Rect> &queries)
+{
+	int count = 0;
+	for (int i = 0; i < queries.size(); i++)
+		tree->Search(queries.at(i).min, queries.at(i).max, Counter(&count));
+	return count;
+}
+
+/* The Guttman RTree compared to the bulk loaded PackedRTree (with double and
+   float bounds) used for the static map indexes. The data mimics map objects,
+   many small rectangles spread over the map area. */
+class tst_RTree : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+
+	void types_data();
+	void build_data() {types_data();}
+	void build();
+	void memory_data() {types_data();}
+	void memory();
+	void query_data() {types_data();}
+	void query();
+	void results();
+
+private:
+	QVector<Rect> _data;
+	QVector<Rect> _queries;
+};
+
+void tst_RTree::initTestCase()
+{
+	_data = rects(ENTRIES, EXTENT / 500, 1);
+	_queries = rects(QUERIES, EXTENT / 20, 2);
+}
+
+void tst_RTree::types_data()
+{
+	QTest::addColumn<Type>("type");
+
+	QTest::newRow("RTree") << Guttman;
+	QTest::newRow("PackedRTree") << Packed;
+	QTest::newRow("PackedRTree<float>") << PackedFloat;
+}
+
+void tst_RTree::build()
+{
+	QFETCH(Type, type);
+
+	switch (type) {
+		case Guttman:
+			QBENCHMARK {delete buildTree<GuttmanTree>(_data);}
+			break;
+		case Packed:
+			QBENCHMARK {delete buildTree<PackedTree>(_data);}
+			break;
+		case PackedFloat:
+			QBENCHMARK {delete buildTree<PackedFloatTree>(_data);}
+			break;
+	}
+}
+
+/* Heap usage of the built tree, glibc only */
+void tst_RTree::memory()
+{
+	QFETCH(Type, type);
+
+	if (heapSize() < 0)
+		QSKIP("heap usage statistics not available");
+
+	qint64 before = heapSize();
+	qint64 after = before;
+
+	switch (type) {
+		case Guttman:
+			{GuttmanTree *tree = buildTree<GuttmanTree>(_data);
+			after = heapSize();
+			delete tree;}
+			break;
+		case Packed:
+			{PackedTree *tree = buildTree<PackedTree>(_data);
+			after = heapSize();
+			delete tree;}
+			break;
+		case PackedFloat:
+			{PackedFloatTree *tree = buildTree<PackedFloatTree>(_data);
+			after = heapSize();
+			delete tree;}
+			break;
+	}
+
+	QTest::setBenchmarkResult(after - before, QTest::BytesAllocated);
+}
+
+void tst_RTree::query()
+{
+	QFETCH(Type, type);
+	int count = 0;
+
+	switch (type) {
+		case Guttman:
+			{GuttmanTree *tree = buildTree<GuttmanTree>(_data);
+			QBENCHMARK {count = search(tree, _queries);}
+			delete tree;}
+			break;
+		case Packed:
+			{PackedTree *tree = buildTree<PackedTree>(_data);
+			QBENCHMARK {count = search(tree, _queries);}
+			delete tree;}
+			break;
+		case PackedFloat:
+			{PackedFloatTree *tree = buildTree<PackedFloatTree>(_data);
+			QBENCHMARK {count = search(tree, _queries);}
+			delete tree;}
+			break;
+	}
+
+	QVERIFY(count > 0);
+}
+
+/* The packed trees must find exactly the same entries (float bounds are
+   rounded outwards, so they may only find more, never less) */
+void tst_RTree::results()
+{
+	QScopedPointer<GuttmanTree> guttman(buildTree<GuttmanTree>(_data));
+	QScopedPointer<PackedTree> packed(buildTree<PackedTree>(_data));
+	QScopedPointer<PackedFloatTree> packedFloat(buildTree<PackedFloatTree>(_data));
+
+	for (int i = 0; i < 100; i++) {
+		QVector<Rect> q(_queries.mid(i, 1));
+		int g = search(guttman.data(), q);
+		QCOMPARE(search(packed.data(), q), g);
+		QVERIFY(search(packedFloat.data(), q) >= g);
+	}
+}
+
+QTEST_MAIN(tst_RTree)
+#include "tst_rtree.moc"
@@ -0,0 +1,19 @@
+# Common settings of the benchmark/test executables
+
+include(../gpxsee.pri)
+# The application code is linked from the lib subproject
+HEADERS =
+SOURCES =
+
+QT += testlib
+CONFIG += testcase console
+CONFIG -= app_bundle
+
+GPXSEE_LIB = $$OUT_PWD/../lib
+win32 {
+    CONFIG(debug, debug|release): GPXSEE_LIB = $$GPXSEE_LIB/debug
+    else: GPXSEE_LIB = $$GPXSEE_LIB/release
+}
+LIBS += -L$$GPXSEE_LIB -lgpxsee
+win32-msvc*: PRE_TARGETDEPS += $$GPXSEE_LIB/gpxsee.lib
+else: PRE_TARGETDEPS += $$GPXSEE_LIB/libgpxsee.a
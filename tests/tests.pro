@@ -0,0 +1,23 @@
+# Benchmarks and tests. Every subproject is a QtTest executable, "make check"
+# builds and runs all of them (see README.md for the machine-readable output).
+TEMPLATE = subdirs
+SUBDIRS = lib \
+    data \
+    dem \
+    render \
+    haversine \
+    rtree \
+    geojson \
+    downloader \
+    corridor \
+    pathitem
+
+data.depends = lib
+dem.depends = lib
+render.depends = lib
+haversine.depends = lib
+rtree.depends = lib
+geojson.depends = lib
+downloader.depends = lib
+corridor.depends = lib
+pathitem.depends = lib